@@ -0,0 +1,111 @@
+#pragma once
+#include "BlazeEngine/Application/ECS/ComponentTypeRegistry.h"
+#include "BlazeEngine/Application/ECS/EntityHandle.h"
+
+namespace Blaze::ECS
+{
+	class Scene;
+
+	/*
+		Records structural changes (entity creation and destruction, adding and removing components) so they can be
+		applied later by Scene::ApplyCommandBuffers. Recording doesn't touch the scene, so each thread can record into
+		its own buffer while systems are running without any locking.
+
+		Create returns a provisional handle that stands for the entity until the buffer is applied. It can be passed to
+		the other commands of the same buffer, which then act on the created entity. Provisional handles mean nothing
+		to the scene or to other buffers and are invalidated by Clear. Each recording gets its own stamp in the
+		provisional handles, applying a command with a provisional handle of another buffer or of an earlier recording
+		fails instead of acting on the wrong entity.
+	*/
+	class BLAZE_API CommandBuffer
+	{
+	public:
+		CommandBuffer();
+		CommandBuffer(const ComponentTypeRegistry* registry);
+
+		EntityHandle Create(ArrayView<const ComponentTypeData*> typesData);
+		template<typename ... C> requires (IsComponent<C> && ...)
+		EntityHandle Create();
+		void Destroy(EntityHandle handle);
+		void AddComponent(EntityHandle handle, const ComponentTypeData& typeData);
+		template<typename C> requires IsComponent<C>
+		void AddComponent(EntityHandle handle);
+		void RemoveComponent(EntityHandle handle, const ComponentTypeData& typeData);
+		template<typename C> requires IsComponent<C>
+		void RemoveComponent(EntityHandle handle);
+
+		void Clear();
+		inline bool Empty() const { return commands.Empty(); }
+		inline uintMem GetCommandCount() const { return commands.Count(); }
+		inline uint32 GetCreateCount() const { return createCount; }
+
+		friend class Scene;
+	private:
+		enum class CommandType : uint8
+		{
+			Create,
+			Destroy,
+			AddComponent,
+			RemoveComponent
+		};
+		struct Command
+		{
+			CommandType type;
+			EntityHandle handle;
+			//For Create commands this is a range in 'typesData', otherwise 'typesDataCount' is 1
+			uint32 typesDataOffset;
+			uint32 typesDataCount;
+		};
+
+		const ComponentTypeRegistry* registry;
+		uint32 createCount;
+		//Generation of the provisional handles of this recording, changed by Clear
+		uint32 provisionalGeneration;
+		Array<Command> commands;
+		Array<const ComponentTypeData*> typesData;
+
+		void AddCommand(CommandType type, EntityHandle handle, ArrayView<const ComponentTypeData*> typesData);
+		template<typename C> requires IsComponent<C>
+		const ComponentTypeData* GetTypeData() const;
+	};
+
+	template<typename ... C> requires (IsComponent<C> && ...)
+	inline EntityHandle CommandBuffer::Create()
+	{
+		const ComponentTypeData* typesData[sizeof...(C)]{ GetTypeData<C>()... };
+
+		for (auto typeData : typesData)
+			if (typeData == nullptr)
+				return EntityHandle();
+
+		return Create(typesData);
+	}
+
+	template<typename C> requires IsComponent<C>
+	inline void CommandBuffer::AddComponent(EntityHandle handle)
+	{
+		if (auto typeData = GetTypeData<C>())
+			AddComponent(handle, *typeData);
+	}
+
+	template<typename C> requires IsComponent<C>
+	inline void CommandBuffer::RemoveComponent(EntityHandle handle)
+	{
+		if (auto typeData = GetTypeData<C>())
+			RemoveComponent(handle, *typeData);
+	}
+
+	template<typename C> requires IsComponent<C>
+	inline const ComponentTypeData* CommandBuffer::GetTypeData() const
+	{
+		const ComponentTypeData* typeData = nullptr;
+
+		if (registry == nullptr || !registry->GetComponentTypeData<C>(typeData))
+		{
+			Debug::Logger::LogError("Blaze Engine", "Registry doesnt contain the component type");
+			return nullptr;
+		}
+
+		return typeData;
+	}
+}
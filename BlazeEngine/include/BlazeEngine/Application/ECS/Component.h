@@ -62,10 +62,16 @@ namespace Blaze::ECS
 
 #define COMPONENT_ADD_TYPE_TAGS(...) using TypeTags = TypeTags::Concat<__VA_ARGS__>;
 
+#define COMPONENT_RAW_SERIALIZABLE() static constexpr bool rawSerializable = true;
+
 	class BLAZE_API Component
 	{				
 		Entity* entity;
 		System* system;
+		uint32 changedVersion;
+		uint32 addedVersion;
+
+		void Attach(Entity* entity, System* system, const ComponentTypeData& typeData, uint32 version);
 	public:
 		Component();	
 		Component(const Component&) = delete;
@@ -74,6 +80,14 @@ namespace Blaze::ECS
 		inline System* GetSystem() const { return system; }
 		inline Entity* GetEntity() const { return entity; }		
 
+		/*
+			Stamps the component with the current change version of its scene. Should be called after modifying the
+			component so that Changed<T> queries pick it up.
+		*/
+		void MarkChanged();
+		inline uint32 GetChangedVersion() const { return changedVersion; }
+		inline uint32 GetAddedVersion() const { return addedVersion; }
+
 		template<typename T>
 		inline T* Cast()
 		{
@@ -117,6 +131,9 @@ namespace Blaze::ECS
 		struct BucketHeader
 		{		
 			FlagType flags;
+			//Biggest change and add version of all the elements in the bucket
+			uint32 changedVersion;
+			uint32 addedVersion;
 		
 			uintMem MarkNew();
 			void Unmark(uintMem index);
@@ -139,6 +156,7 @@ namespace Blaze::ECS
 		void GetComponentLocation(Component*, BucketHeader*&, uintMem&);
 		Component* GetComponentFromLocation(BucketHeader*, uintMem index, ElementHeader*& element);
 
+		Component* GetComponentInBucket(BucketHeader* bucket, uintMem index) const;
 		void* FirstInBucket(BucketHeader* bucket) const;
 		void* LastInBucket(BucketHeader* bucket) const;
 
@@ -150,6 +168,13 @@ namespace Blaze::ECS
 
 		void RemoveBucket(BucketHeader* bucket);
 		void AddBucket(BucketHeader* bucket);
+
+		//Makes sure there are at least 'count' free elements, all new buckets are added in one go
+		void ReserveBuckets(uintMem count);
+		//Frees empty buckets and moves non-full buckets in front of the full ones
+		void CompactBuckets();
+
+		static void StampBucket(Component* component, const ComponentTypeData& typeData, uint32 version, bool added);
 	public:
 		ComponentContainer();
 		~ComponentContainer();
@@ -161,8 +186,31 @@ namespace Blaze::ECS
 		void Destroy(Component*);
 		void Free(Component*);
 
+		/*
+			Allocates 'count' components and writes their pointers to 'components'. The needed buckets are
+			allocated up front. The components aren't constructed.
+		*/
+		void AllocateMany(Component** components, uintMem count);
+		/*
+			Destroys 'count' components. Empty buckets are freed once after all components are destroyed.
+		*/
+		void DestroyMany(Component** components, uintMem count);
+		void FreeMany(Component** components, uintMem count);
+
 		uintMem Count() const { return elementCount; }
 
+		/*
+			Calls 'function' with every component that was changed after 'version'. Buckets in which nothing changed
+			after 'version' are skipped without looking at their elements.
+		*/
+		template<typename F> requires std::invocable<F, Component*>
+		void ForEachChanged(uint32 version, const F& function) const;
+		/*
+			Calls 'function' with every component that was created after 'version'
+		*/
+		template<typename F> requires std::invocable<F, Component*>
+		void ForEachAdded(uint32 version, const F& function) const;
+
 		void Clear();
 
 		class BLAZE_API Iterator
@@ -196,5 +244,54 @@ namespace Blaze::ECS
 		Iterator end() const;
 
 		friend class Iterator;
+		friend class Component;
 	};	
+
+	template<typename F> requires std::invocable<F, Component*>
+	inline void ComponentContainer::ForEachChanged(uint32 version, const F& function) const
+	{
+		for (uintMem i = 0; i < bucketCount; ++i)
+		{
+			BucketHeader* bucket = buckets[i];
+
+			if (bucket->changedVersion <= version)
+				continue;
+
+			FlagType flags = bucket->flags;
+			while (flags != 0)
+			{
+				uintMem index = std::countr_zero(flags);
+				flags &= flags - 1;
+
+				Component* component = GetComponentInBucket(bucket, index);
+
+				if (component->changedVersion > version)
+					function(component);
+			}
+		}
+	}
+
+	template<typename F> requires std::invocable<F, Component*>
+	inline void ComponentContainer::ForEachAdded(uint32 version, const F& function) const
+	{
+		for (uintMem i = 0; i < bucketCount; ++i)
+		{
+			BucketHeader* bucket = buckets[i];
+
+			if (bucket->addedVersion <= version)
+				continue;
+
+			FlagType flags = bucket->flags;
+			while (flags != 0)
+			{
+				uintMem index = std::countr_zero(flags);
+				flags &= flags - 1;
+
+				Component* component = GetComponentInBucket(bucket, index);
+
+				if (component->addedVersion > version)
+					function(component);
+			}
+		}
+	}
 }
\ No newline at end of file
@@ -23,6 +23,24 @@ namespace Blaze::ECS
 		IsSystem<typename T::System>;		
 		typename T::TypeTags;
 	};
+
+	/*
+		Components with a const 'Serialize(WriteStream&)' and a 'Deserialize(ReadStream&)' member function are
+		serialized with them when a scene is serialized
+	*/
+	template<typename T>
+	concept HasComponentSerializeFunctions = requires(const T& a, T& b, WriteStream& writeStream, ReadStream& readStream) {
+		a.Serialize(writeStream);
+		b.Deserialize(readStream);
+	};
+	/*
+		Components that are marked with COMPONENT_RAW_SERIALIZABLE are serialized by copying their memory. They must not
+		contain pointers or have virtual functions and must be trivially destructible.
+	*/
+	template<typename T>
+	concept IsRawSerializableComponent = requires {
+		{ T::rawSerializable } -> std::convertible_to<bool>;
+	} && T::rawSerializable;
 	
 	class BLAZE_API ComponentTypeData
 	{		
@@ -31,10 +49,13 @@ namespace Blaze::ECS
 		using Destructor = void(*)(void*);
 		using SystemConstructor = void(*)(void*);
 		using SystemDestructor = void(*)(void*);		
+		using Serializer = Result(*)(const void*, WriteStream&);
+		using Deserializer = Result(*)(void*, ReadStream&);
 
 		ComponentTypeData(ComponentTypeRegistry* registry, StringView name, uint index,
 			uintMem size, ptrdiff_t baseOffset, Constructor constructor, Destructor destructor,
 			uintMem systemSize, ptrdiff_t systemBaseOffset, SystemConstructor systemConstructor, SystemConstructor systemDestructor,
+			bool rawSerializable, Serializer serializer, Deserializer deserializer,
 			Set<StringView> typeTags);
 		ComponentTypeData(const ComponentTypeData&) = delete;
 
@@ -58,6 +79,11 @@ namespace Blaze::ECS
 		inline void DestructSystem(System* ptr) const { systemDestructor((uint8*)ptr - systemBaseOffset); }
 		inline void DestructSystemDirect(void* ptr) const { systemDestructor(ptr); }
 
+		inline bool IsRawSerializable() const { return rawSerializable; }
+		inline bool HasSerializeFunctions() const { return serializer != nullptr; }
+		inline Result Serialize(const Component* ptr, WriteStream& stream) const { return serializer((const uint8*)ptr - baseOffset, stream); }
+		inline Result Deserialize(Component* ptr, ReadStream& stream) const { return deserializer((uint8*)ptr - baseOffset, stream); }
+
 		inline bool IsNone() const { return typeName.Empty(); }
 
 		inline const Set<StringView>& GetTypeTags() const { return typeTags; }
@@ -84,6 +110,10 @@ namespace Blaze::ECS
 		SystemConstructor systemConstructor;
 		SystemDestructor systemDestructor;
 
+		bool rawSerializable;
+		Serializer serializer;
+		Deserializer deserializer;
+
 		friend class ComponentTypeRegistry;
 	};
 
@@ -119,12 +149,15 @@ namespace Blaze::ECS
 		template<typename T> static void Destruct(void* ptr);
 		template<typename T> static void ConstructSystem(void* ptr);
 		template<typename T> static void DestructSystem(void* ptr);
+		template<typename T> static Result Serialize(const void* ptr, WriteStream& stream);
+		template<typename T> static Result Deserialize(void* ptr, ReadStream& stream);
 
 		void ReserveTypeCount(uint count);
 
 		Result AddType(StringView name,
 			uintMem size, ptrdiff_t baseOffset, ComponentTypeData::Constructor constructor, ComponentTypeData::Destructor destructor,
 			uintMem systemSize, ptrdiff_t systemBaseOffset, ComponentTypeData::SystemConstructor systemConstructor, ComponentTypeData::SystemDestructor systemDestructor,
+			bool rawSerializable, ComponentTypeData::Serializer serializer, ComponentTypeData::Deserializer deserializer,
 			Array<StringView> customData);
 
 		template<typename T> requires IsComponent<T>
@@ -158,9 +191,24 @@ namespace Blaze::ECS
 	Result ComponentTypeRegistry::AddType()
 	{
 		using System = typename T::System;
+
+		ComponentTypeData::Serializer serializer = nullptr;
+		ComponentTypeData::Deserializer deserializer = nullptr;
+
+		if constexpr (HasComponentSerializeFunctions<T>)
+		{
+			serializer = Serialize<T>;
+			deserializer = Deserialize<T>;
+		}
+
+		//Component deletes its copy operations so T is never trivially copyable, these are the checks that still apply
+		if constexpr (IsRawSerializableComponent<T>)
+			static_assert(std::is_trivially_destructible_v<T> && !std::is_polymorphic_v<T>, "Components marked with COMPONENT_RAW_SERIALIZABLE must be trivially destructible and have no virtual functions");
+
 		return AddType(T::typeName,
 			sizeof(T), BaseOffset<Component, T>(), Construct<T>, Destruct<T>,
 			sizeof(System), BaseOffset<ECS::System, System>(), ConstructSystem<System>, DestructSystem<System>,
+			IsRawSerializableComponent<T>, serializer, deserializer,
 			GetTypeTags<T>());
 	}
 
@@ -210,4 +258,26 @@ namespace Blaze::ECS
 		ptrdiff_t offset = BaseOffset<System, T>();
 		((T*)ptr)->~T();
 	}
+	template<typename T>
+	Result ComponentTypeRegistry::Serialize(const void* ptr, WriteStream& stream)
+	{
+		if constexpr (std::same_as<decltype(((const T*)ptr)->Serialize(stream)), Result>)
+			return ((const T*)ptr)->Serialize(stream);
+		else
+		{
+			((const T*)ptr)->Serialize(stream);
+			return Result();
+		}
+	}
+	template<typename T>
+	Result ComponentTypeRegistry::Deserialize(void* ptr, ReadStream& stream)
+	{
+		if constexpr (std::same_as<decltype(((T*)ptr)->Deserialize(stream)), Result>)
+			return ((T*)ptr)->Deserialize(stream);
+		else
+		{
+			((T*)ptr)->Deserialize(stream);
+			return Result();
+		}
+	}
 }
\ No newline at end of file
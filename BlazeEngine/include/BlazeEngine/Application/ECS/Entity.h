@@ -1,6 +1,7 @@
 #pragma once
 #include "Component.h"
 #include "ComponentTypeRegistry.h"
+#include "EntityHandle.h"
 
 namespace Blaze::ECS
 {
@@ -16,34 +17,69 @@ namespace Blaze::ECS
 		bool HasComponent() const;
 		bool HasComponent(const ComponentTypeData&) const;		
 
+		/*
+			Returns the component for reading, use ModifyComponent to change it so Changed<T> queries pick it up
+		*/
 		template<typename C> requires IsComponent<C>
-		C* GetComponent() const;
+		const C* GetComponent() const;
 		Component* GetComponent(const ComponentTypeData&) const;		
+		/*
+			Returns the component and marks it as changed, see Component::MarkChanged
+		*/
+		template<typename C> requires IsComponent<C>
+		C* ModifyComponent() const;
 		Component* GetComponent(uintMem index) const;
 		const ComponentTypeData* GetComponentTypeData(uintMem index);
 				
 		uintMem GetComponentCount() const { return componentCount; }
 
 		Scene* GetScene() const { return scene; }
+		EntityHandle GetHandle() const { return handle; }
 
 		friend class Scene;		
 	private:				
 		Scene* scene;				
+		EntityHandle handle;
 		uintMem componentCount;
 		uintMem arrayIndex;
 
 		const ComponentTypeRegistry* GetRegistry() const;
+
+		template<typename C> requires IsComponent<C>
+		C* FindComponent() const;
 	};
 
 	template<typename C> requires IsComponent<C>
 	bool Entity::HasComponent() const
 	{
 		auto registry = GetRegistry();		
-		return HasComponent(registry->GetComponentTypeData<C>());
+		const ComponentTypeData* typeData;
+
+		if (registry->GetComponentTypeData<C>(typeData))
+			return HasComponent(*typeData);
+
+		return false;
+	}
+
+	template<typename C> requires IsComponent<C>
+	const C* Entity::GetComponent() const
+	{
+		return FindComponent<C>();
+	}
+
+	template<typename C> requires IsComponent<C>
+	C* Entity::ModifyComponent() const
+	{
+		C* component = FindComponent<C>();
+
+		if (component != nullptr)
+			component->MarkChanged();
+
+		return component;
 	}
 
 	template<typename C> requires IsComponent<C>
-	C* Entity::GetComponent() const
+	C* Entity::FindComponent() const
 	{
 		auto registry = GetRegistry();		
 		const ComponentTypeData* typeData;
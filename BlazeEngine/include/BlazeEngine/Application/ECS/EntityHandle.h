@@ -0,0 +1,27 @@
+#pragma once
+
+namespace Blaze::ECS
+{
+	/*
+		Identifies a entity inside a scene. 'index' is the slot of the entity in the scene entity storage and 'generation'
+		is increased every time that slot is freed, so a handle to a destroyed entity can be detected in O(1) even if the
+		slot was reused.
+	*/
+	struct EntityHandle
+	{
+		static constexpr uint32 NullIndex = std::numeric_limits<uint32>::max();
+		//Set in the generation of handles returned by CommandBuffer::Create, the other bits of the generation identify
+		//the recording of the buffer and 'index' is the creation's number in it. Scene generations never have it set
+		static constexpr uint32 ProvisionalBit = 1u << 31;
+
+		uint32 index = NullIndex;
+		uint32 generation = 0;
+
+		inline bool IsNull() const { return index == NullIndex; }
+		inline bool IsProvisional() const { return !IsNull() && (generation & ProvisionalBit) != 0; }
+		inline uint64 Value() const { return ((uint64)generation << 32) | (uint64)index; }
+
+		inline bool operator==(const EntityHandle& other) const { return index == other.index && generation == other.generation; }
+		inline bool operator!=(const EntityHandle& other) const { return index != other.index || generation != other.generation; }
+	};
+}
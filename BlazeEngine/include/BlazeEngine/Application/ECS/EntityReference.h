@@ -6,7 +6,8 @@ namespace Blaze::ECS
 	template<typename ... Cs> requires (IsComponent<Cs> && ...)
 	class EntityReference
 	{
-		Entity* entity;
+		Scene* scene;
+		EntityHandle handle;
 	public:
 		EntityReference();
 		EntityReference(Scene& scene);
@@ -16,10 +17,21 @@ namespace Blaze::ECS
 		void CreateNew(Scene& scene);
 		void SetNew(Entity* entity);
 
+		/*
+			Same as Entity::GetComponent and Entity::ModifyComponent, return nullptr if the referenced entity was
+			destroyed
+		*/
 		template<typename C> requires IsAnyOf<C, Cs...>
-		C* GetComponent();
+		const C* GetComponent();
+		template<typename C> requires IsAnyOf<C, Cs...>
+		C* ModifyComponent();
 
-		inline Entity* GetEntity() const { return entity; }
+		/*
+			Returns nullptr if the referenced entity was destroyed
+		*/
+		inline Entity* GetEntity() const { return scene == nullptr ? nullptr : scene->GetEntity(handle); }
+		inline EntityHandle GetHandle() const { return handle; }
+		inline bool IsValid() const { return scene != nullptr && scene->IsValid(handle); }
 
 
 		//EntityReference& operator=(const EntityReference&) = default;
@@ -27,38 +39,65 @@ namespace Blaze::ECS
 
 	template<typename ...Cs> requires (IsComponent<Cs> && ...)
 	inline EntityReference<Cs...>::EntityReference()
-		: entity(nullptr)
+		: scene(nullptr)
 	{
 	}
 
 	template<typename ...Cs> requires (IsComponent<Cs> && ...)
 	inline EntityReference<Cs...>::EntityReference(Scene& scene) 
-		: entity(scene.Create<Cs...>().GetEntity())
+		: scene(&scene), handle(scene.Create<Cs...>().GetEntity()->GetHandle())
 	{
 	}
 
 	template<typename ...Cs> requires (IsComponent<Cs> && ...)
 	inline EntityReference<Cs...>::EntityReference(Entity* entity)
+		: scene(nullptr)
 	{
-		this->entity = entity;
+		SetNew(entity);
 	}
 
 	template<typename ...Cs> requires (IsComponent<Cs> && ...)
 	inline void EntityReference<Cs...>::CreateNew(ECS::Scene& scene)
 	{
-		entity = scene.Create<Cs...>().GetEntity();
+		this->scene = &scene;
+		handle = scene.Create<Cs...>().GetEntity()->GetHandle();
 	}
 
 	template<typename ...Cs> requires (IsComponent<Cs> && ...)
 	inline void EntityReference<Cs...>::SetNew(Entity* entity)
 	{
-		this->entity = entity;
+		if (entity == nullptr)
+		{
+			scene = nullptr;
+			handle = EntityHandle();
+			return;
+		}
+
+		scene = entity->GetScene();
+		handle = entity->GetHandle();
 	}
 
 	template<typename ...Cs> requires (IsComponent<Cs> && ...)
 	template<typename C>  requires IsAnyOf<C, Cs...>
-	inline C* EntityReference<Cs...>::GetComponent()
+	inline const C* EntityReference<Cs...>::GetComponent()
 	{
+		Entity* entity = GetEntity();
+
+		if (entity == nullptr)
+			return nullptr;
+
 		return entity->GetComponent<C>();
 	}
+
+	template<typename ...Cs> requires (IsComponent<Cs> && ...)
+	template<typename C>  requires IsAnyOf<C, Cs...>
+	inline C* EntityReference<Cs...>::ModifyComponent()
+	{
+		Entity* entity = GetEntity();
+
+		if (entity == nullptr)
+			return nullptr;
+
+		return entity->ModifyComponent<C>();
+	}
 }
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+#include "BlazeEngine/Application/ECS/ComponentTypeRegistry.h"
+
+namespace Blaze::ECS
+{
+	/*
+		Selects components of type C that were changed (or created) after a given scene change version
+	*/
+	template<typename C> requires IsComponent<C>
+	struct Changed
+	{
+		using ComponentType = C;
+		static constexpr bool onlyAdded = false;
+	};
+
+	/*
+		Selects components of type C that were created after a given scene change version
+	*/
+	template<typename C> requires IsComponent<C>
+	struct Added
+	{
+		using ComponentType = C;
+		static constexpr bool onlyAdded = true;
+	};
+
+	template<typename T>
+	concept IsChangeFilter = IsComponent<typename T::ComponentType> && requires {
+		{ T::onlyAdded } -> std::convertible_to<bool>;
+	};
+}
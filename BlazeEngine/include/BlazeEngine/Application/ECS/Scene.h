@@ -1,6 +1,8 @@
 #pragma once
 #include "BlazeEngine/Application/ECS/ComponentTypeRegistry.h"
 #include "BlazeEngine/Application/ECS/EntityView.h"
+#include "BlazeEngine/Application/ECS/CommandBuffer.h"
+#include "BlazeEngine/Application/ECS/QueryFilters.h"
 
 namespace Blaze::ECS
 {	
@@ -10,6 +12,10 @@ namespace Blaze::ECS
 		Scene();
 		~Scene();
 
+		/*
+			Fails if the scene has any entities. Systems of the previous registry are destroyed and the slots of
+			destroyed entities are released
+		*/
 		Result SetRegistry(ComponentTypeRegistry registry);
 
 		void Clear();		
@@ -18,7 +24,56 @@ namespace Blaze::ECS
 		template<typename ... C> requires (IsComponent<C> && ...)
 		EntityView<C...> Create();		
 
+		/*
+			Creates 'count' entities with the same components. Component storage is reserved up front, components are
+			constructed one type at a time and System::Created is called in one batch per type.
+		*/
+		Array<Entity*> CreateMany(uintMem count, ArrayView<const ComponentTypeData*> typesData);
+
 		Result Destroy(Entity* entity);
+		Result Destroy(EntityHandle handle);
+		/*
+			Destroys all given entities. System::Destroyed is called in one batch per type and the entity array is
+			compacted once at the end. Null entities and duplicates are ignored.
+		*/
+		Result DestroyMany(ArrayView<Entity*> entities);
+
+		Result AddComponent(Entity* entity, const ComponentTypeData& typeData);
+		Result RemoveComponent(Entity* entity, const ComponentTypeData& typeData);
+
+		/*
+			Sets the number of command buffers. Systems that run on multiple threads should record structural changes
+			into the buffer with their own thread index instead of changing the scene directly. Must not be called while
+			the buffers are being recorded into.
+		*/
+		void SetCommandBufferCount(uintMem count);
+		inline uintMem GetCommandBufferCount() const { return commandBuffers.Count(); }
+		CommandBuffer& GetCommandBuffer(uintMem index);
+		/*
+			Applies all recorded commands and clears the buffers. Buffers are applied in index order and commands in the
+			order they were recorded in, so the result doesn't depend on thread timing. Consecutive creations with the
+			same component types and consecutive destructions are applied as one batch. Commands referencing entities
+			that no longer exist are skipped.
+		*/
+		Result ApplyCommandBuffers();
+
+		/*
+			Writes all entities and their components to the stream. Components of types marked with
+			COMPONENT_RAW_SERIALIZABLE are written as their memory, components with Serialize and Deserialize functions
+			are written with them, other components aren't written and are default constructed when loading. The stream
+			doesn't have to support seeking.
+		*/
+		Result Serialize(WriteStream& stream);
+		/*
+			Creates the entities written by Serialize, existing entities are kept. All serialized component types must be
+			in the registry of this scene.
+		*/
+		Result Deserialize(ReadStream& stream);
+		/*
+			Same as Deserialize(ReadStream&) but reads from a memory image of the serialized data, for example a mapped
+			file. The image is parsed in place, the same is done for streams that are ContiguousReadStreams.
+		*/
+		Result Deserialize(const void* data, uintMem size);
 
 		template<typename C> requires IsComponent<C>
 		Result UpdateSystem();
@@ -35,23 +90,77 @@ namespace Blaze::ECS
 		const ComponentContainer& GetComponents(const ComponentTypeData&);
 		const ComponentContainer& GetComponents(uintMem index);
 
+		/*
+			Components are stamped with the current change version when they are created and when they are marked as
+			changed. A consumer should remember the value returned by AdvanceChangeVersion and pass it to ForEach the
+			next time to get everything that changed in between.
+		*/
+		inline uint32 GetChangeVersion() const { return changeVersion; }
+		/*
+			Increments the change version and returns the previous one
+		*/
+		uint32 AdvanceChangeVersion();
+		/*
+			Calls 'function' with every component selected by the filter, for example:
+				scene.ForEach<Changed<C>>(lastVersion, [](C* component) { ... });
+			Only buckets that changed after 'sinceVersion' are visited.
+		*/
+		template<typename Filter, typename F> requires IsChangeFilter<Filter> && std::invocable<F, typename Filter::ComponentType*>
+		void ForEach(uint32 sinceVersion, const F& function);
+
 		ArrayView<Entity*> GetEntities() const;
+		/*
+			Returns the entity that the handle refers to or nullptr if that entity was destroyed
+		*/
+		Entity* GetEntity(EntityHandle handle) const;
+		bool IsValid(EntityHandle handle) const;
 		
 		inline const ComponentTypeRegistry& GetRegistry() const { return registry; }
 
+		friend class Entity;
 		friend class PredefinedEntity;
 		template<typename ... Cs> requires (IsComponent<Cs> && ...)
 		friend class CustomEntity;
 	private:
 		static constexpr uintMem entityBucketElementCount = 64;
+		static constexpr uintMem destroyedEntityArrayIndex = std::numeric_limits<uintMem>::max();
 
 		ComponentTypeRegistry registry;
 		Array<System*> systems;		
 		Array<ComponentContainer> containers;
+		Array<CommandBuffer> commandBuffers;
+		uint32 changeVersion;
+
+		//All alive entities, Entity::arrayIndex is the index of the entity in this array
 		Array<Entity*> entities;
+
+		//Entities are stored in buckets of 'entityBucketElementCount' entities that are never moved. A slot index is
+		//the index of the entity inside this storage
+		Array<Entity*> entityBuckets;
+		Array<uint32> entityGenerations;
+		Array<uint32> freeEntitySlots;
+
+		//Entity metadata indexed by slot. Components are stored by type index so there are 'containers.Count()' elements
+		//per slot, the types in the order they were added are stored the same way. Masks have 'componentMaskSize' elements
+		//per slot
+		uintMem componentMaskSize;
+		Array<uint64> entityComponentMasks;
+		Array<Component*> entityComponents;
+		Array<uint16> entityComponentTypes;
 		
+		Entity* AllocateEntity(ArrayView<const ComponentTypeData*> typesData);
+		void FreeEntity(Entity* entity);
+
+		inline Entity* GetEntityInSlot(uint32 slot) const { return entityBuckets[slot / entityBucketElementCount] + slot % entityBucketElementCount; }
+		inline Component** GetEntityComponents(uint32 slot) { return entityComponents.Ptr() + slot * containers.Count(); }
+		inline uint16* GetEntityComponentTypes(uint32 slot) { return entityComponentTypes.Ptr() + slot * containers.Count(); }
+		inline uint64* GetEntityComponentMask(uint32 slot) { return entityComponentMasks.Ptr() + slot * componentMaskSize; }
+
+		Result ApplyCommandBuffer(const CommandBuffer& commandBuffer);
+		Result DeserializeContiguous(ContiguousReadStream& stream);
+
 		Entity* CreateEntity(ArrayView<const ComponentTypeData*> typesData);
-		ECS::Component** AllocateComponents();
+		void AllocateComponents();
 		Component* GetCurrentComponent();
 		void FinishEntityCreation();		
 
@@ -70,7 +179,7 @@ namespace Blaze::ECS
 		SetTypesData<C...>(typesData);
 
 		auto entity = CreateEntity(typesData);
-		Component** rawComponents = AllocateComponents();
+		AllocateComponents();
 
 		for (auto typeData : typesData)
 			typeData->Construct(GetCurrentComponent());
@@ -79,7 +188,7 @@ namespace Blaze::ECS
 
 		uint i = 0;
 		Tuple<C*...> components{
-			 (C*)rawComponents[i++]...
+			 (C*)entity->GetComponent(*typesData[i++])...
 		};
 
 		return EntityView<C...>(entity, components);
@@ -118,6 +227,27 @@ namespace Blaze::ECS
 		return GetComponents(*typeData);
 	}	
 
+	template<typename Filter, typename F> requires IsChangeFilter<Filter> && std::invocable<F, typename Filter::ComponentType*>
+	inline void Scene::ForEach(uint32 sinceVersion, const F& function)
+	{
+		using C = typename Filter::ComponentType;
+
+		const ComponentTypeData* typeData;
+
+		if (!registry.GetComponentTypeData<C>(typeData))
+		{
+			Debug::Logger::LogError("Blaze Engine", "Component type is not in registry");
+			return;
+		}
+
+		auto callback = [&](Component* component) { function((C*)component); };
+
+		if constexpr (Filter::onlyAdded)
+			containers[typeData->Index()].ForEachAdded(sinceVersion, callback);
+		else
+			containers[typeData->Index()].ForEachChanged(sinceVersion, callback);
+	}
+
 	template<typename C> requires IsComponent<C>
 	inline void Scene::SetTypeData(const ComponentTypeData*& ptr)
 	{
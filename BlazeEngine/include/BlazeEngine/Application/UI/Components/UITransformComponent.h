@@ -38,15 +38,6 @@ namespace Blaze::UI::Components
 	class BLAZE_API UITransformComponent : public ECS::Component
 	{		
 	public:		
-		Vec2f pos;
-		Vec2f size;
-
-		float scale;
-		float rotation;
-
-		Vec2f pivot;
-		Vec2f anchorPivot;
-		
 		UITransformComponent();
 		UITransformComponent(const UITransformComponent&);		
 		UITransformComponent(const UITransformData& data);
@@ -66,6 +57,23 @@ namespace Blaze::UI::Components
 		void SetAnchor(UITransformComponent* anchor);
 		UITransformComponent* GetAnchor() const { return anchor; }						
 
+		/*
+			The UI scene only resolves transforms that were changed, so the setters mark the component as changed
+		*/
+		void SetPos(Vec2f pos);
+		void SetSize(Vec2f size);
+		void SetScale(float scale);
+		void SetRotation(float rotation);
+		void SetPivot(Vec2f pivot);
+		void SetAnchorPivot(Vec2f anchorPivot);
+
+		inline Vec2f GetPos() const { return pos; }
+		inline Vec2f GetSize() const { return size; }
+		inline float GetScale() const { return scale; }
+		inline float GetRotation() const { return rotation; }
+		inline Vec2f GetPivot() const { return pivot; }
+		inline Vec2f GetAnchorPivot() const { return anchorPivot; }
+
 		void Setup(const UITransformData& data);
 
 		UITransformComponent& operator=(const UITransformComponent&);
@@ -73,12 +81,23 @@ namespace Blaze::UI::Components
 		COMPONENT(UITransformComponent, ECS::System);
 
 		friend class UIScene;		
+		friend class UIElementComponent;
 	private:		
+		Vec2f pos;
+		Vec2f size;
+
+		float scale;
+		float rotation;
+
+		Vec2f pivot;
+		Vec2f anchorPivot;
+
 		UIElementComponent* elementComponent;
 		UIPosOverrideComponent* posOverrideComponent;
 		UISizeOverrideComponent* sizeOverrideComponent;		
 
 		uint32 updateState;
+		uint32 dirtyState;
 		
 		Mat4f matrix;
 		float finalScale;
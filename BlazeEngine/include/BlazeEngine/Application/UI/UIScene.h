@@ -95,12 +95,18 @@ namespace Blaze::UI
 
 		uint32 updateState;		
 
+		//Change version of the ECS scene at the last update, only transforms changed after it are resolved
+		uint32 lastChangeVersion;
+		uint32 dirtyState;
+		Array<Components::UITransformComponent*> dirtyTransforms;
+
 		Result UpdateSystemUnsafe(const ECS::ComponentTypeData&);
 		UISystem* GetSystemUnsafe(const ECS::ComponentTypeData&);
 
 		Result PrepareElementCreation(StringView name, StringView layer);
 		Result FinishElementCreation(Components::UIElementComponent* element);
 		
+		void MarkDirty(Components::UITransformComponent* transform);
 		Result ResolveSize(Components::UITransformComponent* transform);
 		Result ResolvePosition(Components::UITransformComponent* transform);		
 	};	
@@ -22,10 +22,14 @@
 
 #include "BlazeEngine/EntryPoint/EntryPoint.h"
 
+#include "BlazeEngine/Threading/MainThread.h"
+
+#include "BlazeEngine/Application/ECS/CommandBuffer.h"
 #include "BlazeEngine/Application/ECS/Component.h"
 #include "BlazeEngine/Application/ECS/ComponentTypeRegistry.h"
 #include "BlazeEngine/Application/ECS/Entity.h"
 #include "BlazeEngine/Application/ECS/EntityReference.h"
 #include "BlazeEngine/Application/ECS/EntityView.h"
+#include "BlazeEngine/Application/ECS/QueryFilters.h"
 #include "BlazeEngine/Application/ECS/Scene.h"
 #include "BlazeEngine/Application/ECS/System.h"
\ No newline at end of file
@@ -6,6 +6,11 @@ namespace Blaze
 	template<typename T>
 	class EventHandler;
 
+	/*
+		Handlers are kept in an immutable array. Call loads the current array and walks it without locking, adding
+		or removing a handler publishes a new copy. Arrays that calls might still be walking are freed once no call
+		is running. A handler removed while a call is running isn't called by it anymore.
+	*/
 	template<typename T>
 	class BLAZE_API EventDispatcher
 	{
@@ -22,42 +27,68 @@ namespace Blaze
 
 		EventDispatcher& operator=(const EventDispatcher& other) = delete;
 		EventDispatcher& operator=(EventDispatcher&& other) noexcept;
+	protected:
+		/*
+			Calls the handlers for every event in order, the handler array is loaded once for the whole batch
+		*/
+		void CallHandlers(const T* events, uintMem count);
 	private:
-		struct HandlerCallData
-		{			
-			DualList<EventHandler<T>*>::Iterator handlerIt;
-			bool toBeDeleted;
+		struct HandlerList
+		{
+			uintMem count;
+			HandlerList* nextRetired;
+
+			//The handlers are stored right after the list. Removed handlers are set to nullptr in every list that
+			//is still alive, so running calls skip them
+			std::atomic<EventHandler<T>*>* Handlers() { return (std::atomic<EventHandler<T>*>*)(this + 1); }
 		};
+
+		//Locked by AddHandler, RemoveHandler and when freeing retired lists
 		std::mutex mutex;
-		
-		DualList<HandlerCallData> callsData;
-		DualList<EventHandler<T>*> handlers;		
+		std::atomic<HandlerList*> handlers;
+		//Replaced lists that calls might still be using
+		HandlerList* retiredHandlers;
+		std::atomic<bool> hasRetiredHandlers;
+		std::atomic<uint> activeCallCount;
 
-		void EraseHandlerFromCallData(EventHandler<T>* it);
+		static HandlerList* CreateHandlerList(uintMem count);
+		void PublishHandlerList(HandlerList* list);
+		void FreeRetiredHandlerLists();
 	};
 
 	class BLAZE_API std::mutex;
 
 	template<typename T>
 	inline EventDispatcher<T>::EventDispatcher()
+		: handlers(nullptr), retiredHandlers(nullptr), hasRetiredHandlers(false), activeCallCount(0)
 	{
 
 	}
 	template<typename T>
 	inline EventDispatcher<T>::EventDispatcher(EventDispatcher<T>&& other) noexcept		
-		: callsData(std::move(other.callsData)), handlers(std::move(other.handlers))
+		: handlers(other.handlers.exchange(nullptr)), retiredHandlers(std::exchange(other.retiredHandlers, nullptr)), hasRetiredHandlers(other.hasRetiredHandlers.exchange(false)), activeCallCount(0)
 	{						
-		for (EventHandler<T>*& handler : handlers)					
-			handler->dispatcher = this;		
+		if (HandlerList* list = handlers.load(std::memory_order_relaxed))
+			for (uintMem i = 0; i < list->count; ++i)
+				list->Handlers()[i].load(std::memory_order_relaxed)->dispatcher = this;
 	}
 	template<typename T>
 	inline EventDispatcher<T>::~EventDispatcher()
 	{
-		for (auto& handler : handlers)
+		if (HandlerList* list = handlers.load(std::memory_order_relaxed))
 		{
-			handler->DispatcherDestroyed();
-			handler->dispatcher = nullptr;
+			for (uintMem i = 0; i < list->count; ++i)
+			{
+				EventHandler<T>* handler = list->Handlers()[i].load(std::memory_order_relaxed);
+				handler->DispatcherDestroyed();
+				handler->dispatcher = nullptr;
+			}
+
+			Memory::Free(list);
 		}
+
+		while (retiredHandlers != nullptr)
+			Memory::Free(std::exchange(retiredHandlers, retiredHandlers->nextRetired));
 	}
 
 	template<typename T>
@@ -69,7 +100,16 @@ namespace Blaze
 			return BLAZE_ERROR_RESULT("Blaze Engine", "Trying to add a evnet handler to a dispatcher but it is already subscribed to a dispatcher");
 
 		handler.dispatcher = this;		
-		handlers.AddBack(&handler);		
+
+		HandlerList* oldList = handlers.load(std::memory_order_relaxed);
+		uintMem oldCount = oldList == nullptr ? 0 : oldList->count;
+		HandlerList* newList = CreateHandlerList(oldCount + 1);
+
+		for (uintMem i = 0; i < oldCount; ++i)
+			newList->Handlers()[i].store(oldList->Handlers()[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+		newList->Handlers()[oldCount].store(&handler, std::memory_order_relaxed);
+
+		PublishHandlerList(newList);
 
 		return Result();
 	}
@@ -81,21 +121,36 @@ namespace Blaze
 		
 		handler.dispatcher = nullptr;
 
-		for (HandlerCallData& callData : callsData)
-			if (*callData.handlerIt == &handler)
-			{				
-				callData.toBeDeleted = true;
-				return Result();
-			}
+		HandlerList* oldList = handlers.load(std::memory_order_relaxed);
 
-		handlers.EraseOne([&](auto value) -> bool {
-			if (value == &handler)
-			{
-				EraseHandlerFromCallData(value);
-				return true;
-			}
-			return false;
-			});
+		if (oldList == nullptr)
+			return Result();
+
+		uintMem index = 0;
+		while (index < oldList->count && oldList->Handlers()[index].load(std::memory_order_relaxed) != &handler)
+			++index;
+
+		if (index == oldList->count)
+			return Result();
+
+		//Calls that are walking an older list must not reach the handler anymore
+		for (HandlerList* list = oldList; list != nullptr; list = list == oldList ? retiredHandlers : list->nextRetired)
+			for (uintMem i = 0; i < list->count; ++i)
+				if (list->Handlers()[i].load(std::memory_order_relaxed) == &handler)
+					list->Handlers()[i].store(nullptr, std::memory_order_release);
+
+		HandlerList* newList = nullptr;
+
+		if (oldList->count != 1)
+		{
+			newList = CreateHandlerList(oldList->count - 1);
+
+			for (uintMem i = 0, j = 0; i < oldList->count; ++i)
+				if (i != index)
+					newList->Handlers()[j++].store(oldList->Handlers()[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+		}
+
+		PublishHandlerList(newList);
 
 		return Result();
 	}
@@ -103,39 +158,7 @@ namespace Blaze
 	template<typename T>
 	inline Result EventDispatcher<T>::Call(T event)
 	{						
-		std::unique_lock<std::mutex> lk{ mutex };
-		
-		auto callDataIt = callsData.AddBack();
-		HandlerCallData& callData = *callDataIt;
-		callData.handlerIt = handlers.FirstIterator();
-		callData.toBeDeleted = false;
-
-		while(!callData.handlerIt.IsNull())
-		{						
-			EventHandler<T>& handler = **callData.handlerIt;			
-
-			if (handler.listening)
-			{
-				lk.unlock();
-				handler.OnEvent(event);
-				lk.lock();
-			}			
-
-			if (callData.toBeDeleted)
-			{				
-				auto it = callData.handlerIt;
-				EraseHandlerFromCallData(*callData.handlerIt);				
-				handlers.Erase(it);
-				callData.toBeDeleted = false;
-			}				
-								
-			if (handler.suppress || callData.handlerIt.IsNull())
-				break;
-
-			++callData.handlerIt;			
-		}
-
-		callsData.Erase(callDataIt);
+		CallHandlers(&event, 1);
 
 		return Result();
 	}	
@@ -145,20 +168,99 @@ namespace Blaze
 	{
 		std::unique_lock<std::mutex> lk{ mutex };
 
-		handlers = std::move(other.handlers);
-		callsData = std::move(other.callsData);
+		if (HandlerList* list = handlers.exchange(other.handlers.exchange(nullptr)))
+		{
+			for (uintMem i = 0; i < list->count; ++i)
+				list->Handlers()[i].load(std::memory_order_relaxed)->dispatcher = nullptr;
 
-		for (EventHandler<T>*& handler : handlers)		
-			handler->dispatcher = this;
+			list->nextRetired = retiredHandlers;
+			retiredHandlers = list;
+		}
+
+		while (other.retiredHandlers != nullptr)
+		{
+			HandlerList* list = std::exchange(other.retiredHandlers, other.retiredHandlers->nextRetired);
+			list->nextRetired = retiredHandlers;
+			retiredHandlers = list;
+		}
+		other.hasRetiredHandlers = false;
+		hasRetiredHandlers = retiredHandlers != nullptr;
+
+		if (HandlerList* list = handlers.load(std::memory_order_relaxed))
+			for (uintMem i = 0; i < list->count; ++i)
+				list->Handlers()[i].load(std::memory_order_relaxed)->dispatcher = this;
+
+		FreeRetiredHandlerLists();
 		
 		return *this;
 	}
 
 	template<typename T>
-	inline void EventDispatcher<T>::EraseHandlerFromCallData(EventHandler<T>* handler)
-	{		
-		for (HandlerCallData& callData : callsData)
-			if (*callData.handlerIt == handler)
-				--callData.handlerIt;
+	inline void EventDispatcher<T>::CallHandlers(const T* events, uintMem count)
+	{
+		activeCallCount.fetch_add(1);
+
+		HandlerList* list = handlers.load();
+
+		if (list != nullptr)
+			for (uintMem eventIndex = 0; eventIndex < count; ++eventIndex)
+				for (uintMem i = 0; i < list->count; ++i)
+				{
+					EventHandler<T>* handler = list->Handlers()[i].load(std::memory_order_acquire);
+
+					if (handler == nullptr)
+						continue;
+
+					if (handler->listening)
+						handler->OnEvent(events[eventIndex]);
+
+					//The handler might have removed itself
+					if (list->Handlers()[i].load(std::memory_order_acquire) == handler && handler->suppress)
+						break;
+				}
+
+		if (activeCallCount.fetch_sub(1) == 1 && hasRetiredHandlers.load())
+		{
+			std::lock_guard<std::mutex> lk{ mutex };
+			FreeRetiredHandlerLists();
+		}
+	}
+	template<typename T>
+	inline typename EventDispatcher<T>::HandlerList* EventDispatcher<T>::CreateHandlerList(uintMem count)
+	{
+		HandlerList* list = (HandlerList*)Memory::Allocate(sizeof(HandlerList) + sizeof(std::atomic<EventHandler<T>*>) * count);
+		list->count = count;
+		list->nextRetired = nullptr;
+
+		for (uintMem i = 0; i < count; ++i)
+			std::construct_at(list->Handlers() + i, nullptr);
+
+		return list;
+	}
+	template<typename T>
+	inline void EventDispatcher<T>::PublishHandlerList(HandlerList* list)
+	{
+		HandlerList* oldList = handlers.exchange(list);
+
+		if (oldList != nullptr)
+		{
+			oldList->nextRetired = retiredHandlers;
+			retiredHandlers = oldList;
+			hasRetiredHandlers = true;
+		}
+
+		FreeRetiredHandlerLists();
+	}
+	template<typename T>
+	inline void EventDispatcher<T>::FreeRetiredHandlerLists()
+	{
+		//A call that starts after this check loads the current list, which is never retired here
+		if (retiredHandlers == nullptr || activeCallCount.load() != 0)
+			return;
+
+		while (retiredHandlers != nullptr)
+			Memory::Free(std::exchange(retiredHandlers, retiredHandlers->nextRetired));
+
+		hasRetiredHandlers = false;
 	}
 }
\ No newline at end of file
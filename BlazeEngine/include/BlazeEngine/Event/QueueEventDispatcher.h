@@ -3,109 +3,176 @@
 
 namespace Blaze
 {
-	template<typename T, AllocatorType Allocator = DefaultAllocator, uint BucketSize = 8>
+	/*
+		Coalescing policies decide if a new event is folded into the last queued one instead of being queued.
+		Coalesce returns true if 'event' was folded into 'last'
+	*/
+	template<typename Policy, typename T>
+	concept EventCoalescingPolicy = requires(T& last, const T& event) {
+		{ Policy::Coalesce(last, event) } -> std::same_as<bool>;
+	};
+
+	/*
+		Every event is queued
+	*/
+	struct QueueAllEvents
+	{
+		template<typename T>
+		static bool Coalesce(T& last, const T& event) { return false; }
+	};
+	/*
+		A new event replaces the last queued one, so only the newest of a burst is dispatched. Meant for events
+		where only the latest state matters, like resizes of a single window
+	*/
+	struct KeepLastEvent
+	{
+		template<typename T>
+		static bool Coalesce(T& last, const T& event) { last = event; return true; }
+	};
+	/*
+		'MergeFunction' is called as bool(T& last, const T& event), it folds the new event into the last queued one
+		or returns false if they can't be merged. For example mouse motion deltas can be summed
+	*/
+	template<auto MergeFunction>
+	struct MergeEvents
+	{
+		template<typename T>
+		static bool Coalesce(T& last, const T& event) { return MergeFunction(last, event); }
+	};
+
+	/*
+		Dispatcher that defers events. Call only queues the event and Flush dispatches everything queued until then
+		to the handlers as one batch. Events are stored contiguously in two buffers that are swapped by Flush, so
+		events queued while flushing go to the next flush and the storage is reused frame after frame.
+	*/
+	template<typename T, typename CoalescingPolicy = QueueAllEvents, AllocatorType Allocator = DefaultAllocator>
+		requires EventCoalescingPolicy<CoalescingPolicy, T>
 	class QueueEventDispatcher : public EventDispatcher<T>
 	{
 	public:
 		QueueEventDispatcher();
-
-		void Call(T event) override;
-		void ProcessQueue();
+		~QueueEventDispatcher();
+
+		Result Call(T event) override;
+		/*
+			Dispatches all queued events. Returns the number of dispatched events. Must only be called from one
+			thread at a time, calls made by the handlers while flushing do nothing
+		*/
+		uintMem Flush();
+		/*
+			Destroys all queued events without dispatching them
+		*/
+		void Clear();
 
 		bool IsEmpty() const;
 	private:
-		struct Bucket
+		struct EventBuffer
 		{
-			byte elements[sizeof(T) / BucketSize];
-			Bucket* next;
+			T* events = nullptr;
+			uintMem count = 0;
+			uintMem capacity = 0;
 		};
 
-		std::mutex mutex;
-		Bucket first;
-		Bucket* last;
-		uint lastBucketCount;
+		mutable AdaptiveMutex mutex;
+		EventBuffer queued;
+		//Only used by Flush, kept to reuse its storage
+		EventBuffer flushing;
+		bool isFlushing = false;
 		BLAZE_ALLOCATOR_ATTRIBUTE Allocator allocator;
+
+		void Grow(EventBuffer& buffer);
+		void FreeBuffer(EventBuffer& buffer);
 	};
-	template<typename T, AllocatorType Allocator, uint BucketSize>
-	inline QueueEventDispatcher<T, Allocator, BucketSize>::QueueEventDispatcher()
-		: lastBucketCount(0), last(&first)
+
+	template<typename T, typename CoalescingPolicy, AllocatorType Allocator> requires EventCoalescingPolicy<CoalescingPolicy, T>
+	inline QueueEventDispatcher<T, CoalescingPolicy, Allocator>::QueueEventDispatcher()
 	{
-		first.next = nullptr;
 	}
-
-	template<typename T, AllocatorType Allocator, uint BucketSize>
-	inline void QueueEventDispatcher<T, Allocator, BucketSize>::Call(T event)
+	template<typename T, typename CoalescingPolicy, AllocatorType Allocator> requires EventCoalescingPolicy<CoalescingPolicy, T>
+	inline QueueEventDispatcher<T, CoalescingPolicy, Allocator>::~QueueEventDispatcher()
 	{
-		std::lock_guard<std::mutex> lg { mutex };
-		if (lastBucketCount == BucketSize)
-		{
-			lastBucketCount = 0;
-			last->next = allocator.Allocate(sizeof(Bucket));
-			last = last->next;
-			last->next = nullptr;
-		}
-
-		T* element = (T*)(last->elements + lastBucketCount * sizeof(T));
-		std::construct_at(element, std::move(event));
-		++lastBucketCount;
+		FreeBuffer(queued);
+		FreeBuffer(flushing);
 	}
-	template<typename T, AllocatorType Allocator, uint BucketSize>
-	inline void QueueEventDispatcher<T, Allocator, BucketSize>::ProcessQueue()
-	{			
-		std::lock_guard<std::mutex> lg { mutex };
+	template<typename T, typename CoalescingPolicy, AllocatorType Allocator> requires EventCoalescingPolicy<CoalescingPolicy, T>
+	inline Result QueueEventDispatcher<T, CoalescingPolicy, Allocator>::Call(T event)
+	{
+		std::lock_guard<AdaptiveMutex> lk{ mutex };
 
-		T* it = first->elements;
+		if (queued.count != 0 && CoalescingPolicy::Coalesce(queued.events[queued.count - 1], event))
+			return Result();
 
-		if (first->next == nullptr)
-		{
-			for (uint i = 0; i < lastBucketCount; ++i)
-			{
-				EventDispatcher::Call(it[i]);
-				it[i].~T();
-			}
+		if (queued.count == queued.capacity)
+			Grow(queued);
 
-			lastBucketCount = 0;
+		std::construct_at(queued.events + queued.count, std::move(event));
+		++queued.count;
 
-			return;
-		}
+		return Result();
+	}
+	template<typename T, typename CoalescingPolicy, AllocatorType Allocator> requires EventCoalescingPolicy<CoalescingPolicy, T>
+	inline uintMem QueueEventDispatcher<T, CoalescingPolicy, Allocator>::Flush()
+	{
+		if (isFlushing)
+			return 0;
 
-		for (uint i = 0; i < BucketSize; ++i)
-			EventDispatcher::Call(it[i]);
+		{
+			std::lock_guard<AdaptiveMutex> lk{ mutex };
+			std::swap(queued, flushing);
+		}
 
-		Bucket* current = first->next;
+		uintMem count = flushing.count;
 
-		while (current->next != nullptr)
-		{
-			it = current->elements;
+		isFlushing = true;
+		EventDispatcher<T>::CallHandlers(flushing.events, count);
+		isFlushing = false;
 
-			for (uint i = 0; i < BucketSize; ++i, ++it)
-			{
-				EventDispatcher::Call(*it);
+		std::destroy_n(flushing.events, count);
+		flushing.count = 0;
 
-				it->~T();
-			}			
+		return count;
+	}
+	template<typename T, typename CoalescingPolicy, AllocatorType Allocator> requires EventCoalescingPolicy<CoalescingPolicy, T>
+	inline void QueueEventDispatcher<T, CoalescingPolicy, Allocator>::Clear()
+	{
+		std::lock_guard<AdaptiveMutex> lk{ mutex };
 
-			allocator.Free(current);
-			current = current->next;
-		}		
+		std::destroy_n(queued.events, queued.count);
+		queued.count = 0;
+	}
+	template<typename T, typename CoalescingPolicy, AllocatorType Allocator> requires EventCoalescingPolicy<CoalescingPolicy, T>
+	inline bool QueueEventDispatcher<T, CoalescingPolicy, Allocator>::IsEmpty() const
+	{
+		std::lock_guard<AdaptiveMutex> lk{ mutex };
 
-		it = current->elements;
+		return queued.count == 0;
+	}
+	template<typename T, typename CoalescingPolicy, AllocatorType Allocator> requires EventCoalescingPolicy<CoalescingPolicy, T>
+	inline void QueueEventDispatcher<T, CoalescingPolicy, Allocator>::Grow(EventBuffer& buffer)
+	{
+		uintMem newCapacity = buffer.capacity == 0 ? 16 : buffer.capacity * 2;
+		T* newEvents = (T*)allocator.Allocate(sizeof(T) * newCapacity);
 
-		for (uint i = 0; i < lastBucketCount; ++i, ++it)
+		for (uintMem i = 0; i < buffer.count; ++i)
 		{
-			EventDispatcher::Call(*it);
-			it->~T();
+			std::construct_at(newEvents + i, std::move(buffer.events[i]));
+			std::destroy_at(buffer.events + i);
 		}
 
-		allocator.Free(current);
+		if (buffer.events != nullptr)
+			allocator.Free(buffer.events);
 
-		lastBucketCount = 0;
-		first.next = nullptr;
-		last = &first;
+		buffer.events = newEvents;
+		buffer.capacity = newCapacity;
 	}
-	template<typename T, AllocatorType Allocator, uint BucketSize>
-	inline bool QueueEventDispatcher<T, Allocator, BucketSize>::IsEmpty() const
+	template<typename T, typename CoalescingPolicy, AllocatorType Allocator> requires EventCoalescingPolicy<CoalescingPolicy, T>
+	inline void QueueEventDispatcher<T, CoalescingPolicy, Allocator>::FreeBuffer(EventBuffer& buffer)
 	{
-		return first->next != nullptr || lastBucketCount != 0;
+		std::destroy_n(buffer.events, buffer.count);
+
+		if (buffer.events != nullptr)
+			allocator.Free(buffer.events);
+
+		buffer = EventBuffer();
 	}
-}
\ No newline at end of file
+}
@@ -38,6 +38,10 @@ namespace Blaze
 
 		BLAZE_API void Update();		
 
+		/*
+			Returns the state of the key as of the last call to Update. 'pressed' and 'released' are set for the frame
+			in which the key went down or up. Must be called from the thread that calls Update
+		*/
 		BLAZE_API KeyState GetLastKeyState(Key key);		
 
 		enum class CursorType
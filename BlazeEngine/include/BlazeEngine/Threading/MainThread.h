@@ -0,0 +1,18 @@
+#pragma once
+#include "BlazeEngineCore/Threading/Task.h"
+
+namespace Blaze
+{
+	/*
+		Runs the function on the main thread, the one that pumps the OS events, without waiting for it
+	*/
+	BLAZE_API void PostToMainThread(std::function<void()> function);
+
+	/*
+		Continues the coroutine on the main thread
+	*/
+	inline auto ResumeOnMainThread()
+	{
+		return ResumeVia(PostToMainThread);
+	}
+}
@@ -0,0 +1,61 @@
+#include "pch.h"
+#include "BlazeEngine/Application/ECS/CommandBuffer.h"
+#include <atomic>
+
+namespace Blaze::ECS
+{
+	//Shared by all buffers, so recordings of different buffers don't get the same provisional generation
+	static std::atomic<uint32> provisionalGenerationCounter = 0;
+
+	static uint32 NewProvisionalGeneration()
+	{
+		return provisionalGenerationCounter.fetch_add(1, std::memory_order_relaxed) | EntityHandle::ProvisionalBit;
+	}
+
+	CommandBuffer::CommandBuffer()
+		: registry(nullptr), createCount(0), provisionalGeneration(NewProvisionalGeneration())
+	{
+	}
+	CommandBuffer::CommandBuffer(const ComponentTypeRegistry* registry)
+		: registry(registry), createCount(0), provisionalGeneration(NewProvisionalGeneration())
+	{
+	}
+	EntityHandle CommandBuffer::Create(ArrayView<const ComponentTypeData*> typesData)
+	{
+		EntityHandle handle{ .index = createCount++, .generation = provisionalGeneration };
+		AddCommand(CommandType::Create, handle, typesData);
+		return handle;
+	}
+	void CommandBuffer::Destroy(EntityHandle handle)
+	{
+		AddCommand(CommandType::Destroy, handle, ArrayView<const ComponentTypeData*>());
+	}
+	void CommandBuffer::AddComponent(EntityHandle handle, const ComponentTypeData& typeData)
+	{
+		const ComponentTypeData* typeDataPtr = &typeData;
+		AddCommand(CommandType::AddComponent, handle, ArrayView<const ComponentTypeData*>(&typeDataPtr, 1));
+	}
+	void CommandBuffer::RemoveComponent(EntityHandle handle, const ComponentTypeData& typeData)
+	{
+		const ComponentTypeData* typeDataPtr = &typeData;
+		AddCommand(CommandType::RemoveComponent, handle, ArrayView<const ComponentTypeData*>(&typeDataPtr, 1));
+	}
+	void CommandBuffer::Clear()
+	{
+		createCount = 0;
+		provisionalGeneration = NewProvisionalGeneration();
+		commands.Clear();
+		typesData.Clear();
+	}
+	void CommandBuffer::AddCommand(CommandType type, EntityHandle handle, ArrayView<const ComponentTypeData*> typesData)
+	{
+		Command& command = *commands.AddBack();
+		command.type = type;
+		command.handle = handle;
+		command.typesDataOffset = (uint32)this->typesData.Count();
+		command.typesDataCount = (uint32)typesData.Count();
+
+		for (auto typeData : typesData)
+			this->typesData.AddBack(typeData);
+	}
+}
@@ -10,16 +10,42 @@ namespace Blaze::ECS
 	//extern ComponentTypeData emptyComponenTypeData;
 
 	Component::Component()
-		: entity(nullptr), system(nullptr)
+		: entity(nullptr), system(nullptr), changedVersion(0), addedVersion(0)
 	{
 		if (currentEntityCreationData->scene != nullptr)
 		{
-			entity = currentEntityCreationData->currentEntity;
-			system = currentEntityCreationData->systems[(*currentEntityCreationData->currentTypeData)->Index()];			
+			const ComponentTypeData& typeData = **currentEntityCreationData->currentTypeData;
 			++currentEntityCreationData->currentTypeData;
+
+			Attach(
+				currentEntityCreationData->currentEntity, 
+				currentEntityCreationData->systems[typeData.Index()], 
+				typeData, 
+				currentEntityCreationData->scene->GetChangeVersion()
+			);
 		}
 	}
 
+	void Component::Attach(Entity* entity, System* system, const ComponentTypeData& typeData, uint32 version)
+	{
+		this->entity = entity;
+		this->system = system;
+		changedVersion = version;
+		addedVersion = version;
+		ComponentContainer::StampBucket(this, typeData, version, true);
+	}
+
+	void Component::MarkChanged()
+	{
+		const ComponentTypeData* typeData;
+
+		if (entity == nullptr || !GetTypeData(typeData))
+			return;
+
+		changedVersion = entity->GetScene()->GetChangeVersion();
+		ComponentContainer::StampBucket(this, *typeData, changedVersion, false);
+	}
+
 	bool Component::GetTypeData(const ComponentTypeData*& typeData) const
 	{
 		if (system == nullptr)
@@ -76,6 +102,10 @@ namespace Blaze::ECS
 		void* rawComponent = (byte*)element + sizeof(ElementHeader);
 		return (Component*)((byte*)rawComponent + typeData->BaseOffset());
 	}
+	Component* ComponentContainer::GetComponentInBucket(BucketHeader* bucket, uintMem index) const
+	{
+		return (Component*)((byte*)bucket + sizeof(BucketHeader) + index * elementSize + sizeof(ElementHeader) + typeData->BaseOffset());
+	}
 	void* ComponentContainer::FirstInBucket(BucketHeader* bucket) const
 	{
 		return (byte*)bucket + sizeof(BucketHeader) + std::countr_zero(bucket->flags) * elementSize + sizeof(ElementHeader);
@@ -174,10 +204,84 @@ namespace Blaze::ECS
 
 		buckets[0] = bucket;
 		buckets[0]->flags = 0;
+		buckets[0]->changedVersion = 0;
+		buckets[0]->addedVersion = 0;
 
 		bucketCount++;
 		nonFullBucketCount++;
 	}
+	void ComponentContainer::ReserveBuckets(uintMem count)
+	{
+		uintMem freeCount = 0;
+		for (uintMem i = 0; i < nonFullBucketCount; ++i)
+			freeCount += BucketElementCount - std::popcount(buckets[i]->flags);
+
+		if (freeCount >= count)
+			return;
+
+		uintMem newBucketCount = (count - freeCount + BucketElementCount - 1) / BucketElementCount;
+
+		BucketHeader** newBuckets = new BucketHeader * [bucketCount + newBucketCount];
+		memcpy(newBuckets + newBucketCount, buckets, sizeof(BucketHeader*) * bucketCount);
+		delete[] buckets;
+		buckets = newBuckets;
+
+		for (uintMem i = 0; i < newBucketCount; ++i)
+		{
+			buckets[i] = AllocateBucket();
+			buckets[i]->flags = 0;
+			buckets[i]->changedVersion = 0;
+			buckets[i]->addedVersion = 0;
+		}
+
+		bucketCount += newBucketCount;
+		nonFullBucketCount += newBucketCount;
+	}
+	void ComponentContainer::CompactBuckets()
+	{
+		uintMem newNonFullBucketCount = 0;
+		uintMem newBucketCount = 0;
+
+		for (uintMem i = 0; i < bucketCount; ++i)
+			if (!buckets[i]->IsEmpty())
+			{
+				++newBucketCount;
+				if (!buckets[i]->IsFull())
+					++newNonFullBucketCount;
+			}
+
+		BucketHeader** newBuckets = newBucketCount == 0 ? nullptr : new BucketHeader * [newBucketCount];
+		uintMem nonFullIndex = 0;
+		uintMem fullIndex = newNonFullBucketCount;
+
+		for (uintMem i = 0; i < bucketCount; ++i)
+		{
+			BucketHeader* bucket = buckets[i];
+
+			if (bucket->IsEmpty())
+				FreeBucket(bucket);
+			else if (bucket->IsFull())
+				newBuckets[fullIndex++] = bucket;
+			else
+				newBuckets[nonFullIndex++] = bucket;
+		}
+
+		delete[] buckets;
+		buckets = newBuckets;
+		bucketCount = newBucketCount;
+		nonFullBucketCount = newNonFullBucketCount;
+	}
+
+	void ComponentContainer::StampBucket(Component* component, const ComponentTypeData& typeData, uint32 version, bool added)
+	{
+		ElementHeader* element = (ElementHeader*)((byte*)component - typeData.BaseOffset() - sizeof(ElementHeader));
+		BucketHeader* bucket = element->bucket;
+
+		bucket->changedVersion = std::max(bucket->changedVersion, version);
+
+		if (added)
+			bucket->addedVersion = std::max(bucket->addedVersion, version);
+	}
 
 	ComponentContainer::ComponentContainer()
 		: buckets(nullptr), elementCount(0), bucketCount(0), nonFullBucketCount(0), elementSize(0), typeData(nullptr)
@@ -254,6 +358,35 @@ namespace Blaze::ECS
 			FreeBucket(bucket);
 		}
 	}
+	void ComponentContainer::AllocateMany(Component** components, uintMem count)
+	{
+		ReserveBuckets(count);
+
+		for (uintMem i = 0; i < count; ++i)
+			components[i] = Allocate();
+	}
+	void ComponentContainer::DestroyMany(Component** components, uintMem count)
+	{
+		for (uintMem i = 0; i < count; ++i)
+			typeData->Destruct(components[i]);
+
+		FreeMany(components, count);
+	}
+	void ComponentContainer::FreeMany(Component** components, uintMem count)
+	{
+		uintMem index;
+		BucketHeader* bucket;
+
+		for (uintMem i = 0; i < count; ++i)
+		{
+			GetComponentLocation(components[i], bucket, index);
+			bucket->Unmark(index);
+		}
+
+		elementCount -= count;
+
+		CompactBuckets();
+	}
 	void ComponentContainer::Clear()
 	{
 		for (auto el : *this)		
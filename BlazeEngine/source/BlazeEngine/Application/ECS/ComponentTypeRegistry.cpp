@@ -8,10 +8,12 @@ namespace Blaze::ECS
 	ComponentTypeData::ComponentTypeData(ComponentTypeRegistry* registry, StringView name, uint index,
 		uintMem size, ptrdiff_t baseOffset, Constructor constructoror, Destructor destructoror,
 		uintMem systemSize, ptrdiff_t systemBaseOffset, SystemConstructor systemConstructor, SystemDestructor systemDestructor,
+		bool rawSerializable, Serializer serializer, Deserializer deserializer,
 		Set<StringView> typeTags)
 		: registry(registry), typeName(name), index(index),
 		size(size), baseOffset(baseOffset), constructor(constructoror), destructor(destructoror),
 		systemSize(systemSize), systemBaseOffset(systemBaseOffset), systemConstructor(systemConstructor), systemDestructor(systemDestructor),
+		rawSerializable(rawSerializable), serializer(serializer), deserializer(deserializer),
 		typeTags(std::move(typeTags))
 	{
 
@@ -89,6 +91,7 @@ namespace Blaze::ECS
 	Result ComponentTypeRegistry::AddType(StringView name,
 		uintMem size, ptrdiff_t baseOffset, ComponentTypeData::Constructor constructor, ComponentTypeData::Destructor destructor,
 		uintMem systemSize, ptrdiff_t systemBaseOffset, ComponentTypeData::SystemConstructor systemConstructor, ComponentTypeData::SystemDestructor systemDestructor,
+		bool rawSerializable, ComponentTypeData::Serializer serializer, ComponentTypeData::Deserializer deserializer,
 		Array<StringView> typeTags)
 	{
 		auto [it, inserted] = nameTable.Insert(StringView(name), nullptr);
@@ -96,7 +99,7 @@ namespace Blaze::ECS
 		if (!inserted)
 			return BLAZE_WARNING_RESULT("Blaze Engine", "Trying to register a type but there is a type with the same name already registered");		
 
-		types.TryAddBack(this, name, types.Count(), size, baseOffset, constructor, destructor, systemSize, systemBaseOffset, systemConstructor, systemDestructor, ArrayView<StringView>(typeTags));		
+		types.TryAddBack(this, name, types.Count(), size, baseOffset, constructor, destructor, systemSize, systemBaseOffset, systemConstructor, systemDestructor, rawSerializable, serializer, deserializer, ArrayView<StringView>(typeTags));		
 
 		it->value = &types.Last();		
 		return Result();
@@ -110,6 +113,7 @@ namespace Blaze::ECS
 		std::construct_at(it, this, o.typeName, index,
 			o.size, o.baseOffset, o.constructor, o.destructor,
 			o.systemSize, o.systemBaseOffset, o.systemConstructor, o.systemDestructor,
+			o.rawSerializable, o.serializer, o.deserializer,
 			o.typeTags);
 			})
 	{					
@@ -155,6 +159,7 @@ namespace Blaze::ECS
 				std::construct_at(it, this, o.typeName, index,
 					o.size, o.baseOffset, o.constructor, o.destructor,
 					o.systemSize, o.systemBaseOffset, o.systemConstructor, o.systemDestructor,
+					o.rawSerializable, o.serializer, o.deserializer,
 					o.typeTags);
 			}));		
 		
@@ -68,44 +68,6 @@ namespace Blaze::ECS
 	}
 	*/	
 
-	const ComponentTypeData** FindEntityComponentData(Entity* entity, const ComponentTypeData& typeData)
-	{
-		auto first = GetEntityComponentsTypeData(entity);
-		auto last = first + entity->GetComponentCount();		
-
-		auto ptr = first;
-		while (ptr != last)
-			if (**ptr == typeData)
-				break;
-			else
-				++ptr;
-
-		if (ptr == last)
-			return nullptr;
-
-		return ptr;
-	}	
-	Component* FindEntityComponent(const Entity* entity, const ComponentTypeData& typeData)
-	{
-		auto first = GetEntityComponentsTypeData(entity);
-		auto last = first + entity->GetComponentCount();
-
-		auto ptr = first;
-		while (ptr != last)
-			if (**ptr == typeData)
-				break;
-			else
-				++ptr;
-
-		if (ptr == last)
-			return nullptr;
-
-		auto components = GetEntityComponents(entity);
-		uintMem index = ptr - first;
-
-		return components[index];
-	}
-			
 	Entity::Entity()
 		: scene(nullptr), componentCount(0)
 	{
@@ -118,37 +80,41 @@ namespace Blaze::ECS
 
 	bool Entity::HasComponent(const ComponentTypeData& typeData) const
 	{		
-		auto ptr = FindEntityComponent(this, typeData);		
-		return ptr != nullptr;
+		uintMem typeIndex = typeData.Index();
+
+		if (typeIndex >= scene->containers.Count())
+			return false;
+
+		return (scene->GetEntityComponentMask(handle.index)[typeIndex / 64] >> (typeIndex % 64)) & 1;
 	}
 	Component* Entity::GetComponent(const ComponentTypeData& typeData) const
 	{
-		auto ptr = FindEntityComponent(this, typeData);
-
-		if (ptr == nullptr)
+		if (!HasComponent(typeData))
 			return nullptr;
 
-		return ptr;		
+		return scene->GetEntityComponents(handle.index)[typeData.Index()];
 	}
 	Component* Entity::GetComponent(uintMem index) const
 	{
-		if (index > componentCount)
+		if (index >= componentCount)
 		{									
 			Debug::Logger::LogError("Blaze Engine", "Component index out of range. Index value was: " + StringParsing::Convert(index));
 			return nullptr;
 		}
 
-		return GetEntityComponents(this)[index];
+		uint16 typeIndex = scene->GetEntityComponentTypes(handle.index)[index];
+		return scene->GetEntityComponents(handle.index)[typeIndex];
 	}		
 	const ComponentTypeData* Entity::GetComponentTypeData(uintMem index)
 	{
-		if (index > componentCount)
+		if (index >= componentCount)
 		{
 			Debug::Logger::LogError("Blaze Engine", "Component index out of range. Index value was: " + StringParsing::Convert(index));
 			return nullptr;
 		}
 
-		return GetEntityComponentsTypeData(this)[index];
+		uint16 typeIndex = scene->GetEntityComponentTypes(handle.index)[index];
+		return &scene->GetRegistry().GetAllTypesData()[typeIndex];
 	}
 	const ComponentTypeRegistry* Entity::GetRegistry() const
 	{		
@@ -4,15 +4,7 @@
 
 namespace Blaze::ECS
 {	
-	List<EntityCreationData> entityCreationData;
-	EntityCreationData* currentEntityCreationData;
-
-	const ComponentTypeData** GetEntityComponentsTypeData(const Entity* entity)
-	{
-		return (const ComponentTypeData**)((const byte*)entity + sizeof(Entity) + sizeof(Component*) * entity->GetComponentCount());
-	}
-	Component** GetEntityComponents(const Entity* entity)
-	{
-		return (Component**)((const byte*)entity + sizeof(Entity));		
-	}
+	//Thread local so that entities can be created in different scenes from different threads
+	thread_local List<EntityCreationData> entityCreationData;
+	thread_local EntityCreationData* currentEntityCreationData = nullptr;
 }
\ No newline at end of file
@@ -8,21 +8,18 @@ namespace Blaze::ECS
 	class System;
 	class ComponentTypeData;
 	
-	const ComponentTypeData** GetEntityComponentsTypeData(const Entity* entity);
-	Component** GetEntityComponents(const Entity* entity);
-	
 	struct EntityCreationData
 	{		
 		Scene* scene = nullptr;		
 
 		
 		ArrayView<const ComponentTypeData*> typesData;				
-		const ComponentTypeData** currentTypeData;
+		const ComponentTypeData* const* currentTypeData = nullptr;
 		Entity* currentEntity = nullptr;
 
 		System** systems = nullptr;		
 	};
 	
-	extern List<EntityCreationData> entityCreationData;
-	extern EntityCreationData* currentEntityCreationData;
+	extern thread_local List<EntityCreationData> entityCreationData;
+	extern thread_local EntityCreationData* currentEntityCreationData;
 }
\ No newline at end of file
@@ -7,8 +7,9 @@
 namespace Blaze::ECS
 {
 	Scene::Scene()	
-		: registry(ComponentTypeRegistry::NewRegistry())
+		: registry(ComponentTypeRegistry::NewRegistry()), componentMaskSize(0), changeVersion(1)
 	{
+		SetCommandBufferCount(1);
 	}
 	Scene::~Scene()
 	{
@@ -16,12 +17,41 @@ namespace Blaze::ECS
 	}
 	Result Scene::SetRegistry(ComponentTypeRegistry registry)
 	{
+		//Per slot metadata is laid out for the current type count, so it can't be kept once the types change
+		if (!entities.Empty())
+			return BLAZE_ERROR_RESULT("Blaze Engine", "Changing the registry of a scene that has entities is not allowed");
+
+		auto oldTypes = this->registry.GetAllTypesData();
+
+		for (uintMem i = 0; i < oldTypes.Count(); ++i)
+		{
+			void* systemRaw = (uint8*)systems[i] - oldTypes[i].SystemBaseOffset();
+			oldTypes[i].DestructSystemDirect(systemRaw);
+			Memory::Free(systemRaw);
+		}
+
+		for (const auto& bucket : entityBuckets)
+			Memory::Free(bucket);
+
+		systems.Clear();
+		containers.Clear();
+		entityBuckets.Clear();
+		entityGenerations.Clear();
+		freeEntitySlots.Clear();
+		entityComponentMasks.Clear();
+		entityComponents.Clear();
+		entityComponentTypes.Clear();
+
+		for (auto& commandBuffer : commandBuffers)
+			commandBuffer.Clear();
+
 		this->registry = std::move(registry);
 
 		auto allTypes = this->registry.GetAllTypesData();
 
 		systems.Resize(allTypes.Count());
 		containers.Resize(allTypes.Count());
+		componentMaskSize = (allTypes.Count() + 63) / 64;
 
 		for (int i = 0; i < allTypes.Count(); ++i)
 		{
@@ -49,10 +79,10 @@ namespace Blaze::ECS
 			container.Clear();
 
 		for (const auto& entity : entities)
-		{
 			std::destroy_at(entity);
-			Memory::Free(entity);
-		}
+
+		for (const auto& bucket : entityBuckets)
+			Memory::Free(bucket);
 
 		auto types = registry.GetAllTypesData();
 
@@ -65,6 +95,15 @@ namespace Blaze::ECS
 		
 		registry = ComponentTypeRegistry::NewRegistry();
 		entities.Clear();
+		entityBuckets.Clear();
+		entityGenerations.Clear();
+		freeEntitySlots.Clear();
+		entityComponentMasks.Clear();
+		entityComponents.Clear();
+		entityComponentTypes.Clear();
+
+		for (auto& commandBuffer : commandBuffers)
+			commandBuffer.Clear();
 	}
 	Entity* Scene::Create(ArrayView<const ComponentTypeData*> typesData)
 	{		
@@ -82,6 +121,67 @@ namespace Blaze::ECS
 
 		return entity;
 	}
+	Array<Entity*> Scene::CreateMany(uintMem count, ArrayView<const ComponentTypeData*> typesData)
+	{
+		Array<Entity*> out{ count };
+
+		if (count == 0)
+			return out;
+
+		currentEntityCreationData = &*entityCreationData.AddFront();
+		currentEntityCreationData->scene = this;
+		currentEntityCreationData->typesData = typesData;
+		currentEntityCreationData->systems = systems.Ptr();
+
+		uintMem componentCount = typesData.Count();
+
+		entities.ReserveAdditional(count);
+
+		for (uintMem i = 0; i < count; ++i)
+			out[i] = AllocateEntity(typesData);
+
+		Array<Component*> components{ count };
+
+		for (uintMem j = 0; j < componentCount; ++j)
+		{
+			uint typeIndex = typesData[j]->Index();
+			containers[typeIndex].AllocateMany(components.Ptr(), count);
+
+			for (uintMem i = 0; i < count; ++i)
+				GetEntityComponents(out[i]->handle.index)[typeIndex] = components[i];
+		}
+
+		for (uintMem j = 0; j < componentCount; ++j)
+		{
+			uint typeIndex = typesData[j]->Index();
+
+			for (uintMem i = 0; i < count; ++i)
+			{
+				currentEntityCreationData->currentEntity = out[i];
+				currentEntityCreationData->currentTypeData = typesData.Ptr() + j;
+
+				typesData[j]->Construct(GetEntityComponents(out[i]->handle.index)[typeIndex]);
+			}
+		}
+
+		for (uintMem j = 0; j < componentCount; ++j)
+		{
+			uint typeIndex = typesData[j]->Index();
+			System* system = systems[typeIndex];
+
+			for (uintMem i = 0; i < count; ++i)
+				system->Created(GetEntityComponents(out[i]->handle.index)[typeIndex]);
+		}
+
+		entityCreationData.EraseFirst();
+
+		if (entityCreationData.Empty())
+			currentEntityCreationData = nullptr;
+		else
+			currentEntityCreationData = &entityCreationData.First();
+
+		return out;
+	}
 	
 	Result Scene::Destroy(Entity* entity)
 	{
@@ -91,26 +191,179 @@ namespace Blaze::ECS
 		if (entity->scene != this)
 			return BLAZE_ERROR_RESULT("BlazeEngine", "Trying to delete a entity from a scene that it doesn't belong to.");
 
-		auto componentsTypeData = GetEntityComponentsTypeData(entity);
-		auto components = GetEntityComponents(entity);
+		auto componentTypes = GetEntityComponentTypes(entity->handle.index);
+		auto components = GetEntityComponents(entity->handle.index);
 		uintMem componentCount = entity->GetComponentCount();
 
 		for (uintMem i = 0; i < componentCount; ++i)
-			systems[componentsTypeData[i]->Index()]->Destroyed(components[i]);
+			systems[componentTypes[i]]->Destroyed(components[componentTypes[i]]);
 
 		for (uintMem i = 0; i < componentCount; ++i)
-			containers[componentsTypeData[i]->Index()].Destroy(components[i]);
+			containers[componentTypes[i]].Destroy(components[componentTypes[i]]);
 
 		entities.Last()->arrayIndex = entity->arrayIndex;
 		entities[entity->arrayIndex] = entities.Last();
 		entities.EraseLast();		
 
-		std::destroy_at(entity);
+		FreeEntity(entity);
+
+		return Result();
+	}
+	Result Scene::Destroy(EntityHandle handle)
+	{
+		Entity* entity = GetEntity(handle);
+
+		if (entity == nullptr)
+			return BLAZE_WARNING_RESULT("BlazeEngine", "Trying to delete a entity that was already destroyed.");
+
+		return Destroy(entity);
+	}
+	Result Scene::DestroyMany(ArrayView<Entity*> toDestroy)
+	{
+		for (auto entity : toDestroy)
+			if (entity != nullptr && entity->scene != this)
+				return BLAZE_ERROR_RESULT("BlazeEngine", "Trying to delete a entity from a scene that it doesn't belong to.");
+
+		Array<Array<Component*>> typeComponents(containers.Count());
+		Array<Entity*> destroyedEntities;
+		destroyedEntities.ReserveExactly(toDestroy.Count());
+
+		for (auto entity : toDestroy)
+		{
+			if (entity == nullptr || entity->arrayIndex == destroyedEntityArrayIndex)
+				continue;
+
+			auto componentTypes = GetEntityComponentTypes(entity->handle.index);
+			auto components = GetEntityComponents(entity->handle.index);
+			uintMem componentCount = entity->GetComponentCount();
+
+			for (uintMem i = 0; i < componentCount; ++i)
+				typeComponents[componentTypes[i]].AddBack(components[componentTypes[i]]);
+
+			entity->arrayIndex = destroyedEntityArrayIndex;
+			destroyedEntities.AddBack(entity);
+		}
+
+		for (uintMem i = 0; i < typeComponents.Count(); ++i)
+			for (auto component : typeComponents[i])
+				systems[i]->Destroyed(component);
+
+		for (uintMem i = 0; i < typeComponents.Count(); ++i)
+			if (!typeComponents[i].Empty())
+				containers[i].DestroyMany(typeComponents[i].Ptr(), typeComponents[i].Count());
+
+		uintMem newCount = 0;
+		for (uintMem i = 0; i < entities.Count(); ++i)
+			if (entities[i]->arrayIndex != destroyedEntityArrayIndex)
+			{
+				entities[i]->arrayIndex = newCount;
+				entities[newCount] = entities[i];
+				++newCount;
+			}
+		entities.Truncate(newCount);
+
+		for (auto entity : destroyedEntities)
+			FreeEntity(entity);
+
+		return Result();
+	}
+	Result Scene::AddComponent(Entity* entity, const ComponentTypeData& typeData)
+	{
+		if (entity == nullptr || entity->scene != this)
+			return BLAZE_ERROR_RESULT("BlazeEngine", "Trying to add a component to a entity that doesn't belong to this scene.");
+
+		if (entity->HasComponent(typeData))
+			return BLAZE_WARNING_RESULT("BlazeEngine", "Trying to add a component to a entity that already has a component of that type.");
+
+		uint typeIndex = typeData.Index();
+		uint32 slot = entity->handle.index;
+
+		Component* component = containers[typeIndex].Allocate();
+
+		GetEntityComponents(slot)[typeIndex] = component;
+		GetEntityComponentTypes(slot)[entity->componentCount] = (uint16)typeIndex;
+		GetEntityComponentMask(slot)[typeIndex / 64] |= (uint64)1 << (typeIndex % 64);
+		++entity->componentCount;
+
+		const ComponentTypeData* typeDataPtr = &typeData;
+
+		currentEntityCreationData = &*entityCreationData.AddFront();
+		currentEntityCreationData->scene = this;
+		currentEntityCreationData->typesData = ArrayView<const ComponentTypeData*>(&typeDataPtr, 1);
+		currentEntityCreationData->systems = systems.Ptr();
+		currentEntityCreationData->currentTypeData = &typeDataPtr;
+		currentEntityCreationData->currentEntity = entity;
+
+		typeData.Construct(component);
+
+		entityCreationData.EraseFirst();
+
+		if (entityCreationData.Empty())
+			currentEntityCreationData = nullptr;
+		else
+			currentEntityCreationData = &entityCreationData.First();
 
-		Memory::Free(entity);
+		systems[typeIndex]->Created(component);
 
 		return Result();
 	}
+	Result Scene::RemoveComponent(Entity* entity, const ComponentTypeData& typeData)
+	{
+		if (entity == nullptr || entity->scene != this)
+			return BLAZE_ERROR_RESULT("BlazeEngine", "Trying to remove a component from a entity that doesn't belong to this scene.");
+
+		if (!entity->HasComponent(typeData))
+			return BLAZE_WARNING_RESULT("BlazeEngine", "Trying to remove a component that the entity doesn't have.");
+
+		uint typeIndex = typeData.Index();
+		uint32 slot = entity->handle.index;
+		auto components = GetEntityComponents(slot);
+		auto componentTypes = GetEntityComponentTypes(slot);
+
+		Component* component = components[typeIndex];
+
+		systems[typeIndex]->Destroyed(component);
+		containers[typeIndex].Destroy(component);
+
+		uintMem orderIndex = 0;
+		while (componentTypes[orderIndex] != typeIndex)
+			++orderIndex;
+
+		for (uintMem i = orderIndex + 1; i < entity->componentCount; ++i)
+			componentTypes[i - 1] = componentTypes[i];
+
+		components[typeIndex] = nullptr;
+		GetEntityComponentMask(slot)[typeIndex / 64] &= ~((uint64)1 << (typeIndex % 64));
+		--entity->componentCount;
+
+		return Result();
+	}
+	void Scene::SetCommandBufferCount(uintMem count)
+	{
+		commandBuffers.Resize(count, &registry);
+	}
+	CommandBuffer& Scene::GetCommandBuffer(uintMem index)
+	{
+		if (index >= commandBuffers.Count())
+			Debug::Logger::LogError("Blaze Engine", "Command buffer index out of range. Index value was: " + StringParsing::Convert(index));
+
+		return commandBuffers[index];
+	}
+	Result Scene::ApplyCommandBuffers()
+	{
+		Result result;
+
+		for (auto& commandBuffer : commandBuffers)
+		{
+			//Commands recorded while applying (for example from System::Created) go into the emptied buffer
+			CommandBuffer recorded = std::move(commandBuffer);
+			commandBuffer.Clear();
+
+			result += ApplyCommandBuffer(recorded);
+		}
+
+		return result;
+	}
 	Result Scene::UpdateSystem(const ComponentTypeData& typeData)
 	{
 		return UpdateSystem(typeData.Index());
@@ -145,11 +398,185 @@ namespace Blaze::ECS
 	{
 		return containers[typeData.Index()];
 	}
+	uint32 Scene::AdvanceChangeVersion()
+	{
+		return changeVersion++;
+	}
 	ArrayView<Entity*> Scene::GetEntities() const
 	{
 		return ArrayView<Entity*>(entities.Ptr(), entities.Count());
 	}
+	Entity* Scene::GetEntity(EntityHandle handle) const
+	{
+		if (!IsValid(handle))
+			return nullptr;
 
+		return GetEntityInSlot(handle.index);
+	}
+	bool Scene::IsValid(EntityHandle handle) const
+	{
+		return handle.index < entityGenerations.Count() && entityGenerations[handle.index] == handle.generation;
+	}
+
+	Entity* Scene::AllocateEntity(ArrayView<const ComponentTypeData*> typesData)
+	{
+		uint32 slot;
+		uintMem typeCount = containers.Count();
+
+		if (freeEntitySlots.Empty())
+		{
+			slot = (uint32)entityGenerations.Count();
+
+			if (slot % entityBucketElementCount == 0)
+				entityBuckets.AddBack((Entity*)Memory::Allocate(sizeof(Entity) * entityBucketElementCount));
+
+			entityGenerations.AddBack(0);
+			entityComponents.Resize(entityComponents.Count() + typeCount, nullptr);
+			entityComponentTypes.Resize(entityComponentTypes.Count() + typeCount, 0);
+			entityComponentMasks.Resize(entityComponentMasks.Count() + componentMaskSize, 0);
+		}
+		else
+		{
+			slot = freeEntitySlots.Last();
+			freeEntitySlots.EraseLast();
+		}
+
+		Entity* entity = GetEntityInSlot(slot);
+		std::construct_at(entity);
+		entity->handle.index = slot;
+		entity->handle.generation = entityGenerations[slot];
+		entity->arrayIndex = entities.Count();
+		entities.AddBack(entity);
+
+		auto componentTypes = GetEntityComponentTypes(slot);
+		auto componentMask = GetEntityComponentMask(slot);
+
+		for (uintMem i = 0; i < typesData.Count(); ++i)
+		{
+			uint typeIndex = typesData[i]->Index();
+			componentTypes[i] = (uint16)typeIndex;
+			componentMask[typeIndex / 64] |= (uint64)1 << (typeIndex % 64);
+		}
+
+		return entity;
+	}
+	void Scene::FreeEntity(Entity* entity)
+	{
+		uint32 slot = entity->handle.index;
+		auto components = GetEntityComponents(slot);
+		auto componentTypes = GetEntityComponentTypes(slot);
+		auto componentMask = GetEntityComponentMask(slot);
+
+		for (uintMem i = 0; i < entity->componentCount; ++i)
+			components[componentTypes[i]] = nullptr;
+
+		for (uintMem i = 0; i < componentMaskSize; ++i)
+			componentMask[i] = 0;
+
+		//Wraps before reaching the bit that marks provisional handles
+		entityGenerations[slot] = (entityGenerations[slot] + 1) & ~EntityHandle::ProvisionalBit;
+		freeEntitySlots.AddBack(slot);
+
+		std::destroy_at(entity);
+	}
+
+
+	Result Scene::ApplyCommandBuffer(const CommandBuffer& commandBuffer)
+	{
+		using CommandType = CommandBuffer::CommandType;
+
+		Result result;
+		auto& commands = commandBuffer.commands;
+
+		auto GetTypesData = [&](const CommandBuffer::Command& command) {
+			return ArrayView<const ComponentTypeData*>(commandBuffer.typesData.Ptr() + command.typesDataOffset, command.typesDataCount);
+			};
+
+		//Handles of the entities created so far, indexed by the provisional handles the buffer returned
+		Array<EntityHandle> createdHandles{ commandBuffer.createCount };
+
+		auto GetCommandEntity = [&](EntityHandle handle) -> Entity* {
+			if (!handle.IsProvisional())
+				return GetEntity(handle);
+
+			if (handle.generation != commandBuffer.provisionalGeneration || handle.index >= createdHandles.Count())
+			{
+				result += BLAZE_ERROR_RESULT("Blaze Engine", "Command uses a provisional entity handle of another command buffer or of an earlier recording, the command is ignored");
+				return nullptr;
+			}
+
+			return GetEntity(createdHandles[handle.index]);
+			};
+
+		uintMem i = 0;
+		while (i < commands.Count())
+		{
+			auto& command = commands[i];
+			auto typesData = GetTypesData(command);
+
+			switch (command.type)
+			{
+			case CommandType::Create: {
+				uintMem end = i + 1;
+				while (end < commands.Count() && commands[end].type == CommandType::Create)
+				{
+					auto otherTypesData = GetTypesData(commands[end]);
+
+					if (otherTypesData.Count() != typesData.Count() || !std::equal(typesData.Ptr(), typesData.Ptr() + typesData.Count(), otherTypesData.Ptr()))
+						break;
+
+					++end;
+				}
+
+				//Handles are kept instead of pointers, later commands may destroy the entities
+				if (end - i == 1)
+				{
+					Entity* entity = Create(typesData);
+					createdHandles[command.handle.index] = entity->handle;
+				}
+				else
+				{
+					auto created = CreateMany(end - i, typesData);
+
+					for (uintMem j = 0; j < created.Count(); ++j)
+						createdHandles[commands[i + j].handle.index] = created[j]->handle;
+				}
+
+				i = end;
+				break;
+			}
+			case CommandType::Destroy: {
+				Array<Entity*> toDestroy;
+
+				while (i < commands.Count() && commands[i].type == CommandType::Destroy)
+				{
+					if (Entity* entity = GetCommandEntity(commands[i].handle))
+						toDestroy.AddBack(entity);
+
+					++i;
+				}
+
+				result += DestroyMany(toDestroy);
+				break;
+			}
+			case CommandType::AddComponent:
+				if (Entity* entity = GetCommandEntity(command.handle))
+					result += AddComponent(entity, *typesData[0]);
+				++i;
+				break;
+			case CommandType::RemoveComponent:
+				if (Entity* entity = GetCommandEntity(command.handle))
+					result += RemoveComponent(entity, *typesData[0]);
+				++i;
+				break;
+			default:
+				++i;
+				break;
+			}
+		}
+
+		return result;
+	}
 
 	Entity* Scene::CreateEntity(ArrayView<const ComponentTypeData*> typesData)
 	{		
@@ -158,49 +585,39 @@ namespace Blaze::ECS
 		currentEntityCreationData->typesData = typesData;
 		currentEntityCreationData->systems = systems.Ptr();
 
-		Entity* entity = (Entity*)Memory::Allocate(sizeof(Entity) + (sizeof(Component*) + sizeof(ComponentTypeData*)) * typesData.Count());		
-		std::construct_at(entity);
-		entity->arrayIndex = entities.Count();
-		entities.AddBack(entity);			
+		Entity* entity = AllocateEntity(typesData);
 
-		currentEntityCreationData->currentTypeData = GetEntityComponentsTypeData(entity);
+		currentEntityCreationData->currentTypeData = typesData.Ptr();
 		currentEntityCreationData->currentEntity = entity;		
 
-		auto componentData = GetEntityComponentsTypeData(entity);
-
-		for (uintMem i = 0; i < typesData.Count(); ++i)
-		{			
-			componentData[i] = typesData[i];
-		}
-
 		return entity;
 	}
-	ECS::Component** Scene::AllocateComponents()
+	void Scene::AllocateComponents()
 	{		
 		auto typesData = currentEntityCreationData->typesData;
-		auto components = GetEntityComponents(currentEntityCreationData->currentEntity);
+		auto components = GetEntityComponents(currentEntityCreationData->currentEntity->handle.index);
 
 		for (uintMem i = 0; i < typesData.Count(); ++i)
-			components[i] = containers[typesData[i]->Index()].Allocate();		
-
-		return components;
+		{
+			uint typeIndex = typesData[i]->Index();
+			components[typeIndex] = containers[typeIndex].Allocate();
+		}
 	}
 	Component* Scene::GetCurrentComponent()
 	{
 		auto entity = currentEntityCreationData->currentEntity;
-		auto componentsTypeData = GetEntityComponentsTypeData(entity);
-		auto components = GetEntityComponents(entity);
-		return components[currentEntityCreationData->currentTypeData - componentsTypeData];
+		auto components = GetEntityComponents(entity->handle.index);
+		return components[(*currentEntityCreationData->currentTypeData)->Index()];
 	}
 	void Scene::FinishEntityCreation()
 	{		
 		auto entity = currentEntityCreationData->currentEntity;
-		auto componentsTypeData = GetEntityComponentsTypeData(currentEntityCreationData->currentEntity);
-		auto components = GetEntityComponents(currentEntityCreationData->currentEntity);
+		auto componentTypes = GetEntityComponentTypes(entity->handle.index);
+		auto components = GetEntityComponents(entity->handle.index);
 
 		uintMem componentCount = entity->componentCount;
 		for (uintMem i = 0; i < componentCount; ++i)
-			systems[componentsTypeData[i]->Index()]->Created(components[i]);
+			systems[componentTypes[i]]->Created(components[componentTypes[i]]);
 		
 		entityCreationData.EraseFirst();		
 
@@ -0,0 +1,416 @@
+#include "pch.h"
+#include "BlazeEngine/Application/ECS/Scene.h"
+
+#include "EntityCreationData.h"
+
+namespace Blaze::ECS
+{
+	/*
+		Scene file layout:
+			SceneFileHeader
+			SceneFileType[typeCount], each followed by the type name
+			for every entity: uint32 component count followed by that many uint32 type indices
+			for every type: uint64 component count followed by the component data in entity order. Raw components are
+			stored as their memory with the ECS::Component base zeroed, so the file holds no pointers, the base is
+			filled in when loading. Components with serialize functions are stored as a uint64 byte count followed by
+			the data written by Serialize, other components don't store any data
+	*/
+	static constexpr uint32 sceneFileMagic = 0x535A4C42; //"BLZS"
+	static constexpr uint32 sceneFileVersion = 1;
+
+	struct SceneFileHeader
+	{
+		uint32 magic;
+		uint32 version;
+		uint32 typeCount;
+		uint32 reserved;
+		uint64 entityCount;
+	};
+
+	enum class SceneFileTypeFlags : uint32
+	{
+		None = 0,
+		Raw = 1,
+		SerializeFunctions = 2,
+	};
+
+	struct SceneFileType
+	{
+		uint32 nameSize;
+		uint32 flags;
+		uint64 size;
+	};
+
+	template<typename T>
+	static bool WriteValue(WriteStream& stream, const T& value)
+	{
+		return stream.Write(&value, sizeof(T)) == sizeof(T);
+	}
+	template<typename T>
+	static bool WriteValue(BufferedWriteStream& stream, const T& value)
+	{
+		return stream.WriteValue(value);
+	}
+	template<typename T>
+	static bool ReadValue(ContiguousReadStream& stream, T& value)
+	{
+		ArrayView<byte> data = stream.TryGetContiguous(sizeof(T));
+
+		if (data.Count() != sizeof(T))
+			return false;
+
+		memcpy(&value, data.Ptr(), sizeof(T));
+		return stream.Consume(sizeof(T));
+	}
+
+	Result Scene::Serialize(WriteStream& outputStream)
+	{
+		//Most of the writes are a few bytes each, buffering them avoids a call into the wrapped stream for each one
+		BufferedWriteStream stream{ outputStream };
+
+		auto types = registry.GetAllTypesData();
+
+		SceneFileHeader header{
+			.magic = sceneFileMagic,
+			.version = sceneFileVersion,
+			.typeCount = (uint32)types.Count(),
+			.reserved = 0,
+			.entityCount = entities.Count()
+		};
+
+		if (!WriteValue(stream, header))
+			return BLAZE_ERROR_RESULT("Blaze Engine", "Failed to write to the stream while serializing a scene");
+
+		for (auto& type : types)
+		{
+			uint32 flags = (uint32)SceneFileTypeFlags::None;
+
+			if (type.IsRawSerializable())
+				flags |= (uint32)SceneFileTypeFlags::Raw;
+			if (type.HasSerializeFunctions())
+				flags |= (uint32)SceneFileTypeFlags::SerializeFunctions;
+
+			SceneFileType fileType{
+				.nameSize = (uint32)type.GetTypeName().Count(),
+				.flags = flags,
+				.size = type.Size()
+			};
+
+			if (!WriteValue(stream, fileType) || stream.Write(type.GetTypeName().Ptr(), fileType.nameSize) != fileType.nameSize)
+				return BLAZE_ERROR_RESULT("Blaze Engine", "Failed to write to the stream while serializing a scene");
+		}
+
+		Array<Array<Component*>> typeComponents(types.Count());
+
+		for (auto entity : entities)
+		{
+			auto componentTypes = GetEntityComponentTypes(entity->handle.index);
+			auto components = GetEntityComponents(entity->handle.index);
+			uint32 componentCount = (uint32)entity->componentCount;
+
+			if (!WriteValue(stream, componentCount))
+				return BLAZE_ERROR_RESULT("Blaze Engine", "Failed to write to the stream while serializing a scene");
+
+			for (uintMem i = 0; i < componentCount; ++i)
+			{
+				uint32 typeIndex = componentTypes[i];
+
+				if (!WriteValue(stream, typeIndex))
+					return BLAZE_ERROR_RESULT("Blaze Engine", "Failed to write to the stream while serializing a scene");
+
+				typeComponents[typeIndex].AddBack(components[typeIndex]);
+			}
+		}
+
+		Result result;
+		//Serialized components are written here first so their byte count can be written before them without seeking
+		BufferWriteStream componentStream;
+		//Raw components are copied here to clear the pointers in their base
+		Array<byte> rawComponent;
+
+		for (uintMem i = 0; i < types.Count(); ++i)
+		{
+			auto& type = types[i];
+			uint64 componentCount = typeComponents[i].Count();
+
+			if (!WriteValue(stream, componentCount))
+				return BLAZE_ERROR_RESULT("Blaze Engine", "Failed to write to the stream while serializing a scene");
+
+			if (type.IsRawSerializable())
+			{
+				rawComponent.Resize(type.Size());
+
+				for (auto component : typeComponents[i])
+				{
+					memcpy(rawComponent.Ptr(), (byte*)component - type.BaseOffset(), type.Size());
+					memset(rawComponent.Ptr() + type.BaseOffset(), 0, sizeof(Component));
+
+					if (stream.Write(rawComponent.Ptr(), type.Size()) != type.Size())
+						return BLAZE_ERROR_RESULT("Blaze Engine", "Failed to write to the stream while serializing a scene");
+				}
+			}
+			else if (type.HasSerializeFunctions())
+			{
+				for (auto component : typeComponents[i])
+				{
+					//The byte count lets loading skip over the component
+					componentStream.SetPosition(0);
+					result += type.Serialize(component, componentStream);
+					uint64 byteCount = componentStream.GetPosition();
+
+					if (!WriteValue(stream, byteCount) || stream.Write(componentStream.GetBuffer(), byteCount) != byteCount)
+						return BLAZE_ERROR_RESULT("Blaze Engine", "Failed to write to the stream while serializing a scene");
+				}
+			}
+		}
+
+		if (!stream.Flush())
+			return BLAZE_ERROR_RESULT("Blaze Engine", "Failed to write to the stream while serializing a scene");
+
+		return result;
+	}
+	Result Scene::Deserialize(ReadStream& stream)
+	{
+		//Streams that already have all of the data in memory are parsed in place, others are read through a buffer
+		if (auto contiguousStream = dynamic_cast<ContiguousReadStream*>(&stream))
+		{
+			uintMem remaining = stream.GetSize() - stream.GetPosition();
+
+			if (contiguousStream->TryGetContiguous(remaining).Count() == remaining)
+				return DeserializeContiguous(*contiguousStream);
+		}
+
+		BufferedReadStream bufferedStream{ stream };
+		Result result = DeserializeContiguous(bufferedStream);
+
+		//Leave the wrapped stream right after the scene data instead of after whatever was read ahead
+		stream.SetPosition(bufferedStream.GetPosition());
+
+		return result;
+	}
+	Result Scene::Deserialize(const void* data, uintMem size)
+	{
+		BufferReadStream stream{ data, size };
+		return DeserializeContiguous(stream);
+	}
+	Result Scene::DeserializeContiguous(ContiguousReadStream& stream)
+	{
+		SceneFileHeader header;
+
+		if (!ReadValue(stream, header) || header.magic != sceneFileMagic)
+			return BLAZE_ERROR_RESULT("Blaze Engine", "Trying to deserialize a scene from invalid data");
+
+		if (header.version != sceneFileVersion)
+			return BLAZE_ERROR_RESULT("Blaze Engine", "Unsupported scene file version: " + StringParsing::Convert(header.version));
+
+		//The counts size allocations, a damaged file must not make them bigger than the data could describe
+		if (header.typeCount > (stream.GetSize() - stream.GetPosition()) / sizeof(SceneFileType))
+			return BLAZE_ERROR_RESULT("Blaze Engine", "Invalid component type count while deserializing a scene");
+
+		//Types are matched by name to the types in the registry of this scene
+		Array<const ComponentTypeData*> fileTypes(header.typeCount);
+
+		for (uint32 i = 0; i < header.typeCount; ++i)
+		{
+			SceneFileType fileType;
+
+			if (!ReadValue(stream, fileType))
+				return BLAZE_ERROR_RESULT("Blaze Engine", "Unexpected end of data while deserializing a scene");
+
+			//The name is used in place, consuming it doesn't invalidate the view
+			ArrayView<byte> name = stream.TryGetContiguous(fileType.nameSize);
+
+			if (name.Count() != fileType.nameSize || !stream.Consume(fileType.nameSize))
+				return BLAZE_ERROR_RESULT("Blaze Engine", "Unexpected end of data while deserializing a scene");
+
+			StringView typeName{ (const char*)name.Ptr(), name.Count() };
+
+			if (!registry.GetComponentTypeData(typeName, fileTypes[i]))
+				return BLAZE_ERROR_RESULT("Blaze Engine", "Serialized component type \"" + (String)typeName + "\" is not in the registry");
+
+			//Components are assigned to file types by their registry type, a type listed twice would get none
+			for (uint32 j = 0; j < i; ++j)
+				if (fileTypes[j] == fileTypes[i])
+					return BLAZE_ERROR_RESULT("Blaze Engine", "Serialized component type \"" + (String)typeName + "\" is listed more than once");
+
+			bool raw = fileType.flags & (uint32)SceneFileTypeFlags::Raw;
+			bool serializeFunctions = fileType.flags & (uint32)SceneFileTypeFlags::SerializeFunctions;
+
+			if (raw != fileTypes[i]->IsRawSerializable() || (raw && fileType.size != fileTypes[i]->Size()) ||
+				(!raw && serializeFunctions != fileTypes[i]->HasSerializeFunctions()))
+				return BLAZE_ERROR_RESULT("Blaze Engine", "Serialized component type \"" + (String)typeName + "\" doesn't match the type in the registry");
+		}
+
+		//Every entity stores at least its component count
+		if (header.entityCount > (stream.GetSize() - stream.GetPosition()) / sizeof(uint32))
+			return BLAZE_ERROR_RESULT("Blaze Engine", "Invalid entity count while deserializing a scene");
+
+		Array<uint32> entityComponentCounts((uintMem)header.entityCount);
+		Array<const ComponentTypeData*> entityTypesData;
+		Array<uintMem> typeComponentCounts(header.typeCount, 0);
+
+		for (uintMem i = 0; i < header.entityCount; ++i)
+		{
+			uint32 componentCount;
+
+			if (!ReadValue(stream, componentCount))
+				return BLAZE_ERROR_RESULT("Blaze Engine", "Unexpected end of data while deserializing a scene");
+
+			entityComponentCounts[i] = componentCount;
+			uintMem first = entityTypesData.Count();
+
+			for (uint32 j = 0; j < componentCount; ++j)
+			{
+				uint32 typeIndex;
+
+				if (!ReadValue(stream, typeIndex))
+					return BLAZE_ERROR_RESULT("Blaze Engine", "Unexpected end of data while deserializing a scene");
+
+				if (typeIndex >= header.typeCount)
+					return BLAZE_ERROR_RESULT("Blaze Engine", "Invalid component type index while deserializing a scene");
+
+				for (uintMem k = first; k < entityTypesData.Count(); ++k)
+					if (entityTypesData[k] == fileTypes[typeIndex])
+						return BLAZE_ERROR_RESULT("Blaze Engine", "Entity with duplicate components while deserializing a scene");
+
+				entityTypesData.AddBack(fileTypes[typeIndex]);
+				++typeComponentCounts[typeIndex];
+			}
+		}
+
+		//Everything that could be invalid was checked, entities are created now
+		currentEntityCreationData = &*entityCreationData.AddFront();
+		currentEntityCreationData->scene = this;
+		currentEntityCreationData->systems = systems.Ptr();
+
+		Array<Entity*> createdEntities((uintMem)header.entityCount);
+		entities.ReserveAdditional(header.entityCount);
+
+		for (uintMem i = 0, offset = 0; i < header.entityCount; offset += entityComponentCounts[i], ++i)
+		{
+			ArrayView<const ComponentTypeData*> typesData{ entityTypesData.Ptr() + offset, entityComponentCounts[i] };
+			currentEntityCreationData->typesData = typesData;
+			createdEntities[i] = AllocateEntity(typesData);
+		}
+
+		Array<Array<Component*>> typeComponents(header.typeCount);
+		Array<Array<Entity*>> typeEntities(header.typeCount);
+
+		for (uint32 i = 0; i < header.typeCount; ++i)
+		{
+			uint typeIndex = fileTypes[i]->Index();
+
+			typeComponents[i].Resize(typeComponentCounts[i]);
+			typeEntities[i].ReserveExactly(typeComponentCounts[i]);
+			containers[typeIndex].AllocateMany(typeComponents[i].Ptr(), typeComponentCounts[i]);
+		}
+
+		for (auto entity : createdEntities)
+		{
+			auto componentTypes = GetEntityComponentTypes(entity->handle.index);
+			auto components = GetEntityComponents(entity->handle.index);
+
+			for (uintMem i = 0; i < entity->componentCount; ++i)
+			{
+				uint32 fileTypeIndex = 0;
+				while (fileTypes[fileTypeIndex]->Index() != componentTypes[i])
+					++fileTypeIndex;
+
+				auto& entitiesOfType = typeEntities[fileTypeIndex];
+				components[componentTypes[i]] = typeComponents[fileTypeIndex][entitiesOfType.Count()];
+				entitiesOfType.AddBack(entity);
+			}
+		}
+
+		Result result;
+		bool readFailed = false;
+
+		for (uint32 i = 0; i < header.typeCount; ++i)
+		{
+			const ComponentTypeData& typeData = *fileTypes[i];
+			System* system = systems[typeData.Index()];
+			auto& components = typeComponents[i];
+			auto& componentEntities = typeEntities[i];
+
+			uint64 componentCount = 0;
+
+			if (!readFailed && (!ReadValue(stream, componentCount) || componentCount != components.Count()))
+			{
+				result += BLAZE_ERROR_LOG("Blaze Engine", "Invalid component data while deserializing a scene, the remaining components are default constructed");
+				readFailed = true;
+			}
+
+			for (uintMem j = 0; j < components.Count(); ++j)
+			{
+				Component* component = components[j];
+
+				if (typeData.IsRawSerializable() && !readFailed)
+				{
+					void* raw = (byte*)component - typeData.BaseOffset();
+
+					ArrayView<byte> rawData = stream.TryGetContiguous(typeData.Size());
+
+					//Components bigger than the buffer of a buffered stream aren't available in place
+					if (rawData.Count() == typeData.Size())
+					{
+						memcpy(raw, rawData.Ptr(), typeData.Size());
+						stream.Consume(typeData.Size());
+					}
+					else if (stream.Read(raw, typeData.Size()) != typeData.Size())
+					{
+						result += BLAZE_ERROR_LOG("Blaze Engine", "Unexpected end of data while deserializing a scene, the remaining components are default constructed");
+						readFailed = true;
+					}
+
+					if (!readFailed)
+					{
+						component->Attach(componentEntities[j], system, typeData, changeVersion);
+						continue;
+					}
+				}
+
+				currentEntityCreationData->currentEntity = componentEntities[j];
+				currentEntityCreationData->currentTypeData = fileTypes.Ptr() + i;
+				typeData.Construct(component);
+
+				if (typeData.HasSerializeFunctions() && !readFailed)
+				{
+					uint64 byteCount;
+
+					if (!ReadValue(stream, byteCount))
+					{
+						result += BLAZE_ERROR_LOG("Blaze Engine", "Unexpected end of data while deserializing a scene, the remaining components are default constructed");
+						readFailed = true;
+						continue;
+					}
+
+					uintMem begin = stream.GetPosition();
+					result += typeData.Deserialize(component, stream);
+
+					if (!stream.SetPosition(begin + byteCount))
+					{
+						result += BLAZE_ERROR_LOG("Blaze Engine", "Unexpected end of data while deserializing a scene, the remaining components are default constructed");
+						readFailed = true;
+					}
+				}
+			}
+		}
+
+		for (uint32 i = 0; i < header.typeCount; ++i)
+		{
+			System* system = systems[fileTypes[i]->Index()];
+
+			for (auto component : typeComponents[i])
+				system->Created(component);
+		}
+
+		entityCreationData.EraseFirst();
+
+		if (entityCreationData.Empty())
+			currentEntityCreationData = nullptr;
+		else
+			currentEntityCreationData = &entityCreationData.First();
+
+		return result;
+	}
+}
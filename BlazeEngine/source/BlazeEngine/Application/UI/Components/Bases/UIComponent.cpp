@@ -11,7 +11,7 @@ namespace Blaze::UI
 		if (GetEntity() == nullptr)
 			return nullptr;
 		
-		auto element = GetEntity()->GetComponent<Components::UIElementComponent>();
+		auto element = GetEntity()->ModifyComponent<Components::UIElementComponent>();
 
 		if (element == nullptr)
 			return nullptr;
@@ -23,7 +23,7 @@ namespace Blaze::UI
 		if (GetEntity() == nullptr)
 			return nullptr;
 
-		auto transform = GetEntity()->GetComponent<Components::UITransformComponent>();
+		auto transform = GetEntity()->ModifyComponent<Components::UITransformComponent>();
 
 		if (transform == nullptr)
 			return nullptr;
@@ -35,10 +35,10 @@ namespace Blaze::UI::Components
 			switch (label.sizeControl)
 			{
 			case Blaze::UI::Components::LabelSizeControl::WidthControlsHeight:
-				label.transform->size.y = label.transform->size.x * ratio;
+				label.transform->SetSize(Vec2f(label.transform->GetSize().x, label.transform->GetSize().x * ratio));
 				break;
 			case Blaze::UI::Components::LabelSizeControl::HeightControlsWidth:
-				label.transform->size.x = label.transform->size.y * ratio;
+				label.transform->SetSize(Vec2f(label.transform->GetSize().y * ratio, label.transform->GetSize().y));
 				break;
 			case Blaze::UI::Components::LabelSizeControl::CustomSize:
 				break;
@@ -73,12 +73,14 @@ namespace Blaze::UI::Components
 	{
 		this->fontResolution = fontResolution;				
 		state = TRANSFORM_DIRTY | RENDER_DIRTY;
+		transform->MarkChanged();
 	}
 
 	void Label::SetText(StringViewUTF8 text)
 	{
 		this->text = text;
 		state = TRANSFORM_DIRTY | RENDER_DIRTY;
+		transform->MarkChanged();
 	}
 
 	void Label::SetColors(ArrayView<ColorRGBAf> colors)
@@ -95,6 +97,7 @@ namespace Blaze::UI::Components
 	{
 		sizeControl = control;
 		state = TRANSFORM_DIRTY;
+		transform->MarkChanged();
 	}
 	void Label::Setup(StringViewUTF8 text, ArrayView<ColorRGBAf> colors, LabelSizeControl sizeControl, FontResolution* fontResolution)
 	{
@@ -103,6 +106,7 @@ namespace Blaze::UI::Components
 		this->fontResolution = fontResolution;
 		this->sizeControl = sizeControl;
 		this->state = TRANSFORM_DIRTY | RENDER_DIRTY;
+		transform->MarkChanged();
 	}				
 }
 
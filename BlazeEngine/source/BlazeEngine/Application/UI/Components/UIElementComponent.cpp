@@ -12,6 +12,11 @@ namespace Blaze::UI::Components
 		layerIt(), layerElementIt(),
 		name()
 	{	
+		//The transform is constructed first, so it can't find the element itself
+		if (GetEntity() != nullptr)
+			if (UITransformComponent* transform = GetEntity()->ModifyComponent<UITransformComponent>(); transform != nullptr)
+				transform->elementComponent = this;
+
 		if (currentUIElementCreationData->scene != nullptr)
 		{			
 			scene = currentUIElementCreationData->scene;
@@ -7,11 +7,12 @@
 namespace Blaze::UI::Components
 {	
 	UITransformComponent::UITransformComponent()
-		: updateState(0), posOverrideComponent(nullptr), sizeOverrideComponent(nullptr), finalSize(0, 0), finalPos(0, 0),
+		: updateState(0), dirtyState(0), posOverrideComponent(nullptr), sizeOverrideComponent(nullptr), finalSize(0, 0), finalPos(0, 0),
 		pos(0, 0), size(100, 100), scale(1), rotation(0),		
 		pivot(0.5, 0.5), anchorPivot(0.5, 0.5), anchor(nullptr)		
 	{				
-		elementComponent = GetEntity()->GetComponent<UIElementComponent>();
+		//Set by the element component, it is constructed after the transform
+		elementComponent = nullptr;
 
 		for (uint i = 2; i < GetEntity()->GetComponentCount(); ++i)
 		{
@@ -25,7 +26,7 @@ namespace Blaze::UI::Components
 	}
 
 	UITransformComponent::UITransformComponent(const UITransformComponent& other)
-		: updateState(0), posOverrideComponent(nullptr), sizeOverrideComponent(nullptr), finalSize(0, 0), finalPos(0, 0),
+		: updateState(0), dirtyState(0), posOverrideComponent(nullptr), sizeOverrideComponent(nullptr), finalSize(0, 0), finalPos(0, 0),
 		pos(other.pos), size(other.size), scale(other.scale), rotation(other.rotation),		
 		pivot(other.pivot), anchorPivot(other.anchorPivot), anchor(nullptr)
 	{				
@@ -33,7 +34,7 @@ namespace Blaze::UI::Components
 	}	
 
 	UITransformComponent::UITransformComponent(const UITransformData& other)
-		: updateState(0), posOverrideComponent(nullptr), sizeOverrideComponent(nullptr), finalSize(0, 0), finalPos(0, 0),
+		: updateState(0), dirtyState(0), posOverrideComponent(nullptr), sizeOverrideComponent(nullptr), finalSize(0, 0), finalPos(0, 0),
 		pos(other.pos), size(other.size), scale(other.scale), rotation(other.rotation),		
 		pivot(other.pivot), anchorPivot(other.anchorPivot), anchor(nullptr)
 	{	
@@ -46,6 +47,7 @@ namespace Blaze::UI::Components
 		{
 			child->anchor = nullptr;
 			child->childIterator = DualList<UITransformComponent*>::Iterator();
+			child->MarkChanged();
 		}		
 	}
 	Vec2f UITransformComponent::ToLocalCoordinates(Vec2f point) const
@@ -78,8 +80,41 @@ namespace Blaze::UI::Components
 			anchor->children.AddFront(this);
 			childIterator = anchor->children.FirstIterator();
 		}		
+
+		MarkChanged();
 	}	
 
+	void UITransformComponent::SetPos(Vec2f pos)
+	{
+		this->pos = pos;
+		MarkChanged();
+	}
+	void UITransformComponent::SetSize(Vec2f size)
+	{
+		this->size = size;
+		MarkChanged();
+	}
+	void UITransformComponent::SetScale(float scale)
+	{
+		this->scale = scale;
+		MarkChanged();
+	}
+	void UITransformComponent::SetRotation(float rotation)
+	{
+		this->rotation = rotation;
+		MarkChanged();
+	}
+	void UITransformComponent::SetPivot(Vec2f pivot)
+	{
+		this->pivot = pivot;
+		MarkChanged();
+	}
+	void UITransformComponent::SetAnchorPivot(Vec2f anchorPivot)
+	{
+		this->anchorPivot = anchorPivot;
+		MarkChanged();
+	}
+
 	void UITransformComponent::Setup(const UITransformData& other)
 	{
 		this->pos = other.pos;
@@ -89,6 +124,7 @@ namespace Blaze::UI::Components
 		this->pivot = other.pivot;
 		this->anchorPivot = other.anchorPivot;
 		SetAnchor(other.anchor);		
+		MarkChanged();
 	}
 
 	UITransformComponent& UITransformComponent::operator=(const UITransformComponent& other)
@@ -100,6 +136,7 @@ namespace Blaze::UI::Components
 		this->pivot = other.pivot;
 		this->anchorPivot = other.anchorPivot;
 		SetAnchor(other.anchor);		
+		MarkChanged();
 		return *this;
 	}
 }
\ No newline at end of file
@@ -34,7 +34,7 @@ namespace Blaze::UI
 	}
 
 	UIScene::UIScene()
-		: ecsScene(nullptr), focusedElement(nullptr), blockingElement(nullptr), updateState(0)
+		: ecsScene(nullptr), focusedElement(nullptr), blockingElement(nullptr), updateState(0), lastChangeVersion(0), dirtyState(0)
 	{
 	}
 
@@ -237,17 +237,34 @@ namespace Blaze::UI
 	{
 		Result result;
 
-		updateState++;
+		uint32 changeVersion = ecsScene->AdvanceChangeVersion();
+
+		dirtyState++;
+		dirtyTransforms.Clear();
 
+		ecsScene->ForEach<ECS::Changed<Components::UITransformComponent>>(lastChangeVersion, [&](Components::UITransformComponent* transform) {
+			if (transform->elementComponent->scene == this)
+				MarkDirty(transform);
+			});
+
+		//Override components compute the size or position from inputs that aren't tracked, like the contents of
+		//other elements, so their transforms are resolved every update
 		for (auto& layer : layers)
 			for (auto el : layer.elements)
-				result += ResolveSize(el.transform);
+				if (el.transform->sizeOverrideComponent != nullptr || el.transform->posOverrideComponent != nullptr)
+					MarkDirty(el.transform);
+
+		lastChangeVersion = changeVersion;
 
 		updateState++;
 
-		for (auto& layer : layers)
-			for (auto el : layer.elements)
-				result += ResolvePosition(el.transform);
+		for (auto transform : dirtyTransforms)
+			result += ResolveSize(transform);
+
+		updateState++;
+
+		for (auto transform : dirtyTransforms)
+			result += ResolvePosition(transform);
 
 		return result;
 	}
@@ -390,6 +407,9 @@ namespace Blaze::UI
 		blockingElement = nullptr;
 
 		updateState = 0;
+		lastChangeVersion = 0;
+		dirtyState = 0;
+		dirtyTransforms.Clear();
 	}
 
 	bool UIScene::TakeFocus(Components::UIElementComponent* element)
@@ -501,6 +521,17 @@ namespace Blaze::UI
 		return Result();
 	}
 
+	void UIScene::MarkDirty(Components::UITransformComponent* transform)
+	{
+		if (transform->dirtyState == dirtyState)
+			return;
+
+		transform->dirtyState = dirtyState;
+		dirtyTransforms.AddBack(transform);
+
+		for (auto child : transform->children)
+			MarkDirty(child);
+	}
 	Result UIScene::ResolveSize(Components::UITransformComponent* transform)
 	{
 		if (transform->updateState == updateState)
@@ -512,7 +543,7 @@ namespace Blaze::UI
 			system->PreTransform(this, (UIComponent*)comp);
 		}
 
-		if (transform->anchor != nullptr)
+		if (transform->anchor != nullptr && transform->anchor->dirtyState == dirtyState)
 			ResolveSize(transform->anchor);
 
 		float anchorScale = transform->anchor != nullptr ?
@@ -548,7 +579,7 @@ namespace Blaze::UI
 		if (transform->updateState == updateState)
 			return Result();
 
-		if (transform->anchor != nullptr)
+		if (transform->anchor != nullptr && transform->anchor->dirtyState == dirtyState)
 			ResolvePosition(transform->anchor);
 
 		if (transform->posOverrideComponent == nullptr)
@@ -26,7 +26,8 @@ namespace Blaze
 	void TerminateLibraries();
 
 	TimingResult InitializeInput();
-	void TerminateInput(); 
+	void TerminateInput();
+	void FlushInputEventBatch(); 
 
 	TimingResult InitializeGraphics();
 	void TerminateGraphics();
@@ -141,10 +142,15 @@ BLAZE_API int main(int argc, char* argv[])
 		if (SDL_WaitEvent(&event) == 0)			
 			Blaze::Debug::Logger::LogError("SDL", "SDL_WaitEvent failed, SDL_GetError returned: \"" + GetSDLError() + "\"");
 
+		//The events of this pump were merged by the event watcher and are published now
+		Blaze::FlushInputEventBatch();
 		Blaze::globalData->CheckForMainThreadTask();
 	}
 
 	while (clientThread.IsRunning());
 
+	//Tasks posted right before the client thread exited, like destroying its windows
+	Blaze::globalData->CheckForMainThreadTask();
+
 	TerminateBlaze();
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "pch.h"
 #include "BlazeEngine/Input/Input.h"
 #include "BlazeEngine/Internal/GlobalData.h"
+#include "BlazeEngine/Internal/KeyTables.h"
 #include "BlazeEngine/Window/WindowSDL.h"
 #include "SDL2/SDL_events.h"
 
@@ -9,6 +10,43 @@ namespace Blaze
 	namespace Input
 	{
 		int SDLEventWatcher(void* data, SDL_Event* event);
+
+		/*
+			Events reported during one pump of the SDL event queue are merged before they are published to the
+			client thread. Consecutive mouse motion or scroll events of the same window are summed into one event,
+			any other event publishes the pending one first so the order of events is kept. Every thread that reports
+			events has its own batch, the main thread publishes its batch after each pump.
+
+			Resizes are published right away, because during a modal resize loop the pump doesn't return until the
+			drag ends. A resize replaces the previous one in the event stack if the client didn't get to it yet
+		*/
+		struct SDLEventBatch
+		{
+			enum class PendingType
+			{
+				None,
+				MouseMotion,
+				MouseScroll
+			};
+
+			PendingType pendingType = PendingType::None;
+			//The window is looked up again when publishing, it might have been destroyed in the meantime
+			uint32 pendingWindowID = 0;
+			Vec2i motionDelta;
+			int scrollValue = 0;
+			//The last resize event added to the event stack, see EventStack::AddOrReplace
+			uint64 resizeRecord = ~(uint64)0;
+
+			//Last window lookup, valid while the window lookup generation doesn't change
+			uint32 cachedWindowID = 0;
+			uint32 cachedWindowGeneration = 0;
+			WindowSDL* cachedWindow = nullptr;
+		};
+
+		static thread_local SDLEventBatch eventBatch;
+
+		static WindowSDL* GetWindowFromSDLID(uint32 windowID);
+		static void PublishPendingEvent();
 	}
 
 	TimingResult InitializeInput()
@@ -25,6 +63,10 @@ namespace Blaze
 			if (cursor != nullptr)
 				SDL_FreeCursor(cursor);
 	}
+	void FlushInputEventBatch()
+	{
+		Input::PublishPendingEvent();
+	}
 
 	namespace Input
 	{											
@@ -37,17 +79,20 @@ namespace Blaze
 		{			
 			globalData->inputEventSystem.inputPreUpdateDispatcher.Call({ });
 
+			//Before the events are dispatched, so handlers see the key states of this frame
+			globalData->keyStates.Update();
+			//Cleared before the events are dispatched, a resize added after this sets it again
+			globalData->windowSwappingSkipFlag.clear();
 			globalData->inputEventStack.ProcessAndClear();
 
 			globalData->inputEventSystem.inputPostUpdateDispatcher.Call({ });
 		}				
 		KeyState GetLastKeyState(Key key)
 		{
-			if ((uint)key > _countof(globalData->keyStates))
+			if ((uint)key >= (uint)Key::KeyCount)
 				return { };
 
-			std::lock_guard<std::mutex> lk{ globalData->keyStatesMutex };
-			return globalData->keyStates[(uint)key];
+			return globalData->keyStates.GetState(key);
 		}
 
 		void SetCursorType(CursorType type)
@@ -64,71 +109,70 @@ namespace Blaze
 		{
 			return (WindowSDL*)SDL_GetWindowData(window, "Blaze");
 		}
+		static WindowSDL* GetWindowFromSDLID(uint32 windowID)
+		{
+			uint32 generation = globalData->windowLookupGeneration.load(std::memory_order_acquire);
 
-		void KeyPressedEvent(Key key, WindowSDL* window)
+			if (windowID != eventBatch.cachedWindowID || generation != eventBatch.cachedWindowGeneration)
+			{
+				eventBatch.cachedWindow = GetWindowFromSDLHandle(SDL_GetWindowFromID(windowID));
+				eventBatch.cachedWindowID = windowID;
+				eventBatch.cachedWindowGeneration = generation;
+			}
+
+			return eventBatch.cachedWindow;
+		}
+		static void PublishPendingEvent()
 		{
-			if ((uint)key > _countof(globalData->keyStates))
+			if (eventBatch.pendingType == SDLEventBatch::PendingType::None)
 				return;
 
-			Events::KeyPressed _event;
+			WindowSDL* window = GetWindowFromSDLID(eventBatch.pendingWindowID);
 
+			switch (window != nullptr ? eventBatch.pendingType : SDLEventBatch::PendingType::None)
 			{
-				std::lock_guard<std::mutex> lk{ globalData->keyStatesMutex };
-				auto& state = globalData->keyStates[(uint)key];
+			case SDLEventBatch::PendingType::MouseMotion: {
+				Events::MouseMotion _event;
+				_event.delta = eventBatch.motionDelta;
 
-				double time = TimePoint::GetRunTime();
+				globalData->inputEventStack.TryAdd(_event, &window->mouseMotionDispatcher);
+				break;
+			}
+			case SDLEventBatch::PendingType::MouseScroll: {
+				Events::MouseScroll _event;
+				_event.value = eventBatch.scrollValue;
 
-				if (state.down)				
-					state.pressed = false;
-				else
-				{
-					state.pressed = true;
-					state.down = true;
-					state.up = false;
-					state.released = false;					
-				}
+				globalData->inputEventStack.Add(_event, &window->mouseScrollDispatcher);
+				break;
+			}
+			default:
+				break;
+			}
 
-				if (time - state.time <= globalData->keyComboTime)
-					++state.combo;
-				else
-					state.combo = 1;
+			eventBatch.pendingType = SDLEventBatch::PendingType::None;
+		}
 
-				state.time = time;
+		void KeyPressedEvent(Key key, WindowSDL* window)
+		{
+			if ((uint)key >= (uint)Key::KeyCount)
+				return;
 
-				_event.key = key;
-				_event.combo = state.combo;
-				_event.time = time;
-			}
+			Events::KeyPressed _event;
+			_event.key = key;
+			_event.time = TimePoint::GetRunTime();
+			globalData->keyStates.Press(key, _event.time, _event.combo);
 
 			if (window != nullptr)
 				globalData->inputEventStack.Add(_event, &window->keyPressedDispatcher);
 		}
 		void KeyReleasedEvent(Key key, WindowSDL* window)
 		{
-			if ((uint)key > _countof(globalData->keyStates))
+			if ((uint)key >= (uint)Key::KeyCount)
 				return;
 
 			Events::KeyReleased _event;
-
-			{
-				std::lock_guard<std::mutex> lk{ globalData->keyStatesMutex };
-				auto& state = globalData->keyStates[(uint)key];				
-				
-				if (state.up)
-				{
-					state.released = false;					
-				}
-				else
-				{
-					state.pressed = false;
-					state.down = false;
-					state.up = true;
-					state.released = true;					
-				}				
-
-				_event.key = key;				
-				_event.time = state.time;
-			}
+			_event.key = key;
+			_event.time = globalData->keyStates.Release(key);
 
 			if (window != nullptr)
 				globalData->inputEventStack.Add(_event, &window->keyReleasedDispatcher);
@@ -144,66 +188,118 @@ namespace Blaze
 				return 0;
 			}
 
+			//Motion and scroll events are merged into the pending event, everything else publishes it first
 			switch (event->type)
 			{
+			case SDL_WINDOWEVENT: {
+				//SDL follows every resize with a size change event, which isn't used, so it doesn't end the batch
+				if (event->window.event == SDL_WINDOWEVENT_SIZE_CHANGED)
+					return 0;
+
+				PublishPendingEvent();
+
+				if (event->window.event != SDL_WINDOWEVENT_RESIZED)
+					break;
+
+				//Buffers aren't swapped until the client handled the resize, see Input::Update
+				globalData->windowSwappingSkipFlag.test_and_set();
+
+				Events::WindowResizedEvent _event;
+				WindowSDL* window = GetWindowFromSDLID(event->window.windowID);
+				_event.window = window;
+				_event.size = Vec2u(event->window.data1, event->window.data2);
+
+				//Resizes reach the global dispatcher even without a window
+				globalData->inputEventStack.AddOrReplace(eventBatch.resizeRecord, _event, &globalData->inputEventSystem.windowResizedDispatcher, window != nullptr ? &window->resizedEventDispatcher : nullptr);
+
+				//if (globalData->windowSwappingWaitingMutex.try_lock())
+				//	globalData->windowSwappingWaitingMutex.unlock();
+				//else
+				//{
+				//	globalData->windowSwappingPossibleFlag.test_and_set();
+				//	globalData->windowSwappingPossibleFlag.notify_all();
+				//
+				//	globalData->windowSwappingPossibleFlag.wait(1);
+				//}
+
+				return 0;
+			}
 			case SDL_MOUSEWHEEL: {
-				Events::MouseScroll _event;
-				_event.value = event->wheel.y;
+				if (GetWindowFromSDLID(event->window.windowID) == nullptr)
+					break;
 
-				WindowSDL* window = GetWindowFromSDLHandle(SDL_GetWindowFromID(event->window.windowID));
+				if (eventBatch.pendingType != SDLEventBatch::PendingType::MouseScroll || eventBatch.pendingWindowID != event->window.windowID)
+				{
+					PublishPendingEvent();
 
-				if (window != nullptr)
-					globalData->inputEventStack.Add(_event, &window->mouseScrollDispatcher);
+					eventBatch.pendingType = SDLEventBatch::PendingType::MouseScroll;
+					eventBatch.pendingWindowID = event->window.windowID;
+					eventBatch.scrollValue = 0;
+				}
 
-				break;
+				eventBatch.scrollValue += event->wheel.y;
+				return 0;
 			}
 			case SDL_MOUSEMOTION: {
-				Events::MouseMotion  _event;
-				_event.delta = { event->motion.xrel, -event->motion.yrel };
+				if (GetWindowFromSDLID(event->window.windowID) == nullptr)
+					break;
 
-				WindowSDL* window = GetWindowFromSDLHandle(SDL_GetWindowFromID(event->window.windowID));
+				if (eventBatch.pendingType != SDLEventBatch::PendingType::MouseMotion || eventBatch.pendingWindowID != event->window.windowID)
+				{
+					PublishPendingEvent();
 
-				if (window != nullptr)
-					globalData->inputEventStack.Add(_event, &window->mouseMotionDispatcher);
+					eventBatch.pendingType = SDLEventBatch::PendingType::MouseMotion;
+					eventBatch.pendingWindowID = event->window.windowID;
+					eventBatch.motionDelta = Vec2i();
+				}
+
+				eventBatch.motionDelta += Vec2i(event->motion.xrel, -event->motion.yrel);
+				return 0;
+			}
+			default:
+				PublishPendingEvent();
 				break;
 			}
+
+			switch (event->type)
+			{
 			case SDL_MOUSEBUTTONDOWN: {				
 				Key key = (Key)(event->button.button - 1 + (uint8)Key::MouseLeft);
 
-				KeyPressedEvent(key, GetWindowFromSDLHandle(SDL_GetWindowFromID(event->window.windowID)));
+				KeyPressedEvent(key, GetWindowFromSDLID(event->window.windowID));
 
 				break;
 			}
 			case SDL_MOUSEBUTTONUP: {
 				Key key = (Key)(event->button.button - 1 + (uint8)Key::MouseLeft);
 
-				KeyReleasedEvent(key, GetWindowFromSDLHandle(SDL_GetWindowFromID(event->window.windowID)));
+				KeyReleasedEvent(key, GetWindowFromSDLID(event->window.windowID));
 
 				break;
 			}
 			case SDL_KEYDOWN: {
-				auto it = globalData->keymap.Find(event->key.keysym.scancode);
+				Key key = GetKeyFromScancode(event->key.keysym.scancode);
 
-				if (it.IsNull())
+				if (key == Key::Unknown)
 					break;
 
-				KeyPressedEvent(it->value, GetWindowFromSDLHandle(SDL_GetWindowFromID(event->window.windowID)));								
+				KeyPressedEvent(key, GetWindowFromSDLID(event->window.windowID));								
 				break;
 			}
 			case SDL_KEYUP: {
-				auto it = globalData->keymap.Find(event->key.keysym.scancode);
+				Key key = GetKeyFromScancode(event->key.keysym.scancode);
 
-				if (it.IsNull())
+				if (key == Key::Unknown)
 					break;
 
-				KeyReleasedEvent(it->value, GetWindowFromSDLHandle(SDL_GetWindowFromID(event->window.windowID)));				
+				KeyReleasedEvent(key, GetWindowFromSDLID(event->window.windowID));				
 				break;
 			}
 			case SDL_TEXTINPUT: {
 				Events::TextInput _event;
 				_event.input = StringUTF8((void*)event->text.text, strlen(event->text.text));
 
-				WindowSDL* window = GetWindowFromSDLHandle(SDL_GetWindowFromID(event->window.windowID));
+				WindowSDL* window = GetWindowFromSDLID(event->window.windowID);
 
 				if (window != nullptr)
 					globalData->inputEventStack.Add(_event, &window->textInputDispatcher);
@@ -213,116 +309,62 @@ namespace Blaze
 				switch (event->window.event) {
 				case SDL_WINDOWEVENT_MOVED: {
 					Events::WindowMovedEvent _event;
-					WindowSDL* window = GetWindowFromSDLHandle(SDL_GetWindowFromID(event->window.windowID));
+					WindowSDL* window = GetWindowFromSDLID(event->window.windowID);
 					_event.window = window;
 					_event.pos = Vec2i(event->window.data1, event->window.data2);
-					globalData->inputEventStack.Add(_event, &globalData->inputEventSystem.windowMovedDispatcher);
-
-					if (window != nullptr)
-						globalData->inputEventStack.Add(_event, &_event.window->movedEventDispatcher);
+					globalData->inputEventStack.Add(_event, &globalData->inputEventSystem.windowMovedDispatcher, window != nullptr ? &window->movedEventDispatcher : nullptr);
 					break;
 				}
 				case SDL_WINDOWEVENT_MINIMIZED: {
 					Events::WindowMinimizedEvent _event;
-					WindowSDL* window = GetWindowFromSDLHandle(SDL_GetWindowFromID(event->window.windowID));
+					WindowSDL* window = GetWindowFromSDLID(event->window.windowID);
 					_event.window = window;
-					globalData->inputEventStack.Add(_event, &globalData->inputEventSystem.windowMinimizedDispatcher);
-
-					if (window != nullptr)
-						globalData->inputEventStack.Add(_event, &_event.window->minimizedEventDispatcher);
+					globalData->inputEventStack.Add(_event, &globalData->inputEventSystem.windowMinimizedDispatcher, window != nullptr ? &window->minimizedEventDispatcher : nullptr);
 					break;
 				}
 				case SDL_WINDOWEVENT_MAXIMIZED: {
 					Events::WindowMaximizedEvent _event;
-					WindowSDL* window = GetWindowFromSDLHandle(SDL_GetWindowFromID(event->window.windowID));
+					WindowSDL* window = GetWindowFromSDLID(event->window.windowID);
 					_event.window = window;
-					globalData->inputEventStack.Add(_event, &globalData->inputEventSystem.windowMaximizedDispatcher);
-
-					if (window != nullptr)
-						globalData->inputEventStack.Add(_event, &_event.window->maximizedEventDispatcher);
+					globalData->inputEventStack.Add(_event, &globalData->inputEventSystem.windowMaximizedDispatcher, window != nullptr ? &window->maximizedEventDispatcher : nullptr);
 					break;
 				}											  
-				case SDL_WINDOWEVENT_RESIZED: {
-					globalData->windowSwappingSkipFlag.test_and_set();
-					
-					Input::Events::WindowResizedEvent _event;
-
-					WindowSDL* window = GetWindowFromSDLHandle(SDL_GetWindowFromID(event->window.windowID));
-					_event.window = window;
-					_event.size = Vec2u(event->window.data1, event->window.data2);
-
-					globalData->inputEventStack.Add(_event, &globalData->inputEventSystem.windowResizedDispatcher);
-
-					if (window != nullptr)
-						globalData->inputEventStack.Add(_event, &window->resizedEventDispatcher);
-
-					globalData->inputEventStack.WaitUntilEmpty();
-
-					globalData->windowSwappingSkipFlag.clear();
-
-					//if (globalData->windowSwappingWaitingMutex.try_lock())
-					//	globalData->windowSwappingWaitingMutex.unlock();
-					//else
-					//{
-					//	globalData->windowSwappingPossibleFlag.test_and_set();
-					//	globalData->windowSwappingPossibleFlag.notify_all();						
-					//
-					//	globalData->windowSwappingPossibleFlag.wait(1);
-					//}
-					
-					break;
-				}
 				case SDL_WINDOWEVENT_FOCUS_GAINED: {
 					Events::WindowFocusGainedEvent _event;
 
-					WindowSDL* window = GetWindowFromSDLHandle(SDL_GetWindowFromID(event->window.windowID));
+					WindowSDL* window = GetWindowFromSDLID(event->window.windowID);
 					_event.window = window;
 
-					globalData->inputEventStack.Add(_event, &globalData->inputEventSystem.windowFocusGainedDispatcher);
-
-					if (window != nullptr)
-						globalData->inputEventStack.Add(_event, &_event.window->focusGainedEventDispatcher);
+					globalData->inputEventStack.Add(_event, &globalData->inputEventSystem.windowFocusGainedDispatcher, window != nullptr ? &window->focusGainedEventDispatcher : nullptr);
 
 					break;
 				}
 				case SDL_WINDOWEVENT_FOCUS_LOST: {
 					Events::WindowFocusLostEvent _event;
-					WindowSDL* window = GetWindowFromSDLHandle(SDL_GetWindowFromID(event->window.windowID));
+					WindowSDL* window = GetWindowFromSDLID(event->window.windowID);
 					_event.window = window;
-					globalData->inputEventStack.Add(_event, &globalData->inputEventSystem.windowFocusLostDispatcher);
-
-					if (window != nullptr)
-						globalData->inputEventStack.Add(_event, &_event.window->focusLostEventDispatcher);
+					globalData->inputEventStack.Add(_event, &globalData->inputEventSystem.windowFocusLostDispatcher, window != nullptr ? &window->focusLostEventDispatcher : nullptr);
 					break;
 				}
 				case SDL_WINDOWEVENT_CLOSE: {
 					Events::WindowCloseEvent _event;
-					WindowSDL* window = GetWindowFromSDLHandle(SDL_GetWindowFromID(event->window.windowID));
+					WindowSDL* window = GetWindowFromSDLID(event->window.windowID);
 					_event.window = window;
-					globalData->inputEventStack.Add(_event, &globalData->inputEventSystem.windowCloseDispatcher);
-
-					if (window != nullptr)
-						globalData->inputEventStack.Add(_event, &_event.window->closeEventDispatcher);
+					globalData->inputEventStack.Add(_event, &globalData->inputEventSystem.windowCloseDispatcher, window != nullptr ? &window->closeEventDispatcher : nullptr);
 					break;
 				}
 				case SDL_WINDOWEVENT_ENTER: {
 					Events::WindowMouseEnterEvent _event;
-					WindowSDL* window = GetWindowFromSDLHandle(SDL_GetWindowFromID(event->window.windowID));
+					WindowSDL* window = GetWindowFromSDLID(event->window.windowID);
 					_event.window = window;
-					globalData->inputEventStack.Add(_event, &globalData->inputEventSystem.windowMouseEnterDispatcher);
-
-					if (window != nullptr)
-						globalData->inputEventStack.Add(_event, &_event.window->mouseEnterDispatcher);
+					globalData->inputEventStack.Add(_event, &globalData->inputEventSystem.windowMouseEnterDispatcher, window != nullptr ? &window->mouseEnterDispatcher : nullptr);
 					break;
 				}
 				case SDL_WINDOWEVENT_LEAVE: {
 					Events::WindowMouseLeaveEvent _event;
-					WindowSDL* window = GetWindowFromSDLHandle(SDL_GetWindowFromID(event->window.windowID));
+					WindowSDL* window = GetWindowFromSDLID(event->window.windowID);
 					_event.window = window;
-					globalData->inputEventStack.Add(_event, &globalData->inputEventSystem.windowMouseLeaveDispatcher);
-
-					if (window != nullptr)
-						globalData->inputEventStack.Add(_event, &_event.window->mouseLeaveDispatcher);
+					globalData->inputEventStack.Add(_event, &globalData->inputEventSystem.windowMouseLeaveDispatcher, window != nullptr ? &window->mouseLeaveDispatcher : nullptr);
 					break;
 				}
 				}
@@ -1,29 +1,10 @@
 #include "pch.h"
 #include "BlazeEngine/Input/Key.h"
-#include "BlazeEngine/Internal/GlobalData.h"
+#include "BlazeEngine/Internal/KeyTables.h"
 #include "SDL2/SDL.h"
 
 namespace Blaze
 {	
-	SDL_Scancode GetScancodeFromKey(Key key)
-	{
-		auto it = globalData->scancodemap.Find(key);
-
-		if (it.IsNull())
-			return SDL_SCANCODE_UNKNOWN;
-		
-		return it->value;
-	}
-	Key GetKeyFromScancode(SDL_Scancode code)
-	{
-		auto it = globalData->keymap.Find(code);
-
-		if (it.IsNull())
-			return Key::Unknown;
-
-		return it->value;
-	}
-
 	String GetKeyName(Key key)
 	{	
 		if (key < Key::MouseLeft)
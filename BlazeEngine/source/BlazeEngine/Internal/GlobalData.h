@@ -5,6 +5,7 @@
 #include "BlazeEngine/Console/Console.h"
 #include "ThreadEventStack.h"
 #include "ThreadTaskQueue.h"
+#include "KeyStates.h"
 
 namespace Blaze
 {	
@@ -47,30 +48,55 @@ namespace Blaze
 
 		Blaze::TimingResult blazeInitTimings;		
 
-		Blaze::Map<Blaze::Key, SDL_Scancode> scancodemap;
-		Blaze::Map<SDL_Scancode, Blaze::Key> keymap;		
-		EventStack<2048> inputEventStack;		
+		EventStack<65536> inputEventStack;		
 		Input::InputEventSystem inputEventSystem;
 
-		Input::KeyState keyStates[(uint)Key::KeyCount];
-		double keyComboTime = 0.2;
-		std::mutex keyStatesMutex;
+		KeyStates keyStates;
 
 		SDL_Cursor* cursors[(uint)Input::CursorType::CursorCount];
 
 		ConsoleOutputStream consoleOutputStream;
 		
 		std::atomic_flag windowSwappingSkipFlag;		
+		//Changed every time a SDL window gets a different WindowSDL pointer, invalidates cached window lookups
+		std::atomic<uint32> windowLookupGeneration = 0;
 
 		uint32 mainThreadTaskEventIdentifier;
 		uint32 clientThreadExitEventIdentifier;
 
+		/*
+			Runs the function on the main thread without waiting for it
+		*/
+		template<typename F>
+		void PostToMainThread(F&& function)
+		{
+			mainThreadTasks.Enqueue(std::forward<F>(function));
+			WakeMainThread();
+		}
+		/*
+			Runs the function on the main thread, the returned future receives its return value
+		*/
+		template<typename F>
+		auto ExecuteOnMainThreadAsync(F&& function)
+		{
+			auto future = mainThreadTasks.EnqueueWithResult(std::forward<F>(function));
+			WakeMainThread();
+			return future;
+		}
+		/*
+			Runs the function on the main thread and waits for it to finish
+		*/
 		void ExecuteOnMainThread(std::function<void()>&& function);
+		/*
+			Executes all tasks added to the main thread queue. Called by the main thread
+		*/
 		void CheckForMainThreadTask();
 	private:
-		std::mutex mainThreadTaskMutex;
-		std::function<void()> mainThreadTask;
-		std::atomic_flag mainThreadTaskFlag = ATOMIC_FLAG_INIT;
+		ThreadTaskQueue<256> mainThreadTasks;
+		//Set while a wake up event is in the SDL queue, so a batch of tasks pushes only one event
+		std::atomic_flag mainThreadWakePending = ATOMIC_FLAG_INIT;
+
+		void WakeMainThread();
 	};	
 	
 	
@@ -0,0 +1,122 @@
+#pragma once
+#include "BlazeEngine/Input/Input.h"
+#include <atomic>
+
+namespace Blaze
+{
+	/*
+		One bit per key
+	*/
+	struct KeyBitset
+	{
+		static constexpr uint WordCount = ((uint)Key::KeyCount + 63) / 64;
+
+		uint64 words[WordCount] = { };
+
+		bool Test(Key key) const { return (words[(uint)key / 64] >> ((uint)key % 64)) & 1; }
+	};
+
+	/*
+		Key states shared between the thread that receives key events and the client thread. The receiving thread
+		changes the bits with atomic operations, the client thread takes a snapshot of them once per frame in Update
+		without locking. Presses and releases are recorded as edges in separate bitsets when the down bit actually
+		changes, so a key pressed and released, or released and pressed again, between two snapshots still reports both.
+	*/
+	class KeyStates
+	{
+	public:
+		//Presses closer together than this increase the combo count
+		double comboTime = 0.2;
+
+		KeyStates()
+		{
+			for (uint i = 0; i < KeyBitset::WordCount; ++i)
+			{
+				downWords[i].store(0, std::memory_order_relaxed);
+				pressWords[i].store(0, std::memory_order_relaxed);
+				releaseWords[i].store(0, std::memory_order_relaxed);
+			}
+
+			for (uint i = 0; i < (uint)Key::KeyCount; ++i)
+			{
+				pressTimes[i].store(0, std::memory_order_relaxed);
+				combos[i].store(0, std::memory_order_relaxed);
+			}
+		}
+
+		/*
+			Called by the thread receiving the events. Fills the press time and combo of the event
+		*/
+		void Press(Key key, double time, uint& combo)
+		{
+			uint index = (uint)key;
+			uint64 bit = (uint64)1 << (index % 64);
+
+			uint newCombo = time - pressTimes[index].load(std::memory_order_relaxed) <= comboTime ? combos[index].load(std::memory_order_relaxed) + 1 : 1;
+			pressTimes[index].store(time, std::memory_order_relaxed);
+			combos[index].store(newCombo, std::memory_order_relaxed);
+			combo = newCombo;
+
+			//Key repeats leave the bits unchanged
+			if ((downWords[index / 64].fetch_or(bit, std::memory_order_release) & bit) == 0)
+				pressWords[index / 64].fetch_or(bit, std::memory_order_release);
+		}
+		/*
+			Called by the thread receiving the events. Returns the time of the last press
+		*/
+		double Release(Key key)
+		{
+			uint index = (uint)key;
+			uint64 bit = (uint64)1 << (index % 64);
+
+			if ((downWords[index / 64].fetch_and(~bit, std::memory_order_release) & bit) != 0)
+				releaseWords[index / 64].fetch_or(bit, std::memory_order_release);
+
+			return pressTimes[index].load(std::memory_order_relaxed);
+		}
+
+		/*
+			Called by the client thread once per frame
+		*/
+		void Update()
+		{
+			//The edges are taken before the down bits. An edge that happens in between shows in the down bits now
+			//and is reported by the next update, it is never reported twice or lost
+			for (uint i = 0; i < KeyBitset::WordCount; ++i)
+			{
+				pressed.words[i] = pressWords[i].exchange(0, std::memory_order_acquire);
+				released.words[i] = releaseWords[i].exchange(0, std::memory_order_acquire);
+			}
+
+			for (uint i = 0; i < KeyBitset::WordCount; ++i)
+				down.words[i] = downWords[i].load(std::memory_order_acquire);
+		}
+		/*
+			Only valid on the client thread
+		*/
+		Input::KeyState GetState(Key key) const
+		{
+			Input::KeyState state;
+			state.pressed = pressed.Test(key);
+			state.down = down.Test(key);
+			state.released = released.Test(key);
+			state.up = !state.down;
+			state.combo = combos[(uint)key].load(std::memory_order_relaxed);
+			state.time = pressTimes[(uint)key].load(std::memory_order_relaxed);
+			return state;
+		}
+	private:
+		//Written by the receiving thread
+		std::atomic<uint64> downWords[KeyBitset::WordCount];
+		//Keys that went down or up since the last Update, cleared by it
+		std::atomic<uint64> pressWords[KeyBitset::WordCount];
+		std::atomic<uint64> releaseWords[KeyBitset::WordCount];
+		std::atomic<double> pressTimes[(uint)Key::KeyCount];
+		std::atomic<uint> combos[(uint)Key::KeyCount];
+
+		//Owned by the client thread, the state of the last frame
+		KeyBitset down;
+		KeyBitset pressed;
+		KeyBitset released;
+	};
+}
@@ -0,0 +1,192 @@
+#pragma once
+#include "BlazeEngine/Input/Key.h"
+#include <SDL2/SDL_scancode.h>
+
+namespace Blaze
+{
+	struct KeyScancodePair
+	{
+		Key key;
+		SDL_Scancode scancode;
+	};
+
+	inline constexpr KeyScancodePair keyScancodePairs[] = {
+		{ Key::Unknown, SDL_SCANCODE_UNKNOWN },
+		{ Key::A, SDL_SCANCODE_A },
+		{ Key::B, SDL_SCANCODE_B },
+		{ Key::C, SDL_SCANCODE_C },
+		{ Key::D, SDL_SCANCODE_D },
+		{ Key::E, SDL_SCANCODE_E },
+		{ Key::F, SDL_SCANCODE_F },
+		{ Key::G, SDL_SCANCODE_G },
+		{ Key::H, SDL_SCANCODE_H },
+		{ Key::I, SDL_SCANCODE_I },
+		{ Key::J, SDL_SCANCODE_J },
+		{ Key::K, SDL_SCANCODE_K },
+		{ Key::L, SDL_SCANCODE_L },
+		{ Key::M, SDL_SCANCODE_M },
+		{ Key::N, SDL_SCANCODE_N },
+		{ Key::O, SDL_SCANCODE_O },
+		{ Key::P, SDL_SCANCODE_P },
+		{ Key::Q, SDL_SCANCODE_Q },
+		{ Key::R, SDL_SCANCODE_R },
+		{ Key::S, SDL_SCANCODE_S },
+		{ Key::T, SDL_SCANCODE_T },
+		{ Key::U, SDL_SCANCODE_U },
+		{ Key::V, SDL_SCANCODE_V },
+		{ Key::W, SDL_SCANCODE_W },
+		{ Key::X, SDL_SCANCODE_X },
+		{ Key::Y, SDL_SCANCODE_Y },
+		{ Key::Z, SDL_SCANCODE_Z },
+
+		{ Key::One, SDL_SCANCODE_1 },
+		{ Key::Two, SDL_SCANCODE_2 },
+		{ Key::Three, SDL_SCANCODE_3 },
+		{ Key::Four, SDL_SCANCODE_4 },
+		{ Key::Five, SDL_SCANCODE_5 },
+		{ Key::Six, SDL_SCANCODE_6 },
+		{ Key::Seven, SDL_SCANCODE_7 },
+		{ Key::Eight, SDL_SCANCODE_8 },
+		{ Key::Nine, SDL_SCANCODE_9 },
+		{ Key::Zero, SDL_SCANCODE_0 },
+
+		{ Key::Enter, SDL_SCANCODE_RETURN },
+		{ Key::Escape, SDL_SCANCODE_ESCAPE },
+		{ Key::Backspace, SDL_SCANCODE_BACKSPACE },
+		{ Key::Tab, SDL_SCANCODE_TAB },
+		{ Key::Space, SDL_SCANCODE_SPACE },
+		{ Key::Minus, SDL_SCANCODE_MINUS },
+		{ Key::Equals, SDL_SCANCODE_EQUALS },
+		{ Key::LeftBracket, SDL_SCANCODE_LEFTBRACKET },
+		{ Key::RightBracket, SDL_SCANCODE_RIGHTBRACKET },
+		{ Key::Backslash, SDL_SCANCODE_BACKSLASH },
+		{ Key::Semicolon, SDL_SCANCODE_SEMICOLON },
+		{ Key::Aapostrophe, SDL_SCANCODE_APOSTROPHE },
+		{ Key::Grave, SDL_SCANCODE_GRAVE },
+		{ Key::Comma, SDL_SCANCODE_COMMA },
+		{ Key::Period, SDL_SCANCODE_PERIOD },
+		{ Key::Slash, SDL_SCANCODE_SLASH },
+		{ Key::CapsLock, SDL_SCANCODE_CAPSLOCK },
+
+		{ Key::F1, SDL_SCANCODE_F1 },
+		{ Key::F2, SDL_SCANCODE_F2 },
+		{ Key::F3, SDL_SCANCODE_F3 },
+		{ Key::F4, SDL_SCANCODE_F4 },
+		{ Key::F5, SDL_SCANCODE_F5 },
+		{ Key::F6, SDL_SCANCODE_F6 },
+		{ Key::F7, SDL_SCANCODE_F7 },
+		{ Key::F8, SDL_SCANCODE_F8 },
+		{ Key::F9, SDL_SCANCODE_F9 },
+		{ Key::F10, SDL_SCANCODE_F10 },
+		{ Key::F11, SDL_SCANCODE_F11 },
+		{ Key::F12, SDL_SCANCODE_F12 },
+
+		{ Key::PrintScreen, SDL_SCANCODE_PRINTSCREEN },
+		{ Key::ScrollLock, SDL_SCANCODE_SCROLLLOCK },
+		{ Key::Pause, SDL_SCANCODE_PAUSE },
+		{ Key::Insert, SDL_SCANCODE_INSERT },
+		{ Key::Home, SDL_SCANCODE_HOME },
+		{ Key::PageUp, SDL_SCANCODE_PAGEUP },
+		{ Key::Delete, SDL_SCANCODE_DELETE },
+		{ Key::End, SDL_SCANCODE_END },
+		{ Key::PageDown, SDL_SCANCODE_PAGEDOWN },
+		{ Key::Right, SDL_SCANCODE_RIGHT },
+		{ Key::Left, SDL_SCANCODE_LEFT },
+		{ Key::Down, SDL_SCANCODE_DOWN },
+		{ Key::Up, SDL_SCANCODE_UP },
+
+		{ Key::KeypadDivide, SDL_SCANCODE_KP_DIVIDE },
+		{ Key::KeypadMultiply, SDL_SCANCODE_KP_MULTIPLY },
+		{ Key::KeypadMinus, SDL_SCANCODE_KP_MINUS },
+		{ Key::KeypadPlus, SDL_SCANCODE_KP_PLUS },
+		{ Key::KeypadEnter, SDL_SCANCODE_KP_ENTER },
+		{ Key::Keypad1, SDL_SCANCODE_KP_1 },
+		{ Key::Keypad2, SDL_SCANCODE_KP_2 },
+		{ Key::Keypad3, SDL_SCANCODE_KP_3 },
+		{ Key::Keypad4, SDL_SCANCODE_KP_4 },
+		{ Key::Keypad5, SDL_SCANCODE_KP_5 },
+		{ Key::Keypad6, SDL_SCANCODE_KP_6 },
+		{ Key::Keypad7, SDL_SCANCODE_KP_7 },
+		{ Key::Keypad8, SDL_SCANCODE_KP_8 },
+		{ Key::Keypad9, SDL_SCANCODE_KP_9 },
+		{ Key::Keypad0, SDL_SCANCODE_KP_0 },
+		{ Key::KeypadPeriod, SDL_SCANCODE_KP_PERIOD },
+
+		{ Key::Application, SDL_SCANCODE_APPLICATION },
+		{ Key::Power, SDL_SCANCODE_POWER },
+		{ Key::F13, SDL_SCANCODE_F13 },
+		{ Key::F14, SDL_SCANCODE_F14 },
+		{ Key::F15, SDL_SCANCODE_F15 },
+		{ Key::F16, SDL_SCANCODE_F16 },
+		{ Key::F17, SDL_SCANCODE_F17 },
+		{ Key::F18, SDL_SCANCODE_F18 },
+		{ Key::F19, SDL_SCANCODE_F19 },
+		{ Key::F20, SDL_SCANCODE_F20 },
+		{ Key::F21, SDL_SCANCODE_F21 },
+		{ Key::F22, SDL_SCANCODE_F22 },
+		{ Key::F23, SDL_SCANCODE_F23 },
+		{ Key::F24, SDL_SCANCODE_F24 },
+		{ Key::Execute, SDL_SCANCODE_EXECUTE },
+		{ Key::Help, SDL_SCANCODE_HELP },
+		{ Key::Menu, SDL_SCANCODE_MENU },
+		{ Key::Select, SDL_SCANCODE_SELECT },
+		{ Key::Stop, SDL_SCANCODE_STOP },
+		{ Key::Again, SDL_SCANCODE_AGAIN },
+		{ Key::Undo, SDL_SCANCODE_UNDO },
+		{ Key::Cut, SDL_SCANCODE_CUT },
+		{ Key::Copy, SDL_SCANCODE_COPY },
+		{ Key::Paste, SDL_SCANCODE_PASTE },
+		{ Key::Mute, SDL_SCANCODE_MUTE },
+		{ Key::VolumeUp, SDL_SCANCODE_VOLUMEUP },
+		{ Key::VolumeDown, SDL_SCANCODE_VOLUMEDOWN },
+
+		{ Key::LCtrl, SDL_SCANCODE_LCTRL },
+		{ Key::LShift, SDL_SCANCODE_LSHIFT },
+		{ Key::LAlt, SDL_SCANCODE_LALT },
+		{ Key::RCtrl, SDL_SCANCODE_RCTRL },
+		{ Key::RShift, SDL_SCANCODE_RSHIFT },
+		{ Key::RAlt, SDL_SCANCODE_RALT }
+	};
+
+	/*
+		Dense translation tables built at compile time from the pairs above, translating a key or a scancode is a
+		single array access
+	*/
+	struct KeyToScancodeTable
+	{
+		SDL_Scancode scancodes[(uint)Key::KeyCount];
+
+		constexpr KeyToScancodeTable()
+			: scancodes()
+		{
+			for (auto& pair : keyScancodePairs)
+				scancodes[(uint)pair.key] = pair.scancode;
+		}
+	};
+	struct ScancodeToKeyTable
+	{
+		Key keys[SDL_NUM_SCANCODES];
+
+		constexpr ScancodeToKeyTable()
+			: keys()
+		{
+			for (auto& pair : keyScancodePairs)
+				keys[pair.scancode] = pair.key;
+		}
+	};
+
+	inline constexpr KeyToScancodeTable keyToScancodeTable;
+	inline constexpr ScancodeToKeyTable scancodeToKeyTable;
+
+	//Every keyboard key has a scancode, mouse buttons don't
+	static_assert(sizeof(keyScancodePairs) / sizeof(KeyScancodePair) == (uint)Key::MouseLeft, "Every keyboard key needs a scancode");
+
+	constexpr SDL_Scancode GetScancodeFromKey(Key key)
+	{
+		return (uint)key < (uint)Key::KeyCount ? keyToScancodeTable.scancodes[(uint)key] : SDL_SCANCODE_UNKNOWN;
+	}
+	constexpr Key GetKeyFromScancode(SDL_Scancode scancode)
+	{
+		return (uint)scancode < SDL_NUM_SCANCODES ? scancodeToKeyTable.keys[scancode] : Key::Unknown;
+	}
+}
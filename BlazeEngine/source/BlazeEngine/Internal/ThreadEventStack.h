@@ -1,110 +1,305 @@
 #pragma once
 #include "BlazeEngine/Event/EventDispatcher.h"
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <chrono>
 
 namespace Blaze
 {
-	template<uint MaxStackSize>
+	/*
+		Ring buffer that moves events of any type from the threads that receive them to the thread that dispatches
+		them. Adding an event doesn't lock. When the ring is full Add waits up to 'MaxAddWaitTime' for the processing
+		thread to free space, so events that change state, like key presses, aren't lost when the client is only
+		slow. The wait is bounded because the adding thread is the OS event pump, and the client may be waiting for
+		it. TryAdd drops the event right away, it is meant for events that only matter while they are fresh, like
+		mouse motion. AddOrReplace overwrites the last added event in place if it wasn't dispatched yet, so bursts
+		of events where only the latest one matters, like resizes, are delivered once. Any thread can add events,
+		only one thread at a time may process them. Events left in the ring when it is destroyed are destroyed
+		without being dispatched.
+	*/
+	template<uint Capacity>
 	class EventStack
 	{
-		template<typename T>
-		struct EventInfo
+		static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+		static constexpr uint RecordAlignment = 16;
+		static constexpr auto MaxAddWaitTime = std::chrono::seconds(1);
+
+		enum RecordState : uint32
 		{
-			EventDispatcher<T>* dispatcher;
-			T event;
+			Ready = 1,
+			//AddOrReplace is changing the event, the consumer leaves it for the next call
+			Replacing = 2,
+			Dispatching = 3
 		};
 
-		struct EventHeader
+		static constexpr uint32 GetRecordTag(uint64 position) { return (uint32)(position / RecordAlignment) << 2; }
+
+		struct alignas(RecordAlignment) RecordHeader
 		{
-			uint8 size;
-			void(*fnc)(void*);
+			//Size of the whole record including this header
+			uint32 size;
+			//Zero until the record is fully written, then a tag of the record position and a RecordState. The
+			//consumer clears all processed bytes, so a header written over old records never looks committed by
+			//accident. The tag keeps AddOrReplace from claiming a newer record in the same place
+			uint32 state;
+			//nullptr for padding records that fill the space at the end of the ring. Destroys the record, dispatching
+			//it first if 'dispatch' is true
+			void(*fnc)(void*, bool dispatch);
 		};
 
-		template<typename T>
-		struct EventInstance
+		template<typename T, uint DispatcherCount>
+		struct EventRecord
 		{
-			EventHeader header;
-			EventInfo<T> info;
+			T event;
+			EventDispatcher<T>* dispatchers[DispatcherCount];
 		};
-		template<typename T>
-		static void CallEventFromStack(void* ptr)
+
+		template<typename T, uint DispatcherCount>
+		static constexpr uint RecordSize = (sizeof(RecordHeader) + sizeof(EventRecord<T, DispatcherCount>) + RecordAlignment - 1) / RecordAlignment * RecordAlignment;
+
+		template<typename T, uint DispatcherCount>
+		static void CallEventFromStack(void* ptr, bool dispatch)
 		{
-			EventInfo<T>* eventInfo = (EventInfo<T>*)ptr;
+			EventRecord<T, DispatcherCount>* record = (EventRecord<T, DispatcherCount>*)ptr;
 
-			eventInfo->dispatcher->Call(eventInfo->event);
-			eventInfo->event.~T();
+			if (dispatch)
+				for (auto dispatcher : record->dispatchers)
+					if (dispatcher != nullptr)
+						dispatcher->Call(record->event);
+
+			std::destroy_at(record);
 		}
 
-		std::mutex mutex;
-		uint8 stack[MaxStackSize];
-		uint stackSize = 0;
-		std::condition_variable cv;
+		alignas(RecordAlignment) uint8 buffer[Capacity];
+		alignas(64) std::atomic<uint64> writePosition = 0;
+		alignas(64) std::atomic<uint64> readPosition = 0;
+		//The thread inside ProcessAndClear. If a handler adds an event to a full ring it can't wait for itself
+		std::atomic<std::thread::id> processingThread;
+		//Set after an event was dropped, so a full ring logs once instead of once per event
+		std::atomic_flag overflowReported = ATOMIC_FLAG_INIT;
+		std::atomic<uint64> droppedEventCount = 0;
 	public:
+		EventStack()
+		{
+			memset(buffer, 0, Capacity);
+		}
+		~EventStack()
+		{
+			uint64 position = readPosition.load(std::memory_order_relaxed);
+			uint64 end = writePosition.load(std::memory_order_acquire);
+
+			//Events can own memory, like the string of a text input event
+			while (position != end)
+			{
+				RecordHeader* header = (RecordHeader*)(buffer + (position & (Capacity - 1)));
+
+				if (std::atomic_ref<uint32>(header->state).load(std::memory_order_acquire) == 0)
+					break;
+
+				if (header->fnc != nullptr)
+					header->fnc(header + 1, false);
+
+				position += header->size;
+			}
+		}
+
+		/*
+			Dispatches all events added until now. Events added by the handlers are left for the next call
+		*/
 		void ProcessAndClear()
 		{
-			/*
-				Implementation details:
+			uint64 position = readPosition.load(std::memory_order_relaxed);
+			uint64 end = writePosition.load(std::memory_order_acquire);
 
-				We try to execute all available events without locking the mutex because we will be running client
-				code so we dont know what can happen. So we store the stack size and use it until that point, later
-				we lock the mutex and move the rest of the stack (if there is more at that point) to the begging without processing it.
-			*/
+			if (position == end)
+				return;
 
-			uint oldStackSize = 0;
+			processingThread.store(std::this_thread::get_id(), std::memory_order_relaxed);
 
+			while (position != end)
 			{
-				std::lock_guard<std::mutex> lk{ mutex };
-				oldStackSize = stackSize;
+				RecordHeader* header = (RecordHeader*)(buffer + (position & (Capacity - 1)));
+
+				uint32 state = GetRecordTag(position) | Ready;
+
+				//The space is reserved but the event isn't written yet or is being replaced, it is processed next time
+				if (!std::atomic_ref<uint32>(header->state).compare_exchange_strong(state, GetRecordTag(position) | Dispatching, std::memory_order_acquire, std::memory_order_relaxed))
+					break;
+
+				uint32 size = header->size;
+
+				if (header->fnc != nullptr)
+					header->fnc(header + 1, true);
+
+				//The state is cleared atomically, AddOrReplace may be trying to claim the record
+				memset((void*)(header + 1), 0, size - sizeof(RecordHeader));
+				std::atomic_ref<uint32>(header->state).store(0, std::memory_order_relaxed);
+				position += size;
+
+				//Released after every record so producers get the space back while long handlers run
+				readPosition.store(position, std::memory_order_release);
 			}
 
-			void* ptr = stack;
-			void* end = stack + oldStackSize;
+			processingThread.store(std::thread::id(), std::memory_order_relaxed);
+			overflowReported.clear(std::memory_order_relaxed);
+			readPosition.notify_all();
+		}
+		/*
+			Blocks until all events added until now were processed. Used by the event pump when the client has to
+			react to an event before the OS continues, like a resize
+		*/
+		void WaitUntilEmpty()
+		{
+			uint64 end = writePosition.load(std::memory_order_acquire);
+			uint64 position = readPosition.load(std::memory_order_acquire);
 
-			while (ptr != end)
+			while (position < end)
 			{
-				EventHeader* header = (EventHeader*)ptr;
-				header->fnc((char*)ptr + sizeof(EventHeader));
-				ptr = (char*)ptr + header->size;
+				readPosition.wait(position, std::memory_order_acquire);
+				position = readPosition.load(std::memory_order_acquire);
 			}
+		}
+
+		/*
+			Adds one event that is delivered to all given dispatchers, one reservation is made for all of them.
+			nullptr dispatchers are skipped. Waits while the ring is full, the event is dropped if no space was freed
+			within 'MaxAddWaitTime' or if it is added by a handler on the processing thread, which would wait for
+			itself. Returns false if the event was dropped
+		*/
+		template<typename T, typename ... Dispatchers> requires (std::convertible_to<Dispatchers, EventDispatcher<T>*> && ...)
+		bool Add(const T& event, Dispatchers ... eventDispatchers)
+		{
+			return Push<true>(event, nullptr, eventDispatchers...);
+		}
+		/*
+			Same as Add but drops the event instead of waiting when the ring is full. Returns false if it was dropped
+		*/
+		template<typename T, typename ... Dispatchers> requires (std::convertible_to<Dispatchers, EventDispatcher<T>*> && ...)
+		bool TryAdd(const T& event, Dispatchers ... eventDispatchers)
+		{
+			return Push<false>(event, nullptr, eventDispatchers...);
+		}
 
+		/*
+			Same as Add, but if 'record' refers to the last added event and it wasn't dispatched yet, that event is
+			overwritten instead. The dispatchers have to be the same as for that event. 'record' is updated to refer
+			to the added event, it should be ~0 the first time
+		*/
+		template<typename T, typename ... Dispatchers> requires (std::convertible_to<Dispatchers, EventDispatcher<T>*> && ...)
+		bool AddOrReplace(uint64& record, const T& event, Dispatchers ... eventDispatchers)
+		{
+			constexpr uint DispatcherCount = sizeof...(Dispatchers);
+
+			//Events added after it have to stay after it, so only the last one is replaced
+			if (record != ~(uint64)0 && writePosition.load(std::memory_order_acquire) == record + RecordSize<T, DispatcherCount>)
 			{
-				std::lock_guard<std::mutex> lk{ mutex };
+				RecordHeader* header = (RecordHeader*)(buffer + (record & (Capacity - 1)));
+				uint32 state = GetRecordTag(record) | Ready;
+
+				if (std::atomic_ref<uint32>(header->state).compare_exchange_strong(state, GetRecordTag(record) | Replacing, std::memory_order_acquire, std::memory_order_relaxed))
+				{
+					EventRecord<T, DispatcherCount>* eventRecord = (EventRecord<T, DispatcherCount>*)(header + 1);
+					EventDispatcher<T>* dispatchers[]{ eventDispatchers... };
+					bool replaced = header->fnc == CallEventFromStack<T, DispatcherCount> && memcmp(eventRecord->dispatchers, dispatchers, sizeof(dispatchers)) == 0;
+
+					if (replaced)
+						eventRecord->event = event;
 
-				uint newStackSize = stackSize - oldStackSize;
-				memmove_s(stack, MaxStackSize, stack + oldStackSize, newStackSize);
-				stackSize = newStackSize;
+					std::atomic_ref<uint32>(header->state).store(GetRecordTag(record) | Ready, std::memory_order_release);
 
+					if (replaced)
+						return true;
+				}
 			}
 
-			cv.notify_all();
-		}
-		void WaitUntilEmpty()
-		{
-			std::unique_lock<std::mutex> lk{ mutex };
-			cv.wait(lk, [&]() { return stackSize == 0; });
+			return Push<true>(event, &record, eventDispatchers...);
 		}
 
-		template<typename T>
-		void Add(const T& event, EventDispatcher<T>* eventDispatcher)
+		inline uint64 GetDroppedEventCount() const { return droppedEventCount.load(std::memory_order_relaxed); }
+	private:
+		template<bool Wait, typename T, typename ... Dispatchers>
+		bool Push(const T& event, uint64* recordPosition, Dispatchers ... eventDispatchers)
 		{
-			constexpr uint size = sizeof(EventInstance<T>);
+			constexpr uint DispatcherCount = sizeof...(Dispatchers);
+			constexpr uint size = RecordSize<T, DispatcherCount>;
+			static_assert(size <= Capacity / 2, "Event is too big for the event stack");
+			static_assert(alignof(EventRecord<T, DispatcherCount>) <= RecordAlignment, "Event alignment is too big for the event stack");
 
-			std::unique_lock<std::mutex> lk{ mutex };
+			uint64 position = writePosition.load(std::memory_order_relaxed);
+			uint64 offset;
+			uint32 paddingSize;
+			//Set when the ring is first found full
+			std::chrono::steady_clock::time_point waitEnd;
+			bool waiting = false;
 
-			if (!cv.wait_for(lk, std::chrono::seconds(1), [&]() { return MaxStackSize >= stackSize + size; }))
+			while (true)
 			{
-				const char* str = typeid(T).name();
-				uintMem len = strlen(str);
-				Debug::Logger::LogWarning("Blaze Engine", "Input event stack overflow. The receiving thread didn't process any events for more than 1 second. Ignoring event of type \"" + String(str, len) + "\"");
-				return;
+				offset = position & (Capacity - 1);
+				//A record never wraps around the end of the ring, the space left there is skipped instead
+				paddingSize = Capacity - offset < size ? (uint32)(Capacity - offset) : 0;
+
+				uint64 read = readPosition.load(std::memory_order_acquire);
+
+				//Signed because 'position' can be older than the read position, the exchange below then fails
+				if ((int64)(position + paddingSize + size - read) > (int64)Capacity)
+				{
+					if (Wait && processingThread.load(std::memory_order_relaxed) != std::this_thread::get_id())
+					{
+						auto now = std::chrono::steady_clock::now();
+
+						if (!waiting)
+						{
+							waitEnd = now + MaxAddWaitTime;
+							waiting = true;
+						}
+
+						//Polled because atomic waits can't time out. The processing thread frees space after every record
+						if (now < waitEnd)
+						{
+							std::this_thread::sleep_for(std::chrono::microseconds(100));
+							position = writePosition.load(std::memory_order_relaxed);
+							continue;
+						}
+					}
+
+					droppedEventCount.fetch_add(1, std::memory_order_relaxed);
+
+					if (!overflowReported.test_and_set(std::memory_order_relaxed))
+					{
+						const char* str = typeid(T).name();
+						Debug::Logger::LogWarning("Blaze Engine", "Input event stack overflow. The receiving thread isn't processing events fast enough. Dropping events, first of type \"" + String(str, strlen(str)) + "\"");
+					}
+
+					return false;
+				}
+
+				if (writePosition.compare_exchange_weak(position, position + paddingSize + size, std::memory_order_relaxed))
+					break;
 			}
 
-			EventInstance<T>* instance = (EventInstance<T>*)(stack + stackSize);
-			instance->header.size = sizeof(EventInstance<T>);
-			instance->header.fnc = CallEventFromStack<T>;
-			instance->info.dispatcher = eventDispatcher;
-			std::construct_at(&instance->info.event, event);
+			if (paddingSize != 0)
+			{
+				RecordHeader* padding = (RecordHeader*)(buffer + offset);
+				padding->size = paddingSize;
+				padding->fnc = nullptr;
+				std::atomic_ref<uint32>(padding->state).store(GetRecordTag(position) | Ready, std::memory_order_release);
+
+				offset = 0;
+				position += paddingSize;
+			}
+
+			RecordHeader* header = (RecordHeader*)(buffer + offset);
+			header->size = size;
+			header->fnc = CallEventFromStack<T, DispatcherCount>;
+			std::construct_at((EventRecord<T, DispatcherCount>*)(header + 1), EventRecord<T, DispatcherCount>{ event, { eventDispatchers... } });
+			std::atomic_ref<uint32>(header->state).store(GetRecordTag(position) | Ready, std::memory_order_release);
+
+			if (recordPosition != nullptr)
+				*recordPosition = position;
 
-			stackSize += size;
+			return true;
 		}
-	};	
-}
\ No newline at end of file
+	};
+}
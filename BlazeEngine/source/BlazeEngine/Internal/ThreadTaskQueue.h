@@ -1,37 +1,230 @@
 #pragma once
+#include <atomic>
+#include <cstddef>
+#include <future>
 #include <mutex>
 
 namespace Blaze
-{	
+{
+	/*
+		Bounded queue of tasks that any thread can add to and a single thread executes. Tasks are stored in the
+		queue slots themselves, callables that don't fit into a slot are moved to the heap.
+
+		Adding a task never waits. If all 'Capacity' slots are taken the task goes to an overflow list that is executed
+		after the tasks queued before it, so the executing thread can add tasks to a full queue too. While the list
+		isn't empty new tasks are added to it as well, keeping the tasks in the order they were added.
+	*/
+	template<uintMem Capacity, uintMem InlineSize = 48>
 	class ThreadTaskQueue
-	{		
-		std::mutex waitingMutex;
+	{
+		static_assert(Capacity != 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+		struct alignas(64) Slot
+		{
+			//Equal to the enqueue position when the slot is free and to the position + 1 when it holds a task
+			std::atomic<uintMem> sequence;
+			//Destroys the task stored in 'storage', executing it first if 'execute' is true
+			void(*consume)(void* storage, bool execute);
+			alignas(std::max_align_t) uint8 storage[InlineSize];
+		};
+
+		template<typename F>
+		static constexpr bool StoredInline = sizeof(F) <= InlineSize && alignof(F) <= alignof(std::max_align_t);
+
+		template<typename F>
+		static void ConsumeInline(void* ptr, bool execute)
+		{
+			F* function = (F*)ptr;
+			if (execute)
+				(*function)();
+			std::destroy_at(function);
+		}
+		template<typename F>
+		static void ConsumeAllocated(void* ptr, bool execute)
+		{
+			F* function = *(F**)ptr;
+			if (execute)
+				(*function)();
+			delete function;
+		}
+
+		struct OverflowTask
+		{
+			void(*consume)(void* storage, bool execute);
+			//Heap allocated callable, 'consume' takes a pointer to this member like for slot storage
+			void* function;
+		};
 
-		std::function<void()> task;				
+		Slot slots[Capacity];
+		alignas(64) std::atomic<uintMem> enqueuePosition;
+		//Only used by the executing thread
+		alignas(64) uintMem dequeuePosition;
 
-		std::atomic_flag activeFlag;
+		//Set while 'overflowTasks' isn't empty, only changed with the mutex locked
+		alignas(64) std::atomic<bool> hasOverflowTasks;
+		std::mutex overflowMutex;
+		Array<OverflowTask> overflowTasks;
 	public:
-		void EnqueueTask(std::function<void()>&& task)
+		ThreadTaskQueue()
+			: enqueuePosition(0), dequeuePosition(0), hasOverflowTasks(false)
+		{
+			for (uintMem i = 0; i < Capacity; ++i)
+				slots[i].sequence.store(i, std::memory_order_relaxed);
+		}
+		~ThreadTaskQueue()
+		{
+			//Tasks that were never executed are destroyed without running them
+			for (; dequeuePosition != enqueuePosition.load(std::memory_order_acquire); ++dequeuePosition)
+			{
+				Slot& slot = slots[dequeuePosition & (Capacity - 1)];
+
+				if (slot.sequence.load(std::memory_order_acquire) == dequeuePosition + 1)
+					slot.consume(slot.storage, false);
+			}
+
+			for (auto& task : overflowTasks)
+				task.consume(&task.function, false);
+		}
+
+		/*
+			Returns false without adding the task if the queue is full or tasks are waiting in the overflow list
+		*/
+		template<typename F>
+		bool TryEnqueue(F&& function)
 		{
-			std::lock_guard<std::mutex> waiting_LG{ waitingMutex };
+			using Function = std::decay_t<F>;
+
+			//Queuing the task now would execute it before tasks added earlier
+			if (hasOverflowTasks.load(std::memory_order_acquire))
+				return false;
+
+			uintMem position = enqueuePosition.load(std::memory_order_relaxed);
+			Slot* slot;
 
-			this->task = std::move(task);
+			while (true)
+			{
+				slot = &slots[position & (Capacity - 1)];
+				uintMem sequence = slot->sequence.load(std::memory_order_acquire);
+				intMem difference = (intMem)sequence - (intMem)position;
 
-			activeFlag.test_and_set();
-			activeFlag.notify_one();
+				if (difference == 0)
+				{
+					if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+						break;
+				}
+				else if (difference < 0)
+					return false;
+				else
+					position = enqueuePosition.load(std::memory_order_relaxed);
+			}
 
-			activeFlag.wait(1);
+			if constexpr (StoredInline<Function>)
+			{
+				std::construct_at((Function*)slot->storage, std::forward<F>(function));
+				slot->consume = ConsumeInline<Function>;
+			}
+			else
+			{
+				*(Function**)slot->storage = new Function(std::forward<F>(function));
+				slot->consume = ConsumeAllocated<Function>;
+			}
+
+			slot->sequence.store(position + 1, std::memory_order_release);
+			return true;
 		}
-		
-		void CompleteTask()
+		/*
+			Adds a task without waiting for it to be executed
+		*/
+		template<typename F>
+		void Enqueue(F&& function)
 		{
-			if (!activeFlag.test())
+			using Function = std::decay_t<F>;
+
+			//The function is only moved from once a slot is taken, so it can still be used if that fails
+			if (TryEnqueue(std::forward<F>(function)))
 				return;
 
-			task();
+			//Waiting for a free slot would never end if the calling thread is the one executing the tasks
+			std::lock_guard lock{ overflowMutex };
+			overflowTasks.AddBack(OverflowTask{ ConsumeAllocated<Function>, new Function(std::forward<F>(function)) });
+			hasOverflowTasks.store(true, std::memory_order_release);
+		}
+		/*
+			Adds a task and returns a future that receives its return value
+		*/
+		template<typename F>
+		auto EnqueueWithResult(F&& function) -> std::future<std::invoke_result_t<std::decay_t<F>>>
+		{
+			std::packaged_task<std::invoke_result_t<std::decay_t<F>>()> task{ std::forward<F>(function) };
+			auto future = task.get_future();
+
+			Enqueue(std::move(task));
+
+			return future;
+		}
+
+		/*
+			Executes all tasks added until now, tasks added by the executed tasks are left for the next call. Must
+			only be called from one thread at a time. Returns the number of executed tasks
+		*/
+		uintMem ExecuteTasks()
+		{
+			//Taken before the end position, so every queued task added before these is executed first
+			Array<OverflowTask> overflow;
+
+			if (hasOverflowTasks.load(std::memory_order_acquire))
+			{
+				std::lock_guard lock{ overflowMutex };
+				overflow = std::move(overflowTasks);
+			}
+
+			uintMem endPosition = enqueuePosition.load(std::memory_order_acquire);
+			uintMem count = 0;
+
+			while (dequeuePosition != endPosition)
+			{
+				Slot& slot = slots[dequeuePosition & (Capacity - 1)];
+
+				//The slot is taken but the task is still being constructed
+				if (slot.sequence.load(std::memory_order_acquire) != dequeuePosition + 1)
+					break;
+
+				slot.consume(slot.storage, true);
+				slot.sequence.store(dequeuePosition + Capacity, std::memory_order_release);
+
+				++dequeuePosition;
+				++count;
+			}
+
+			if (!overflow.Empty())
+			{
+				std::lock_guard lock{ overflowMutex };
+
+				//Queued tasks added before the overflow ones are still being constructed, they have to go first
+				if (dequeuePosition != endPosition)
+				{
+					overflow.Append(std::move(overflowTasks));
+					overflowTasks = std::move(overflow);
+					return count;
+				}
+			}
+
+			for (auto& task : overflow)
+			{
+				task.consume(&task.function, true);
+				++count;
+			}
+
+			if (!overflow.Empty())
+			{
+				std::lock_guard lock{ overflowMutex };
+
+				//Tasks added to the list while these were executed stay in it for the next call
+				if (overflowTasks.Empty())
+					hasOverflowTasks.store(false, std::memory_order_release);
+			}
 
-			activeFlag.clear();
-			activeFlag.notify_one();
+			return count;
 		}
-	};	
-}
\ No newline at end of file
+	};
+}
@@ -266,8 +266,12 @@ namespace Blaze
 		StringUTF8 fileExtension = path.FileExtension();
 		StringParsing::GetAfterFirst(fileExtension, fileExtension, '.');		
 
+		//The file is decoded directly from mapped memory so it isn't copied into an intermediate buffer
+		MappedFile file;
+		CHECK_RESULT(file.Open(path, FileUsageHint::Sequential));
+
 		SAIL_CHECK(sail_codec_info_from_extension((const char*)fileExtension.Buffer(), &codec), "Failed to get codec info object from \"" + fileExtension + "\" extension");
-		SAIL_CHECK(sail_start_loading_from_file((const char*)pathString.Buffer(), codec, &state), "Failed to start loading from file with path \"" + pathString + "\"");
+		SAIL_CHECK(sail_start_loading_from_memory(file.GetData(), file.GetSize(), codec, &state), "Failed to start loading from file with path \"" + pathString + "\"");
 		SAIL_CHECK(sail_load_next_frame(state, &image), "Failed to load next from file with path \"" + pathString + "\"");
 
 		BitmapColorFormat format{ };
@@ -356,11 +360,42 @@ namespace Blaze
 		const sail_codec_info* codec = nullptr;
 		sail_image* image;
 		void* state = nullptr;
-		
-		SAIL_CHECK(sail_alloc_io(&io), "Failed to allocate io object.");
-		SetupSailReadIO(io, stream);
+		uintMem inPlaceSize = 0;
+
 		SAIL_CHECK(sail_codec_info_from_extension("bmp", &codec), "Failed to get codec info object from \".bmp\" extension.");
-		SAIL_CHECK(sail_start_loading_from_io(io, codec, &state), "Failed to start loading form io.");
+
+		/*
+			Bitmaps in memory are decoded in place. The BMP file header holds the size of the whole file, so it is
+			known how much of the stream the bitmap takes without going through the IO callbacks
+		*/
+		auto contiguousStream = dynamic_cast<ContiguousReadStream*>(&stream);
+
+		if (contiguousStream != nullptr)
+		{
+			ArrayView<byte> header = contiguousStream->TryGetContiguous(6);
+
+			if (header.Count() == 6 && header[0] == 'B' && header[1] == 'M')
+			{
+				uint32 fileSize;
+				memcpy(&fileSize, header.Ptr() + 2, sizeof(uint32));
+
+				ArrayView<byte> data = contiguousStream->TryGetContiguous(fileSize);
+
+				if (fileSize >= 6 && data.Count() == fileSize)
+				{
+					SAIL_CHECK(sail_start_loading_from_memory(data.Ptr(), data.Count(), codec, &state), "Failed to start loading from memory.");
+					inPlaceSize = fileSize;
+				}
+			}
+		}
+
+		if (inPlaceSize == 0)
+		{
+			SAIL_CHECK(sail_alloc_io(&io), "Failed to allocate io object.");
+			SetupSailReadIO(io, stream);
+			SAIL_CHECK(sail_start_loading_from_io(io, codec, &state), "Failed to start loading form io.");
+		}
+
 		SAIL_CHECK(sail_load_next_frame(state, &image), "Failed to load next frame.");
 		
 		BitmapColorFormat format{ };
@@ -373,7 +408,12 @@ namespace Blaze
 		Create(size, format, type, image->pixels, image->bytes_per_line, false);
 
 		SAIL_CHECK(sail_stop_loading(state), "Failed to stop loading");
-		sail_destroy_io(io);
+
+		if (io != nullptr)
+			sail_destroy_io(io);
+		else
+			contiguousStream->Consume(inPlaceSize);
+
 		sail_destroy_image(image);
 
 		return Result();
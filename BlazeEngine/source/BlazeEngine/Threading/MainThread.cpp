@@ -0,0 +1,11 @@
+#include "pch.h"
+#include "BlazeEngine/Threading/MainThread.h"
+#include "BlazeEngine/Internal/GlobalData.h"
+
+namespace Blaze
+{
+	void PostToMainThread(std::function<void()> function)
+	{
+		globalData->PostToMainThread(std::move(function));
+	}
+}
@@ -88,7 +88,12 @@ namespace Blaze
 	}
 	void DestroyWindowSDLHandle(WindowSDL::WindowSDLHandle handle)
 	{
-		globalData->ExecuteOnMainThread([&]() { SDL_DestroyWindow((SDL_Window*)handle); });
+		globalData->PostToMainThread([handle]() { SDL_DestroyWindow((SDL_Window*)handle); });
+	}
+	static void SetWindowSDLPointer(WindowSDL::WindowSDLHandle handle, WindowSDL* window)
+	{
+		SDL_SetWindowData((SDL_Window*)handle, "Blaze", window);
+		globalData->windowLookupGeneration.fetch_add(1, std::memory_order_release);
 	}
 		
 	WindowSDL::WindowSDL()
@@ -100,7 +105,7 @@ namespace Blaze
 		: handle(CreateWindowSDLHandle(createOptions)), graphicsAPI(createOptions.graphicsAPI)
 	{
 		//If any events were reported before this line they wont be reported to the client.		
-		SDL_SetWindowData((SDL_Window*)handle, "Blaze", this);
+		SetWindowSDLPointer(handle, this);
 
 	}
 	WindowSDL::WindowSDL(WindowSDL&& other) noexcept
@@ -108,7 +113,7 @@ namespace Blaze
 		handle = other.handle;
 		graphicsAPI = other.graphicsAPI;
 
-		SDL_SetWindowData((SDL_Window*)handle, "Blaze", this);
+		SetWindowSDLPointer(handle, this);
 
 		other.handle = nullptr;
 	}
@@ -121,7 +126,7 @@ namespace Blaze
 	{
 		if (handle == nullptr)
 			return;
-		SDL_SetWindowData((SDL_Window*)handle, "Blaze", nullptr);
+		SetWindowSDLPointer(handle, nullptr);
 		DestroyWindowSDLHandle(handle);
 		handle = nullptr;
 	}
@@ -386,7 +391,7 @@ namespace Blaze
 		graphicsAPI = other.graphicsAPI;
 		other.handle = nullptr;
 
-		SDL_SetWindowData((SDL_Window*)handle, "Blaze", this);
+		SetWindowSDLPointer(handle, this);
 		return *this;
 	}
 }
\ No newline at end of file
@@ -97,9 +97,21 @@
 
 #include "BlazeEngineCore/File/Path.h"
 #include "BlazeEngineCore/File/File.h"
+#include "BlazeEngineCore/File/Archive.h"
+#include "BlazeEngineCore/File/AtomicFile.h"
+#include "BlazeEngineCore/File/Compression.h"
 #include "BlazeEngineCore/File/FileSystem.h"
+#include "BlazeEngineCore/File/DirectoryWalker.h"
+#include "BlazeEngineCore/File/AsyncFileReader.h"
+#include "BlazeEngineCore/File/MappedFile.h"
+#include "BlazeEngineCore/File/PackFile.h"
+#include "BlazeEngineCore/File/PackFileSystem.h"
 #include "BlazeEngineCore/File/Stream/BufferStream.h"
+#include "BlazeEngineCore/File/Stream/BufferedStream.h"
+#include "BlazeEngineCore/File/Stream/CompressedStream.h"
+#include "BlazeEngineCore/File/Stream/ContiguousReadStream.h"
 #include "BlazeEngineCore/File/Stream/FileStream.h"
+#include "BlazeEngineCore/File/Stream/MappedFileStream.h"
 #include "BlazeEngineCore/File/Stream/Stream.h"
 #include "BlazeEngineCore/File/Stream/SubStream.h"
 
@@ -114,6 +126,9 @@
 #include "BlazeEngineCore/Utilities/StringParsing.h"
 
 #include "BlazeEngineCore/Threading/Thread.h"
+#include "BlazeEngineCore/Threading/SyncPrimitives.h"
+#include "BlazeEngineCore/Threading/JobSystem.h"
+#include "BlazeEngineCore/Threading/Task.h"
 
 #include "BlazeEngineCore/Memory/Creator.h"
 #include "BlazeEngineCore/Memory/Allocator.h"
@@ -0,0 +1,392 @@
+#pragma once
+#include "BlazeEngineCore/File/Stream/BufferedStream.h"
+#include "BlazeEngineCore/File/Stream/BufferStream.h"
+#include "BlazeEngineCore/DataStructures/Array.h"
+#include "BlazeEngineCore/DataStructures/ArrayView.h"
+#include "BlazeEngineCore/DataStructures/Map.h"
+#include "BlazeEngineCore/DataStructures/String.h"
+#include "BlazeEngineCore/DataStructures/StringUTF8.h"
+
+namespace Blaze
+{
+	class WriteArchive;
+	class ReadArchive;
+
+	template<typename T>
+	concept HasArchiveSerialize = requires(const T & value, WriteArchive & archive) {
+		value.Serialize(archive);
+	};
+	template<typename T>
+	concept HasArchiveDeserialize = requires(T & value, ReadArchive & archive) {
+		value.Deserialize(archive);
+	};
+
+	/*
+		Writes values into a stream in the archive format. Values are written by operator<<:
+			trivially copyable types are copied as they are,
+			types with a 'void Serialize(WriteArchive&) const' member function are written by it,
+			Array, String, StringUTF8 and Map are written as a uint64 element count followed by the elements.
+			Arrays of trivially copyable types are written with a single copy, after zero padding that aligns them to
+			alignof(T) counted from the start of the archive. Archives read from memory that starts at an address
+			aligned to 16 can view them in place.
+
+		Sections make the format versionable. BeginSection writes a version and EndSection writes the byte size of
+		the section, so a reader of an older version can skip the fields it doesn't know about and a reader of a
+		newer version knows which fields are missing. Open sections are collected in memory and written out when
+		the outermost one ends, so the stream never has to seek.
+
+		Writes are buffered, the archive must be flushed (or destroyed) before the stream is used again. Flushing
+		doesn't write sections that are still open. Errors are sticky, check Failed after writing.
+	*/
+	class BLAZE_CORE_API WriteArchive
+	{
+	public:
+		WriteArchive(WriteStream& stream);
+		WriteArchive(const WriteArchive&) = delete;
+		~WriteArchive();
+
+		void BeginSection(uint32 version);
+		void EndSection();
+
+		inline void WriteBytes(const void* ptr, uintMem byteCount);
+		/*
+			Writes zeros until the archive size is a multiple of 'alignment'
+		*/
+		inline void WritePadding(uintMem alignment);
+		template<typename T> requires std::is_trivially_copyable_v<T>
+		inline void WriteArray(const T* ptr, uintMem count);
+
+		bool Flush();
+		inline bool Failed() const { return failed; }
+
+		WriteArchive& operator=(const WriteArchive&) = delete;
+	private:
+		BufferedWriteStream stream;
+		//Holds the data of the open sections, their sizes are filled in by EndSection
+		BufferWriteStream sectionBuffer;
+		Array<uintMem> sectionSizePositions;
+		//Bytes written or buffered since the archive was created, padding is counted from here
+		uintMem position;
+		bool failed;
+	};
+
+	/*
+		Reads values written by WriteArchive, see WriteArchive for the format.
+
+		The archive can read from a stream or directly from memory. Streams that have all of their remaining data in
+		memory (see ContiguousReadStream) are read from memory too. When reading from memory, ViewArray returns
+		arrays of trivially copyable types without copying them. Container sizes are checked against the remaining
+		data, so a corrupted archive fails instead of allocating huge containers. Errors are sticky, values read
+		after an error are left unchanged.
+	*/
+	class BLAZE_CORE_API ReadArchive
+	{
+	public:
+		ReadArchive(ReadStream& stream);
+		ReadArchive(const void* data, uintMem size);
+		ReadArchive(const ReadArchive&) = delete;
+		~ReadArchive();
+
+		/*
+			Returns the version of the section
+		*/
+		uint32 BeginSection();
+		/*
+			Skips the rest of the section
+		*/
+		void EndSection();
+		/*
+			Returns the version of the innermost section, 0 if there is no section
+		*/
+		uint32 GetSectionVersion() const;
+
+		inline void ReadBytes(void* ptr, uintMem byteCount);
+		/*
+			Skips the padding WriteArchive::WritePadding wrote for the same alignment
+		*/
+		void SkipPadding(uintMem alignment);
+		template<typename T> requires std::is_trivially_copyable_v<T>
+		inline void ReadArray(T* ptr, uintMem count);
+		/*
+			Returns a view to 'count' elements directly in the archive memory. Valid only for archives reading from
+			memory and only while that memory is valid. The elements are aligned relative to the start of the archive,
+			if the archive memory itself isn't aligned for T this returns an empty view and fails the archive
+		*/
+		template<typename T> requires std::is_trivially_copyable_v<T>
+		ArrayView<T> ViewArray(uintMem count);
+
+		/*
+			Checks if 'count' elements of 'elementSize' can still be read and fails the archive otherwise. Used to
+			validate container sizes before allocating
+		*/
+		bool CanRead(uintMem count, uintMem elementSize);
+
+		inline bool IsReadingFromMemory() const { return data != nullptr; }
+		inline bool Failed() const { return failed; }
+		inline void Fail() { failed = true; }
+
+		ReadArchive& operator=(const ReadArchive&) = delete;
+	private:
+		struct Section
+		{
+			uint32 version;
+			uintMem end;
+		};
+
+		BufferedReadStream* stream;
+		ContiguousReadStream* contiguousStream;
+		const byte* data;
+		uintMem size;
+		uintMem position;
+		//Position of the archive start in the stream, padding is counted from here
+		uintMem startPosition;
+		Array<Section> sections;
+		bool failed;
+
+		uintMem GetPosition() const;
+		bool SetPosition(uintMem position);
+	};
+
+	inline void WriteArchive::WriteBytes(const void* ptr, uintMem byteCount)
+	{
+		//Empty containers can have a null buffer
+		if (byteCount == 0)
+			return;
+
+		position += byteCount;
+
+		if (!sectionSizePositions.Empty())
+		{
+			if (sectionBuffer.Write(ptr, byteCount) != byteCount)
+				failed = true;
+		}
+		else if (stream.WriteBytes(ptr, byteCount) != byteCount)
+			failed = true;
+	}
+	inline void WriteArchive::WritePadding(uintMem alignment)
+	{
+		static constexpr byte zeros[64]{ };
+
+		uintMem padding = (alignment - position % alignment) % alignment;
+
+		while (padding != 0)
+		{
+			uintMem count = std::min(padding, sizeof(zeros));
+			WriteBytes(zeros, count);
+			padding -= count;
+		}
+	}
+	template<typename T> requires std::is_trivially_copyable_v<T>
+	inline void WriteArchive::WriteArray(const T* ptr, uintMem count)
+	{
+		WritePadding(alignof(T));
+		WriteBytes(ptr, count * sizeof(T));
+	}
+
+	inline void ReadArchive::ReadBytes(void* ptr, uintMem byteCount)
+	{
+		if (failed || byteCount == 0)
+			return;
+
+		if (data != nullptr)
+		{
+			if (size - position < byteCount)
+			{
+				failed = true;
+				return;
+			}
+
+			memcpy(ptr, data + position, byteCount);
+			position += byteCount;
+		}
+		else if (stream->ReadBytes(ptr, byteCount) != byteCount)
+			failed = true;
+	}
+	template<typename T> requires std::is_trivially_copyable_v<T>
+	inline void ReadArchive::ReadArray(T* ptr, uintMem count)
+	{
+		SkipPadding(alignof(T));
+		ReadBytes(ptr, count * sizeof(T));
+	}
+	template<typename T> requires std::is_trivially_copyable_v<T>
+	ArrayView<T> ReadArchive::ViewArray(uintMem count)
+	{
+		SkipPadding(alignof(T));
+
+		if (failed || data == nullptr || !CanRead(count, sizeof(T)) || (uintMem)(data + position) % alignof(T) != 0)
+		{
+			failed = true;
+			return ArrayView<T>();
+		}
+
+		ArrayView<T> view{ (const T*)(data + position), count };
+		position += count * sizeof(T);
+
+		return view;
+	}
+
+	template<typename T> requires std::is_trivially_copyable_v<T> || HasArchiveSerialize<T>
+	WriteArchive& operator<<(WriteArchive& archive, const T& value)
+	{
+		if constexpr (HasArchiveSerialize<T>)
+			value.Serialize(archive);
+		else
+			archive.WriteBytes(&value, sizeof(T));
+
+		return archive;
+	}
+	template<typename T> requires std::is_trivially_copyable_v<T> || HasArchiveDeserialize<T>
+	ReadArchive& operator>>(ReadArchive& archive, T& value)
+	{
+		if constexpr (HasArchiveDeserialize<T>)
+			value.Deserialize(archive);
+		else
+			archive.ReadBytes(&value, sizeof(T));
+
+		return archive;
+	}
+
+	template<typename T, AllocatorType Allocator>
+	WriteArchive& operator<<(WriteArchive& archive, const Array<T, Allocator>& array)
+	{
+		archive << (uint64)array.Count();
+
+		if constexpr (std::is_trivially_copyable_v<T> && !HasArchiveSerialize<T>)
+			archive.WriteArray(array.Ptr(), array.Count());
+		else
+			for (auto& element : array)
+				archive << element;
+
+		return archive;
+	}
+	template<typename T, AllocatorType Allocator>
+	ReadArchive& operator>>(ReadArchive& archive, Array<T, Allocator>& array)
+	{
+		uint64 count = 0;
+		archive >> count;
+
+		//Every element takes at least one byte, so this catches corrupted counts before allocating. Only elements
+		//that are copied as they are are known to take sizeof(T)
+		if (!archive.CanRead((uintMem)count, std::is_trivially_copyable_v<T> && !HasArchiveDeserialize<T> ? sizeof(T) : 1))
+			return archive;
+
+		array.Resize((uintMem)count);
+
+		if constexpr (std::is_trivially_copyable_v<T> && !HasArchiveDeserialize<T>)
+			archive.ReadArray(array.Ptr(), array.Count());
+		else
+			for (auto& element : array)
+				archive >> element;
+
+		return archive;
+	}
+
+	template<typename T> requires std::is_trivially_copyable_v<T>
+	WriteArchive& operator<<(WriteArchive& archive, const ArrayView<T>& array)
+	{
+		archive << (uint64)array.Count();
+		archive.WriteArray(array.Ptr(), array.Count());
+		return archive;
+	}
+	/*
+		Reads an array written as an Array or ArrayView without copying it, the archive must be reading from memory
+	*/
+	template<typename T> requires std::is_trivially_copyable_v<T>
+	ReadArchive& operator>>(ReadArchive& archive, ArrayView<T>& array)
+	{
+		uint64 count = 0;
+		archive >> count;
+
+		if (!archive.CanRead((uintMem)count, sizeof(T)))
+			return archive;
+
+		array = archive.ViewArray<T>((uintMem)count);
+		return archive;
+	}
+
+	inline WriteArchive& operator<<(WriteArchive& archive, const String& string)
+	{
+		archive << (uint64)string.Count();
+		archive.WriteBytes(string.Ptr(), string.Count());
+		return archive;
+	}
+	inline ReadArchive& operator>>(ReadArchive& archive, String& string)
+	{
+		uint64 count = 0;
+		archive >> count;
+
+		if (!archive.CanRead((uintMem)count, 1))
+			return archive;
+
+		string.Resize((uintMem)count);
+		archive.ReadBytes(string.Ptr(), string.Count());
+		return archive;
+	}
+
+	inline WriteArchive& operator<<(WriteArchive& archive, const StringUTF8& string)
+	{
+		archive << (uint64)string.BufferSize();
+		archive.WriteBytes(string.Buffer(), string.BufferSize());
+		return archive;
+	}
+	inline ReadArchive& operator>>(ReadArchive& archive, StringUTF8& string)
+	{
+		uint64 size = 0;
+		archive >> size;
+
+		if (!archive.CanRead((uintMem)size, 1))
+			return archive;
+
+		if (archive.IsReadingFromMemory())
+		{
+			ArrayView<byte> view = archive.ViewArray<byte>((uintMem)size);
+
+			if (!archive.Failed())
+				string = StringUTF8(view.Ptr(), view.Count());
+		}
+		else
+		{
+			String buffer{ (uintMem)size };
+			archive.ReadBytes(buffer.Ptr(), buffer.Count());
+
+			if (!archive.Failed())
+				string = StringUTF8((const void*)buffer.Ptr(), buffer.Count());
+		}
+
+		return archive;
+	}
+
+	template<typename Key, typename Value, typename Hasher, AllocatorType Allocator>
+	WriteArchive& operator<<(WriteArchive& archive, const Map<Key, Value, Hasher, Allocator>& map)
+	{
+		archive << (uint64)map.Count();
+
+		for (auto& pair : map)
+			archive << pair.key << pair.value;
+
+		return archive;
+	}
+	template<typename Key, typename Value, typename Hasher, AllocatorType Allocator>
+	ReadArchive& operator>>(ReadArchive& archive, Map<Key, Value, Hasher, Allocator>& map)
+	{
+		uint64 count = 0;
+		archive >> count;
+
+		if (!archive.CanRead((uintMem)count, 2))
+			return archive;
+
+		map.Clear();
+
+		for (uint64 i = 0; i < count && !archive.Failed(); ++i)
+		{
+			Key key{ };
+			Value value{ };
+			archive >> key >> value;
+
+			if (!archive.Failed())
+				map.Insert(key, std::move(value));
+		}
+
+		return archive;
+	}
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include "BlazeEngineCore/File/File.h"
+#include "BlazeEngineCore/DataStructures/Array.h"
+#include "BlazeEngineCore/DataStructures/ArrayView.h"
+
+namespace Blaze
+{
+	struct AsyncReadRequest;
+	class AsyncFileReaderBackend;
+
+	/*
+		Handle to a single read started by AsyncFileReader. Copies of the handle refer to the same read.
+	*/
+	class BLAZE_CORE_API AsyncReadHandle
+	{
+	public:
+		AsyncReadHandle();
+
+		bool IsValid() const;
+		bool IsFinished() const;
+		/*
+			Blocks until the read is finished and returns the number of bytes read. The read must be submitted
+			with AsyncFileReader::Submit, otherwise this waits forever.
+		*/
+		uintMem Wait() const;
+		/*
+			Registers a function that is called on the thread that finishes the read. No lock of the reader is held
+			while it runs, so it may submit more reads. Returns false without registering it if the read is already
+			finished. Only one function can be registered per read
+		*/
+		bool OnFinished(std::function<void()> function) const;
+
+		/*
+			The following functions are valid only after the read is finished. The read count is smaller than
+			the requested size if the end of the file was reached.
+		*/
+		bool Failed() const;
+		uintMem GetReadCount() const;
+		/*
+			Returns the data of a read that was given no buffer, the memory is owned by the handle. For other
+			reads it returns the given buffer.
+		*/
+		ArrayView<byte> GetData() const;
+	private:
+		std::shared_ptr<AsyncReadRequest> request;
+
+		AsyncReadHandle(std::shared_ptr<AsyncReadRequest> request);
+
+		friend class AsyncFileReader;
+	};
+
+	enum class AsyncFileReaderBackendType
+	{
+		ThreadPool,
+		IOUring,
+		IOCompletionPort,
+	};
+
+	/*
+		Reads files without blocking the calling thread. Reads are queued by ReadAsync and started together by
+		Submit, so a loader can queue reads for all of its files and have them run in parallel.
+
+		On Linux the reads go through io_uring. On Windows files opened by the reader are read with overlapped I/O
+		through an I/O completion port. Otherwise (io_uring isn't available, or the file was given by a
+		FileStreamBase on Windows) they are done with positional reads on a pool of worker threads.
+
+		Buffers given to ReadAsync and files given by FileStreamBase must stay valid until the read is finished.
+		The destructor waits for all submitted reads to finish.
+	*/
+	class BLAZE_CORE_API AsyncFileReader
+	{
+	public:
+		AsyncFileReader();
+		/*
+			'threadCount' is the number of worker threads used by the thread pool backend, 'queueDepth' is the
+			maximum number of reads that are in flight at the same time with the io_uring backend.
+		*/
+		AsyncFileReader(uint threadCount, uint queueDepth = 256);
+		AsyncFileReader(const AsyncFileReader&) = delete;
+		~AsyncFileReader();
+
+		/*
+			Reads 'size' bytes at 'offset' from an already opened file.
+		*/
+		AsyncReadHandle ReadAsync(const FileStreamBase& file, uintMem offset, void* buffer, uintMem size);
+		/*
+			Opens the file and reads 'size' bytes at 'offset'. The file is opened with the usage hint and is closed
+			when the read finishes.
+		*/
+		AsyncReadHandle ReadAsync(const Path& path, uintMem offset, void* buffer, uintMem size, FileUsageHint usageHint = FileUsageHint::Sequential);
+		/*
+			Opens the file and reads the whole file into memory owned by the returned handle.
+		*/
+		AsyncReadHandle ReadAsync(const Path& path, FileUsageHint usageHint = FileUsageHint::Sequential);
+
+		/*
+			Starts all reads queued since the last call.
+		*/
+		void Submit();
+
+		AsyncFileReaderBackendType GetBackendType() const;
+
+		AsyncFileReader& operator=(const AsyncFileReader&) = delete;
+	private:
+		AsyncFileReaderBackend* backend;
+
+		std::mutex pendingMutex;
+		Array<std::shared_ptr<AsyncReadRequest>> pending;
+
+		AsyncReadHandle Queue(std::shared_ptr<AsyncReadRequest> request);
+	};
+}
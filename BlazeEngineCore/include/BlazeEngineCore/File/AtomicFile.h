@@ -0,0 +1,93 @@
+#pragma once
+#include "BlazeEngineCore/File/Path.h"
+#include "BlazeEngineCore/File/Stream/FileStream.h"
+#include "BlazeEngineCore/DataStructures/Array.h"
+
+namespace Blaze
+{
+	class FileCommitGroup;
+
+#pragma warning( push )
+#pragma warning( disable : 4250)
+	/*
+		File that replaces the file at its path only when it is committed. Data is written to a temporary file in
+		the same directory which is synced to the disk and renamed over the target, so after a crash the target
+		has either its old or its new contents, never a mix of both.
+
+		On Linux the temporary file is created unnamed with O_TMPFILE when the file system supports it, so nothing
+		is left behind if the program crashes before committing. Files that are destroyed without being committed
+		are discarded.
+	*/
+	class BLAZE_CORE_API AtomicFile : public FileStream
+	{
+	public:
+		AtomicFile();
+		AtomicFile(AtomicFile&& other) noexcept;
+		AtomicFile(const Path& path);
+		~AtomicFile();
+
+		/*
+			Creates the temporary file. The target is not touched until Commit is called
+		*/
+		Result Open(const Path& path);
+		/*
+			Syncs the data, replaces the target and syncs its directory. The file is closed afterwards. Use a
+			FileCommitGroup to commit many files with fewer sync stalls
+		*/
+		Result Commit();
+		/*
+			Closes and removes the temporary file, the target is left as it was
+		*/
+		Result Discard();
+
+		inline const Path& GetPath() const { return path; }
+
+		AtomicFile& operator=(AtomicFile&& other) noexcept;
+	private:
+		Path path;
+		//Empty if the temporary file is unnamed
+		Path temporaryPath;
+
+		Result StartSync();
+		Result FinishSync();
+		Result ReplaceTarget();
+
+		friend class FileCommitGroup;
+	};
+#pragma warning( pop )
+
+	/*
+		Commits many atomic files together, for example everything saved in one frame. Writeback of all files is
+		started before waiting for any of them and every directory is synced once, instead of paying for a full
+		sync per file.
+
+		Files are replaced one by one, the group as a whole isn't atomic.
+	*/
+	class BLAZE_CORE_API FileCommitGroup
+	{
+	public:
+		FileCommitGroup();
+		FileCommitGroup(const FileCommitGroup&) = delete;
+		~FileCommitGroup();
+
+		/*
+			The file is committed by the next call to Commit
+		*/
+		void Add(AtomicFile&& file);
+		/*
+			Commits all added files. A file that fails to commit doesn't stop the others, the returned result holds
+			the errors of every file that failed
+		*/
+		Result Commit();
+		/*
+			Discards all added files
+		*/
+		void Clear();
+
+		inline uintMem GetFileCount() const { return files.Count(); }
+
+		FileCommitGroup& operator=(const FileCommitGroup&) = delete;
+	private:
+		Array<AtomicFile> files;
+	};
+}
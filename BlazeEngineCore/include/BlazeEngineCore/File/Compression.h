@@ -0,0 +1,44 @@
+#pragma once
+
+namespace Blaze
+{
+	enum class CompressionCodec : uint8
+	{
+		None,
+		BlazeLZ,
+	};
+
+	enum class CompressionLevel : uint8
+	{
+		//Single hash table probe per position, compresses at several hundred MB/s
+		Fast,
+		//Searches a hash chain for the longest match, several times slower but produces smaller output. Decompression
+		//speed is the same
+		High,
+	};
+
+	/*
+		The engine's own byte oriented LZ77 block codec. A block is a sequence of literal runs and back references
+		of at most 64 KB, with no frame, checksum or entropy coding, so decompression is a plain copy loop.
+
+		The format belongs to this engine and isn't compatible with LZ4, zstd or any other external format, blocks
+		are only ever read back by Decompress. 'High' spends more time searching for matches, it writes the same
+		format and isn't an entropy coded tier
+	*/
+	namespace BlazeLZ
+	{
+		/*
+			Size of the output buffer that is always big enough to compress 'size' bytes
+		*/
+		BLAZE_CORE_API uintMem CompressBound(uintMem size);
+		/*
+			Returns the size of the compressed data or 0 if it didn't fit into 'dstCapacity' bytes
+		*/
+		BLAZE_CORE_API uintMem Compress(const void* src, uintMem srcSize, void* dst, uintMem dstCapacity, CompressionLevel level = CompressionLevel::Fast);
+		/*
+			Returns false if the data is malformed or doesn't decompress to exactly 'dstSize' bytes. Malformed data
+			never causes reads or writes outside of the given buffers
+		*/
+		BLAZE_CORE_API bool Decompress(const void* src, uintMem srcSize, void* dst, uintMem dstSize);
+	}
+}
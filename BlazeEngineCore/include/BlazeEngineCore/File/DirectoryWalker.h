@@ -0,0 +1,96 @@
+#pragma once
+#include "BlazeEngineCore/File/Path.h"
+#include "BlazeEngineCore/DataStructures/Array.h"
+#include "BlazeEngineCore/DataStructures/ArrayView.h"
+#include "BlazeEngineCore/DataStructures/String.h"
+#include "BlazeEngineCore/DataStructures/StringView.h"
+
+namespace Blaze
+{
+	class JobSystem;
+
+	struct DirectoryEntryInfo
+	{
+		//Path relative to the walked directory, using '/' as the separator
+		String path;
+		//Zero for directories
+		uint64 size;
+		//Last modification time in platform specific units, it should only be compared to other modification times
+		uint64 modificationTime;
+		bool isDirectory;
+	};
+
+	/*
+		State of a directory tree at the time it was walked. Entries are sorted so that every directory is directly
+		followed by its contents.
+	*/
+	class BLAZE_CORE_API DirectorySnapshot
+	{
+	public:
+		DirectorySnapshot();
+
+		void Clear();
+
+		/*
+			Returns the entry with the given relative path or nullptr if there is none
+		*/
+		const DirectoryEntryInfo* Find(StringView path) const;
+
+		inline const Path& GetRoot() const { return root; }
+		inline ArrayView<DirectoryEntryInfo> GetEntries() const { return entries; }
+	private:
+		Path root;
+		uint64 rootModificationTime;
+		uint64 scanTime;
+		Array<DirectoryEntryInfo> entries;
+
+		friend class DirectoryWalker;
+	};
+
+	enum class DirectoryChangeType
+	{
+		Added,
+		Removed,
+		Modified,
+	};
+
+	struct DirectoryChange
+	{
+		DirectoryChangeType type;
+		//Path relative to the walked directory, using '/' as the separator
+		String path;
+		bool isDirectory;
+	};
+
+	/*
+		Walks directory trees in parallel. Directories are enumerated in batches (getdents64 on Linux,
+		FindFirstFileEx with large fetches on Windows) and every subdirectory is walked by its own job of a job
+		system.
+
+		Rescan compares the tree to an earlier snapshot. Directories whose modification time didn't change since the
+		snapshot have the same entries, so they aren't enumerated again and only their files are checked for size and
+		modification time changes. Directories changed shortly before the earlier snapshot was taken are always
+		enumerated because file systems store modification times with a limited precision.
+
+		Symbolic links to directories are not followed.
+	*/
+	class BLAZE_CORE_API DirectoryWalker
+	{
+	public:
+		/*
+			The workers of 'jobSystem' and the calling thread walk the tree together. Without a job system the tree
+			is walked on the calling thread only
+		*/
+		DirectoryWalker(JobSystem* jobSystem = nullptr);
+
+		Result Walk(const Path& directory, DirectorySnapshot& snapshot);
+		/*
+			Walks the directory of the snapshot again, updates the snapshot and appends the differences to 'changes'
+		*/
+		Result Rescan(DirectorySnapshot& snapshot, Array<DirectoryChange>& changes);
+	private:
+		JobSystem* jobSystem;
+
+		Result Walk(const Path& directory, const DirectorySnapshot* previous, DirectorySnapshot& snapshot);
+	};
+}
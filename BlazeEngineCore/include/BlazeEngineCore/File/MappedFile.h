@@ -0,0 +1,35 @@
+#pragma once
+#include "BlazeEngineCore/File/Path.h"
+#include "BlazeEngineCore/File/File.h"
+
+namespace Blaze
+{
+	/*
+		Read-only view of a whole file mapped into memory. Loaders can parse directly from the mapped memory instead
+		of reading the file into their own buffers. The usage hint is passed to the OS so it can read ahead
+		(Sequential) or avoid reading ahead (RandomAccess).
+	*/
+	class BLAZE_CORE_API MappedFile
+	{
+	public:
+		MappedFile();
+		MappedFile(MappedFile&& other) noexcept;
+		MappedFile(const Path& path, FileUsageHint usageHint = FileUsageHint::Normal);
+		~MappedFile();
+
+		Result Open(const Path& path, FileUsageHint usageHint = FileUsageHint::Normal);
+		Result Close();
+
+		inline bool IsOpen() const { return isOpen; }
+
+		inline const void* GetData() const { return data; }
+		inline uintMem GetSize() const { return size; }
+		inline ArrayView<byte> GetView() const { return ArrayView<byte>((const byte*)data, size); }
+
+		MappedFile& operator=(MappedFile&& other) noexcept;
+	private:
+		void* data;
+		uintMem size;
+		bool isOpen;
+	};
+}
@@ -0,0 +1,123 @@
+#pragma once
+#include "BlazeEngineCore/File/Path.h"
+#include "BlazeEngineCore/DataStructures/Array.h"
+#include "BlazeEngineCore/DataStructures/ArrayView.h"
+#include "BlazeEngineCore/DataStructures/String.h"
+#include "BlazeEngineCore/DataStructures/StringView.h"
+
+namespace Blaze
+{
+	/*
+		Pack file layout, all values are little endian and all offsets are from the start of the file:
+			PackFileHeader
+			PackFileEntry[entryCount], sorted by path hash
+			entry paths, not null terminated
+			entry data, each entry aligned to PackFileDataAlignment
+
+		Paths inside a pack use '/' as the separator and have no leading separator. Compressed entries store a
+		BlazeLZ block that decompresses to 'size' bytes.
+
+		There is a single compression tier. Packs are built offline, so entries are always compressed with the
+		High level, which costs nothing when loading. An entropy coded tier for rarely loaded assets would be a new
+		Compression value, older readers reject entries with values they don't know.
+	*/
+	namespace PackFileFormat
+	{
+		constexpr uint32 Magic = 0x4B504C42; //"BLPK"
+		constexpr uint32 Version = 1;
+		constexpr uintMem DataAlignment = 16;
+
+		enum class Compression : uint8
+		{
+			None,
+			BlazeLZ,
+		};
+
+		struct Header
+		{
+			uint32 magic;
+			uint32 version;
+			uint64 entryCount;
+			uint64 entriesOffset;
+			uint64 pathsOffset;
+			uint64 pathsSize;
+			//Hash of the entry table, it includes the content hash of every entry
+			uint64 tableHash;
+		};
+
+		struct Entry
+		{
+			uint64 pathHash;
+			uint64 pathOffset;
+			uint64 dataOffset;
+			uint64 size;
+			//Size of the data in the pack, equal to 'size' for uncompressed entries
+			uint64 storedSize;
+			//Hash of the data as it is stored in the pack
+			uint64 contentHash;
+			uint32 pathSize;
+			Compression compression;
+			uint8 reserved[3];
+		};
+
+		static_assert(sizeof(Header) == 48);
+		static_assert(sizeof(Entry) == 56);
+
+		/*
+			64-bit FNV-1a, used for both path and content hashes. It is part of the format so it must not change
+		*/
+		BLAZE_CORE_API uint64 Hash(const void* data, uintMem size, uint64 hash = 14695981039346656037ull);
+		/*
+			Hashes the path after converting '\' to '/' and removing leading separators
+		*/
+		BLAZE_CORE_API uint64 HashPath(StringView path);
+		BLAZE_CORE_API String NormalizePath(StringView path);
+	}
+
+	/*
+		Collects files and writes them into a single pack file that can be read with PackFileSystem. The pack is
+		written as an AtomicFile, so an existing pack is only replaced once the new one is complete.
+
+		Files added with BlazeLZ compression are stored compressed unless that doesn't make them smaller.
+	*/
+	class BLAZE_CORE_API PackFileBuilder
+	{
+	public:
+		PackFileBuilder();
+		~PackFileBuilder();
+
+		/*
+			Adds a file from the disk, it is read when the pack is built
+		*/
+		Result AddFile(StringView packPath, const Path& sourcePath, PackFileFormat::Compression compression = PackFileFormat::Compression::None);
+		/*
+			Adds a file with the given contents, the data is copied
+		*/
+		Result AddData(StringView packPath, ArrayView<byte> data, PackFileFormat::Compression compression = PackFileFormat::Compression::None);
+		/*
+			Adds all files in the directory and its subdirectories. Their pack paths are their paths relative to
+			'directory' prefixed by 'packPrefix'
+		*/
+		Result AddDirectory(const Path& directory, StringView packPrefix = StringView(), PackFileFormat::Compression compression = PackFileFormat::Compression::None);
+
+		/*
+			Fails without writing anything if two files were added with the same pack path
+		*/
+		Result Build(const Path& outputPath);
+
+		inline uintMem GetEntryCount() const { return entries.Count(); }
+	private:
+		struct BuilderEntry
+		{
+			String packPath;
+			Path sourcePath;
+			Array<byte> data;
+			bool fromFile;
+			PackFileFormat::Compression compression;
+		};
+
+		Array<BuilderEntry> entries;
+
+		Result AddEntry(BuilderEntry&& entry);
+	};
+}
@@ -0,0 +1,108 @@
+#pragma once
+#include "BlazeEngineCore/File/PackFile.h"
+#include "BlazeEngineCore/File/MappedFile.h"
+#include "BlazeEngineCore/File/Stream/ContiguousReadStream.h"
+
+namespace Blaze
+{
+	/*
+		Read stream over a single file inside a PackFileSystem. Uncompressed files are read directly from the mapped
+		pack and the stream is valid only while the pack file system is open. Compressed files are decompressed into
+		a buffer owned by the stream when it is opened.
+	*/
+	class BLAZE_CORE_API PackFileReadStream : public ContiguousReadStream
+	{
+	public:
+		PackFileReadStream();
+		PackFileReadStream(ArrayView<byte> data);
+		~PackFileReadStream();
+
+		bool MovePosition(intMem offset) override;
+		bool SetPosition(uintMem offset) override;
+		bool SetPositionFromEnd(intMem offset) override;
+		uintMem GetPosition() const override;
+		uintMem GetSize() const override;
+
+		uintMem Read(void* ptr, uintMem byteCount) override;
+
+		ArrayView<byte> TryGetContiguous(uintMem byteCount) override;
+		bool Consume(uintMem byteCount) override;
+
+		/*
+			Returns the file data from the current position to the end of the file
+		*/
+		inline ArrayView<byte> GetRemaining() const { return ArrayView<byte>(data.Ptr() + position, data.Count() - position); }
+	private:
+		ArrayView<byte> data;
+		uintMem position;
+		//Holds the data of compressed files
+		Array<byte> buffer;
+
+		friend class PackFileSystem;
+	};
+
+	/*
+		Serves files from a pack file built by PackFileBuilder. The whole pack is mapped into memory once, files are
+		looked up by a binary search of the table of contents and their data is returned without copying, so loading
+		a file costs no system calls.
+
+		Paths are normalized the same way as when the pack was built. Compressed files can't be returned in place,
+		they are read with ReadFile or OpenStream.
+	*/
+	class BLAZE_CORE_API PackFileSystem
+	{
+	public:
+		PackFileSystem();
+		PackFileSystem(const PackFileSystem&) = delete;
+		PackFileSystem(PackFileSystem&& other) noexcept;
+		PackFileSystem(const Path& path);
+		~PackFileSystem();
+
+		/*
+			Maps the pack and validates its header and table of contents. File contents are not validated, use
+			VerifyFile for that
+		*/
+		Result Open(const Path& path);
+		Result Close();
+
+		inline bool IsOpen() const { return file.IsOpen(); }
+
+		bool Contains(StringView path) const;
+		/*
+			Returns a view to the file data directly in the mapped pack, or an empty view if the file isn't in the
+			pack or is compressed. The view is valid while the pack is open
+		*/
+		ArrayView<byte> GetFileData(StringView path) const;
+		/*
+			Copies the file data into 'data', decompressing it if needed
+		*/
+		Result ReadFile(StringView path, Array<byte>& data) const;
+		Result OpenStream(StringView path, PackFileReadStream& stream) const;
+
+		/*
+			Compares the content hash stored in the pack to the hash of the file data as it is stored in the pack
+		*/
+		bool VerifyFile(StringView path) const;
+
+		inline uintMem GetFileCount() const { return entryCount; }
+		/*
+			Files are ordered by their path hashes, not by their paths
+		*/
+		StringView GetFilePath(uintMem index) const;
+		ArrayView<byte> GetFileData(uintMem index) const;
+
+		PackFileSystem& operator=(const PackFileSystem&) = delete;
+		PackFileSystem& operator=(PackFileSystem&& other) noexcept;
+	private:
+		MappedFile file;
+		const PackFileFormat::Entry* entries;
+		uintMem entryCount;
+
+		const PackFileFormat::Entry* FindEntry(StringView path) const;
+		//Empty for compressed entries
+		ArrayView<byte> GetEntryData(const PackFileFormat::Entry& entry) const;
+		ArrayView<byte> GetStoredEntryData(const PackFileFormat::Entry& entry) const;
+		Result DecompressEntry(const PackFileFormat::Entry& entry, Array<byte>& data) const;
+		StringView GetEntryPath(const PackFileFormat::Entry& entry) const;
+	};
+}
@@ -1,17 +1,22 @@
 #pragma once
 #include "BlazeEngineCore/File/Stream/Stream.h"
+#include "BlazeEngineCore/File/Stream/ContiguousReadStream.h"
 
 namespace Blaze
 {
 #pragma warning( push )
-#pragma warning( disable : 4250)	
+#pragma warning( disable : 4250)
+	/*
+		Stream over a memory buffer. Buffers passed by the user are not owned by the stream, buffers allocated by the
+		stream are freed when it is cleared or destroyed.
+	*/
 	class BLAZE_CORE_API BufferStreamBase : virtual public StreamBase
 	{
 	public:
 		BufferStreamBase();
 		BufferStreamBase(uintMem size);
 		BufferStreamBase(void* buffer, uintMem size);
-		BufferStreamBase(const FileStreamBase&) = delete;
+		BufferStreamBase(const BufferStreamBase&) = delete;
 		~BufferStreamBase();
 
 		Result SetBuffer(void* buffer, uintMem size);
@@ -19,16 +24,18 @@ namespace Blaze
 
 		bool MovePosition(intMem offset) override;
 		bool SetPosition(uintMem offset) override;
+		bool SetPositionFromEnd(intMem offset) override;
 		uintMem GetPosition() const override;
 
 		uintMem GetSize() const override;
 		const void* GetBuffer() const;
 
-		FileStreamBase& operator=(const FileStreamBase&) = delete;
+		BufferStreamBase& operator=(const BufferStreamBase&) = delete;
 	protected:
 		void* buffer;
 		uintMem size;
 		uintMem position;
+		bool ownsBuffer;
 	};
 
 	class BLAZE_CORE_API BufferWriteStream : virtual public BufferStreamBase, virtual public WriteStream
@@ -39,25 +46,31 @@ namespace Blaze
 		BufferWriteStream(void* buffer, uintMem size);
 		~BufferWriteStream();
 
+		/*
+			Writing past the end of the buffer replaces it with a bigger buffer owned by the stream
+		*/
 		uintMem Write(const void* ptr, uintMem byteCount) override;
 
 		using BufferStreamBase::GetBuffer;
 	};
 
-	class BLAZE_CORE_API BufferReadStream : virtual public BufferStreamBase, virtual public ReadStream
+	class BLAZE_CORE_API BufferReadStream : virtual public BufferStreamBase, virtual public ContiguousReadStream
 	{
 	public:
 		BufferReadStream();
 		BufferReadStream(uintMem size);
-		BufferReadStream(void* buffer, uintMem size);
+		BufferReadStream(const void* buffer, uintMem size);
 		~BufferReadStream();
 
 		uintMem Read(void* ptr, uintMem byteCount) override;
+
+		ArrayView<byte> TryGetContiguous(uintMem byteCount) override;
+		bool Consume(uintMem byteCount) override;
 	};
 
 	class BufferStream : public BufferReadStream, public BufferWriteStream
 	{
 
 	};
-#pragma warning( pop ) 
-}
\ No newline at end of file
+#pragma warning( pop )
+}
@@ -0,0 +1,185 @@
+#pragma once
+#include "BlazeEngineCore/File/Stream/Stream.h"
+#include "BlazeEngineCore/File/Stream/ContiguousReadStream.h"
+
+namespace Blaze
+{
+	/*
+		Adaptor that reads the wrapped stream in large blocks. Small fixed size reads through ReadValue, ReadArray
+		or operator>> are inlined copies out of the buffer and only go to the wrapped stream when the buffer is
+		exhausted. The wrapped stream must outlive the adaptor and shouldn't be used while the adaptor is in use.
+
+		The buffer is exposed through ContiguousReadStream, so parsers can read anything up to the buffer size in place.
+	*/
+	class BLAZE_CORE_API BufferedReadStream : public ContiguousReadStream
+	{
+	public:
+		static constexpr uintMem DefaultBufferSize = 64 * 1024;
+
+		BufferedReadStream(ReadStream& stream, uintMem bufferSize = DefaultBufferSize);
+		BufferedReadStream(const BufferedReadStream&) = delete;
+		~BufferedReadStream();
+
+		bool MovePosition(intMem offset) override;
+		bool SetPosition(uintMem offset) override;
+		bool SetPositionFromEnd(intMem offset) override;
+		uintMem GetPosition() const override;
+		uintMem GetSize() const override;
+
+		uintMem Read(void* ptr, uintMem byteCount) override;
+
+		/*
+			Refills the buffer if needed. Returns an empty view if 'byteCount' is larger than the buffer or if fewer
+			bytes are left in the wrapped stream
+		*/
+		ArrayView<byte> TryGetContiguous(uintMem byteCount) override;
+		bool Consume(uintMem byteCount) override;
+
+		/*
+			Non-virtual equivalent of Read
+		*/
+		inline uintMem ReadBytes(void* ptr, uintMem byteCount);
+		/*
+			Returns false if the whole value couldn't be read
+		*/
+		template<typename T> requires std::is_trivially_copyable_v<T>
+		inline bool ReadValue(T& value);
+		/*
+			Returns the number of whole elements read
+		*/
+		template<typename T> requires std::is_trivially_copyable_v<T>
+		inline uintMem ReadArray(T* ptr, uintMem count);
+
+		inline ReadStream& GetStream() const { return *stream; }
+
+		BufferedReadStream& operator=(const BufferedReadStream&) = delete;
+	private:
+		ReadStream* stream;
+		byte* buffer;
+		uintMem bufferSize;
+		uintMem bufferPosition;
+		uintMem bufferEnd;
+
+		uintMem ReadSlow(void* ptr, uintMem byteCount);
+		void DiscardBuffer();
+	};
+
+	/*
+		Adaptor that collects writes into a buffer and passes them to the wrapped stream in large blocks. Small
+		fixed size writes through WriteValue, WriteArray or operator<< are inlined copies into the buffer. The
+		buffer is flushed when it's full, before any seek and when the adaptor is destroyed. The wrapped stream must
+		outlive the adaptor and shouldn't be used while the adaptor is in use.
+	*/
+	class BLAZE_CORE_API BufferedWriteStream : public WriteStream
+	{
+	public:
+		static constexpr uintMem DefaultBufferSize = 64 * 1024;
+
+		BufferedWriteStream(WriteStream& stream, uintMem bufferSize = DefaultBufferSize);
+		BufferedWriteStream(const BufferedWriteStream&) = delete;
+		~BufferedWriteStream();
+
+		/*
+			Writes all buffered data to the wrapped stream. Returns false if not all of it could be written
+		*/
+		bool Flush();
+
+		bool MovePosition(intMem offset) override;
+		bool SetPosition(uintMem offset) override;
+		bool SetPositionFromEnd(intMem offset) override;
+		uintMem GetPosition() const override;
+		uintMem GetSize() const override;
+
+		uintMem Write(const void* ptr, uintMem byteCount) override;
+
+		/*
+			Non-virtual equivalent of Write
+		*/
+		inline uintMem WriteBytes(const void* ptr, uintMem byteCount);
+		/*
+			Returns false if the whole value couldn't be written
+		*/
+		template<typename T> requires std::is_trivially_copyable_v<T>
+		inline bool WriteValue(const T& value);
+		/*
+			Returns the number of whole elements written
+		*/
+		template<typename T> requires std::is_trivially_copyable_v<T>
+		inline uintMem WriteArray(const T* ptr, uintMem count);
+		template<typename T> requires std::is_trivially_copyable_v<T>
+		inline uintMem WriteArray(ArrayView<T> array);
+
+		inline WriteStream& GetStream() const { return *stream; }
+
+		BufferedWriteStream& operator=(const BufferedWriteStream&) = delete;
+	private:
+		WriteStream* stream;
+		byte* buffer;
+		uintMem bufferSize;
+		uintMem bufferPosition;
+
+		uintMem WriteSlow(const void* ptr, uintMem byteCount);
+	};
+
+	inline uintMem BufferedReadStream::ReadBytes(void* ptr, uintMem byteCount)
+	{
+		if (bufferEnd - bufferPosition >= byteCount)
+		{
+			memcpy(ptr, buffer + bufferPosition, byteCount);
+			bufferPosition += byteCount;
+			return byteCount;
+		}
+
+		return ReadSlow(ptr, byteCount);
+	}
+	template<typename T> requires std::is_trivially_copyable_v<T>
+	inline bool BufferedReadStream::ReadValue(T& value)
+	{
+		return ReadBytes(&value, sizeof(T)) == sizeof(T);
+	}
+	template<typename T> requires std::is_trivially_copyable_v<T>
+	inline uintMem BufferedReadStream::ReadArray(T* ptr, uintMem count)
+	{
+		return ReadBytes(ptr, count * sizeof(T)) / sizeof(T);
+	}
+
+	inline uintMem BufferedWriteStream::WriteBytes(const void* ptr, uintMem byteCount)
+	{
+		if (bufferSize - bufferPosition >= byteCount)
+		{
+			memcpy(buffer + bufferPosition, ptr, byteCount);
+			bufferPosition += byteCount;
+			return byteCount;
+		}
+
+		return WriteSlow(ptr, byteCount);
+	}
+	template<typename T> requires std::is_trivially_copyable_v<T>
+	inline bool BufferedWriteStream::WriteValue(const T& value)
+	{
+		return WriteBytes(&value, sizeof(T)) == sizeof(T);
+	}
+	template<typename T> requires std::is_trivially_copyable_v<T>
+	inline uintMem BufferedWriteStream::WriteArray(const T* ptr, uintMem count)
+	{
+		return WriteBytes(ptr, count * sizeof(T)) / sizeof(T);
+	}
+	template<typename T> requires std::is_trivially_copyable_v<T>
+	inline uintMem BufferedWriteStream::WriteArray(ArrayView<T> array)
+	{
+		return WriteArray(array.Ptr(), array.Count());
+	}
+
+	template<typename T> requires std::is_trivially_copyable_v<T>
+	BufferedReadStream& operator>>(BufferedReadStream& stream, T& value)
+	{
+		stream.ReadValue(value);
+		return stream;
+	}
+	template<typename T> requires std::is_trivially_copyable_v<T>
+	BufferedWriteStream& operator<<(BufferedWriteStream& stream, const T& value)
+	{
+		stream.WriteValue(value);
+		return stream;
+	}
+}
@@ -0,0 +1,193 @@
+#pragma once
+#include "BlazeEngineCore/File/Stream/Stream.h"
+#include "BlazeEngineCore/File/Stream/ContiguousReadStream.h"
+#include "BlazeEngineCore/File/Compression.h"
+#include "BlazeEngineCore/DataStructures/Array.h"
+
+namespace Blaze
+{
+	class JobSystem;
+
+	/*
+		Compressed stream layout, all values are little endian and all offsets are from the start of the compressed
+		stream:
+			Header
+			compressed blocks
+			BlockEntry[blockCount]
+			Footer
+
+		Every block except the last one holds 'blockSize' uncompressed bytes and is compressed independently, so
+		any block can be decompressed without the ones before it.
+	*/
+	namespace CompressedStreamFormat
+	{
+		constexpr uint32 Magic = 0x5A4C4C42; //"BLLZ"
+		constexpr uint32 Version = 1;
+
+		enum class BlockFlags : uint32
+		{
+			None = 0,
+			//The block didn't compress and is stored as is
+			Uncompressed = 1,
+		};
+
+		struct Header
+		{
+			uint32 magic;
+			uint32 version;
+			CompressionCodec codec;
+			uint8 reserved[3];
+			uint32 blockSize;
+		};
+
+		struct BlockEntry
+		{
+			uint64 offset;
+			uint32 storedSize;
+			BlockFlags flags;
+		};
+
+		struct Footer
+		{
+			uint64 indexOffset;
+			uint64 blockCount;
+			uint64 uncompressedSize;
+			uint32 magic;
+			uint32 reserved;
+		};
+
+		static_assert(sizeof(Header) == 16);
+		static_assert(sizeof(BlockEntry) == 16);
+		static_assert(sizeof(Footer) == 32);
+	}
+
+	/*
+		Compresses everything written to it into the wrapped stream. Data is collected into blocks. Without a job
+		system every block is compressed when it is full, with one a batch of blocks, one for each worker and one
+		for the writing thread, is collected and compressed in parallel by the job system. Writes bigger than a
+		batch are compressed directly from the given memory.
+
+		The block index is written by Finish, which is also called by the destructor. The stream can't seek.
+		The wrapped stream must outlive the compressed stream and shouldn't be used until it is finished.
+	*/
+	class BLAZE_CORE_API CompressedWriteStream : public WriteStream
+	{
+	public:
+		static constexpr uintMem DefaultBlockSize = 256 * 1024;
+
+		CompressedWriteStream(WriteStream& stream, CompressionLevel level = CompressionLevel::Fast, uintMem blockSize = DefaultBlockSize, JobSystem* jobSystem = nullptr);
+		CompressedWriteStream(const CompressedWriteStream&) = delete;
+		~CompressedWriteStream();
+
+		/*
+			Compresses the remaining data and writes the block index. Nothing can be written afterwards
+		*/
+		Result Finish();
+
+		/*
+			Only succeed if they don't move the position
+		*/
+		bool MovePosition(intMem offset) override;
+		bool SetPosition(uintMem offset) override;
+		bool SetPositionFromEnd(intMem offset) override;
+		/*
+			Both return the number of uncompressed bytes written
+		*/
+		uintMem GetPosition() const override;
+		uintMem GetSize() const override;
+
+		uintMem Write(const void* ptr, uintMem byteCount) override;
+
+		inline uint64 GetCompressedSize() const { return compressedSize; }
+		inline bool IsFinished() const { return finished; }
+		inline bool Failed() const { return failed; }
+
+		CompressedWriteStream& operator=(const CompressedWriteStream&) = delete;
+	private:
+		WriteStream* stream;
+		CompressionLevel level;
+		uintMem blockSize;
+		JobSystem* jobSystem;
+		uint batchBlockCount;
+
+		byte* batchBuffer;
+		uintMem batchSize;
+		//CompressBound(blockSize) bytes for each block of a batch
+		byte* compressedBuffer;
+		uintMem compressedBlockCapacity;
+
+		Array<CompressedStreamFormat::BlockEntry> blocks;
+		uint64 uncompressedSize;
+		uint64 compressedSize;
+		bool finished;
+		bool failed;
+
+		/*
+			Compresses up to 'batchBlockCount' blocks and writes them in order. Every block except the last one must be
+			whole
+		*/
+		Result CompressBlocks(const byte* data, uintMem size);
+		Result WriteData(const void* ptr, uintMem byteCount);
+	};
+
+	/*
+		Reads a stream written by CompressedWriteStream. The block index is read when the stream is opened, so seeking
+		decompresses only the block containing the new position. The last decompressed block is kept and exposed
+		through ContiguousReadStream, data spanning two blocks isn't available contiguously.
+
+		The compressed data is expected to start at the current position of the wrapped stream and end at its end,
+		use a ReadSubStream for compressed data embedded in a bigger stream. The wrapped stream must outlive the
+		decompressing stream and shouldn't be used while it's open.
+	*/
+	class BLAZE_CORE_API DecompressingReadStream : public ContiguousReadStream
+	{
+	public:
+		DecompressingReadStream();
+		DecompressingReadStream(ReadStream& stream);
+		DecompressingReadStream(const DecompressingReadStream&) = delete;
+		~DecompressingReadStream();
+
+		Result Open(ReadStream& stream);
+		void Close();
+
+		inline bool IsOpen() const { return stream != nullptr; }
+
+		bool MovePosition(intMem offset) override;
+		bool SetPosition(uintMem offset) override;
+		bool SetPositionFromEnd(intMem offset) override;
+		uintMem GetPosition() const override;
+		uintMem GetSize() const override;
+
+		/*
+			Stops at the first block that fails to decompress
+		*/
+		uintMem Read(void* ptr, uintMem byteCount) override;
+
+		/*
+			Returns an empty view if the bytes don't lie in a single block
+		*/
+		ArrayView<byte> TryGetContiguous(uintMem byteCount) override;
+		bool Consume(uintMem byteCount) override;
+
+		inline uintMem GetBlockSize() const { return blockSize; }
+		inline uintMem GetBlockCount() const { return blocks.Count(); }
+
+		DecompressingReadStream& operator=(const DecompressingReadStream&) = delete;
+	private:
+		ReadStream* stream;
+		uint64 baseOffset;
+		uintMem blockSize;
+		uint64 size;
+		uint64 position;
+		Array<CompressedStreamFormat::BlockEntry> blocks;
+
+		byte* blockBuffer;
+		byte* compressedBuffer;
+		uintMem compressedBufferSize;
+		uintMem bufferedBlockIndex;
+
+		uintMem GetBlockDataSize(uintMem index) const;
+		Result DecompressBlock(uintMem index, byte* dst);
+		bool LoadBlock(uintMem index);
+	};
+}
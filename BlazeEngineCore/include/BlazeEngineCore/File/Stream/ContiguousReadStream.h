@@ -0,0 +1,31 @@
+#pragma once
+#include "BlazeEngineCore/File/Stream/Stream.h"
+#include "BlazeEngineCore/DataStructures/ArrayView.h"
+
+namespace Blaze
+{
+	/*
+		Read stream whose data is available in memory. Parsers can check for it with dynamic_cast and read directly
+		from the memory instead of copying every field out with Read:
+
+			if (auto contiguousStream = dynamic_cast<ContiguousReadStream*>(&stream))
+			{
+				ArrayView<byte> data = contiguousStream->TryGetContiguous(sizeof(Header));
+				...
+				contiguousStream->Consume(sizeof(Header));
+			}
+	*/
+	class ContiguousReadStream : public ReadStream
+	{
+	public:
+		/*
+			Returns a view to the next 'byteCount' bytes without moving the position, or an empty view if they aren't
+			available. The view is valid until the stream is changed in any way other than by Consume
+		*/
+		virtual ArrayView<byte> TryGetContiguous(uintMem byteCount) = 0;
+		/*
+			Moves the position forward past data returned by TryGetContiguous. Returns false if fewer bytes are left
+		*/
+		virtual bool Consume(uintMem byteCount) = 0;
+	};
+}
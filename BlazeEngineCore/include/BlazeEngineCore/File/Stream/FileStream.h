@@ -10,10 +10,21 @@ namespace Blaze
 	public:
 		FileStreamBase();
 		FileStreamBase(FileStreamBase&& other) noexcept;
+#ifdef BLAZE_PLATFORM_WINDOWS
 		FileStreamBase(void* file);
+#elif defined(BLAZE_PLATFORM_LINUX)
+		FileStreamBase(int fileDescriptor);
+#endif
 		~FileStreamBase();
 
+#ifdef BLAZE_PLATFORM_WINDOWS
 		Result Open(void* file);
+#elif defined(BLAZE_PLATFORM_LINUX)
+		/*
+			The stream takes ownership of the file descriptor
+		*/
+		Result Open(int fileDescriptor);
+#endif
 		bool IsOpen() const;
 
 		Result Close();
@@ -26,13 +37,28 @@ namespace Blaze
 
 		uintMem GetSize() const override;
 
+#ifdef BLAZE_PLATFORM_WINDOWS
 		inline void* GetHandle() const { return file; }
 
 		inline uint32 Hash() const { return static_cast<uint32>(reinterpret_cast<uintMem>(file)); }
+#elif defined(BLAZE_PLATFORM_LINUX)
+		inline int GetFileDescriptor() const { return fileDescriptor; }
+
+		inline uint32 Hash() const { return static_cast<uint32>(fileDescriptor); }
+#endif
 
 		FileStreamBase& operator=(FileStreamBase&& other) noexcept;
 	private:
+#ifdef BLAZE_PLATFORM_WINDOWS
 		void* file;
+#elif defined(BLAZE_PLATFORM_LINUX)
+		int fileDescriptor;
+		//Reads and writes are done with pread and pwrite at this position, so moving it doesn't need a system call
+		uintMem position;
+
+		friend class FileWriteStream;
+		friend class FileReadStream;
+#endif
 	};
 
 	class BLAZE_CORE_API FileWriteStream : virtual public FileStreamBase, virtual public WriteStream
@@ -0,0 +1,48 @@
+#pragma once
+#include "BlazeEngineCore/File/Stream/ContiguousReadStream.h"
+#include "BlazeEngineCore/File/MappedFile.h"
+
+namespace Blaze
+{
+	/*
+		Read stream over a mapped file. Reading is a copy out of the mapped memory without a system call, loaders that
+		can work on memory directly should use GetRemaining or TryGetContiguous instead.
+	*/
+	class BLAZE_CORE_API MappedFileReadStream : public ContiguousReadStream
+	{
+	public:
+		MappedFileReadStream();
+		MappedFileReadStream(MappedFileReadStream&& other) noexcept;
+		MappedFileReadStream(const Path& path, FileUsageHint usageHint = FileUsageHint::Sequential);
+		MappedFileReadStream(MappedFile&& file);
+		~MappedFileReadStream();
+
+		Result Open(const Path& path, FileUsageHint usageHint = FileUsageHint::Sequential);
+		Result Open(MappedFile&& file);
+		Result Close();
+
+		inline bool IsOpen() const { return file.IsOpen(); }
+
+		bool MovePosition(intMem offset) override;
+		bool SetPosition(uintMem offset) override;
+		bool SetPositionFromEnd(intMem offset) override;
+		uintMem GetPosition() const override;
+		uintMem GetSize() const override;
+
+		uintMem Read(void* ptr, uintMem byteCount) override;
+
+		ArrayView<byte> TryGetContiguous(uintMem byteCount) override;
+		bool Consume(uintMem byteCount) override;
+
+		/*
+			Returns the mapped memory from the current position to the end of the file
+		*/
+		inline ArrayView<byte> GetRemaining() const { return ArrayView<byte>((const byte*)file.GetData() + position, file.GetSize() - position); }
+		inline const MappedFile& GetFile() const { return file; }
+
+		MappedFileReadStream& operator=(MappedFileReadStream&& other) noexcept;
+	private:
+		MappedFile file;
+		uintMem position;
+	};
+}
@@ -1,11 +1,17 @@
 #pragma once
 #include "BlazeEngineCore/File/Stream/Stream.h"
+#include "BlazeEngineCore/File/Stream/ContiguousReadStream.h"
 
 namespace Blaze
 {
-	class ReadSubStream : public ReadStream
+	/*
+		Read stream over a range of another stream. If the parent stream is a ContiguousReadStream the sub stream
+		gives contiguous access to its range too.
+	*/
+	class BLAZE_CORE_API ReadSubStream : public ContiguousReadStream
 	{
 		ReadStream* parentStream;
+		ContiguousReadStream* contiguousParentStream;
 		uintMem offset;
 		uintMem size;
 	public:
@@ -18,5 +24,11 @@ namespace Blaze
 		uintMem GetSize() const override;
 
 		uintMem Read(void* ptr, uintMem byteCount) override;
+
+		/*
+			Returns an empty view if the parent stream isn't a ContiguousReadStream
+		*/
+		ArrayView<byte> TryGetContiguous(uintMem byteCount) override;
+		bool Consume(uintMem byteCount) override;
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,121 @@
+#pragma once
+#include "BlazeEngineCore/Threading/Thread.h"
+#include "BlazeEngineCore/Threading/SyncPrimitives.h"
+#include "BlazeEngineCore/DataStructures/Array.h"
+#include "BlazeEngineCore/DataStructures/ArrayView.h"
+#include <atomic>
+#include <condition_variable>
+
+namespace Blaze
+{
+	struct Job;
+	class JobSystem;
+	class JobWorkQueue;
+
+	/*
+		Reference to a scheduled job. The job is kept alive while any handle to it exists, so a handle can be waited
+		on or used as a dependency even after the job has finished.
+	*/
+	class BLAZE_CORE_API JobHandle
+	{
+	public:
+		JobHandle();
+		JobHandle(const JobHandle& other);
+		JobHandle(JobHandle&& other) noexcept;
+		~JobHandle();
+
+		bool IsValid() const { return job != nullptr; }
+		/*
+			Invalid handles count as finished
+		*/
+		bool IsFinished() const;
+
+		JobHandle& operator=(const JobHandle& other);
+		JobHandle& operator=(JobHandle&& other) noexcept;
+	private:
+		Job* job;
+
+		JobHandle(Job* job);
+
+		friend class JobSystem;
+	};
+
+	/*
+		Fixed pool of worker threads that run jobs. Every worker owns a work stealing deque, jobs scheduled from a
+		worker go to its own deque and idle workers steal from the others. Jobs scheduled from other threads go to
+		a shared queue.
+
+		Threads that wait for a job run other jobs in the meantime instead of blocking, so jobs may wait for other
+		jobs and the main thread takes part in the work while it waits.
+	*/
+	class BLAZE_CORE_API JobSystem
+	{
+	public:
+		/*
+			'workerCount' 0 uses one worker less than there are hardware threads, leaving one for the thread that
+			creates the job system
+		*/
+		JobSystem(uint workerCount = 0);
+		JobSystem(const JobSystem&) = delete;
+		/*
+			Runs all scheduled jobs before stopping the workers
+		*/
+		~JobSystem();
+
+		JobHandle Schedule(std::function<void()> function);
+		/*
+			The job starts only after all 'dependencies' have finished. Invalid handles are ignored
+		*/
+		JobHandle Schedule(std::function<void()> function, ArrayView<JobHandle> dependencies);
+
+		/*
+			Runs other jobs on the calling thread until the job finishes
+		*/
+		void Wait(const JobHandle& job);
+		void Wait(ArrayView<JobHandle> jobs);
+		/*
+			Runs other jobs on the calling thread until 'counter' reaches 0. For jobs that schedule more work while
+			they run, so there are no handles to wait on up front. Whoever sets the counter to 0 has to call
+			notify_all on it
+		*/
+		void Wait(const std::atomic<uint32>& counter);
+
+		/*
+			Calls 'function' with ranges [begin, end) covering [0, count) in parallel and returns when all of them
+			are done. Ranges hold 'grainSize' indices except the last one, 'grainSize' 0 picks a size that gives
+			every thread a few ranges. The calling thread takes part in the work
+		*/
+		void ParallelFor(uintMem count, uintMem grainSize, const std::function<void(uintMem begin, uintMem end)>& function);
+
+		inline uint GetWorkerCount() const { return workerCount; }
+		/*
+			Returns the index of the calling worker thread of this job system or -1 if the calling thread isn't one
+		*/
+		int GetCurrentWorkerIndex() const;
+
+		JobSystem& operator=(const JobSystem&) = delete;
+	private:
+		uint workerCount;
+		JobWorkQueue* workQueues;
+		Array<Thread> threads;
+
+		AdaptiveMutex sharedQueueMutex;
+		Array<Job*> sharedQueue;
+		uintMem sharedQueueHead;
+		//Checked before locking the shared queue, so idle workers don't contend on the mutex
+		std::atomic<uintMem> sharedQueueSize;
+
+		std::mutex sleepMutex;
+		std::condition_variable sleepCondition;
+		std::atomic<uint64> workVersion;
+		std::atomic<uint> sleepingWorkerCount;
+		std::atomic<bool> stopping;
+
+		int WorkerProc(uint workerIndex);
+
+		void Enqueue(Job* job);
+		Job* FindJob();
+		void Execute(Job* job);
+		void WakeWorker();
+	};
+}
@@ -0,0 +1,213 @@
+#pragma once
+#include <atomic>
+
+namespace Blaze
+{
+	/*
+		Snapshot of how often a primitive was contended. 'contendedCount' counts operations that couldn't finish
+		right away, 'parkCount' counts the times a thread went to sleep in the kernel. Only the slow paths update
+		the counters, so they cost nothing when there is no contention
+	*/
+	struct SyncContention
+	{
+		uint64 contendedCount = 0;
+		uint64 parkCount = 0;
+	};
+
+	namespace Internal
+	{
+		struct SyncContentionCounters
+		{
+			std::atomic<uint64> contendedCount = 0;
+			std::atomic<uint64> parkCount = 0;
+
+			void AddContended() { contendedCount.fetch_add(1, std::memory_order_relaxed); }
+			void AddPark() { parkCount.fetch_add(1, std::memory_order_relaxed); }
+
+			SyncContention Get() const { return { contendedCount.load(std::memory_order_relaxed), parkCount.load(std::memory_order_relaxed) }; }
+			void Reset() { contendedCount.store(0, std::memory_order_relaxed); parkCount.store(0, std::memory_order_relaxed); }
+		};
+
+		/*
+			Tells the CPU the thread is spinning, which saves power and frees the core for its hyperthread
+		*/
+		BLAZE_CORE_API void CpuRelax();
+	}
+
+	/*
+		Mutex for short critical sections. Locking spins for a while before parking the thread in the kernel, the
+		spin length adapts to how long the lock was held recently. Parking and waking use futexes (WaitOnAddress on
+		Windows), an uncontended lock and unlock is a single atomic operation each.
+
+		Has lock, unlock and try_lock so it works with std::lock_guard and std::unique_lock
+	*/
+	class BLAZE_CORE_API AdaptiveMutex
+	{
+	public:
+		AdaptiveMutex();
+		AdaptiveMutex(const AdaptiveMutex&) = delete;
+
+		void lock()
+		{
+			uint32 expected = Unlocked;
+			if (!state.compare_exchange_strong(expected, Locked, std::memory_order_acquire, std::memory_order_relaxed))
+				LockSlow();
+		}
+		bool try_lock()
+		{
+			uint32 expected = Unlocked;
+			return state.compare_exchange_strong(expected, Locked, std::memory_order_acquire, std::memory_order_relaxed);
+		}
+		void unlock()
+		{
+			if (state.exchange(Unlocked, std::memory_order_release) == LockedWithWaiters)
+				state.notify_one();
+		}
+
+		SyncContention GetContention() const { return counters.Get(); }
+		void ResetContention() { counters.Reset(); }
+
+		AdaptiveMutex& operator=(const AdaptiveMutex&) = delete;
+	private:
+		static constexpr uint32 Unlocked = 0;
+		static constexpr uint32 Locked = 1;
+		//Some thread may be parked, the unlocking thread has to wake one
+		static constexpr uint32 LockedWithWaiters = 2;
+
+		std::atomic<uint32> state;
+		//Running estimate of how many spins it takes to get the lock, only touched by contended locks
+		std::atomic<uint32> spinEstimate;
+		Internal::SyncContentionCounters counters;
+
+		void LockSlow();
+	};
+
+	/*
+		Event that threads can wait on until it is set. Stays set until Reset is called, so waiting on a set event
+		returns immediately. Setting an event nobody waits on doesn't make a system call. Set still touches the event
+		after waking the waiters, so a waiter must not destroy the event as soon as Wait returns
+	*/
+	class BLAZE_CORE_API Event
+	{
+	public:
+		Event(bool set = false);
+		Event(const Event&) = delete;
+
+		void Set();
+		void Reset() { state.store(0, std::memory_order_relaxed); }
+		bool IsSet() const { return state.load(std::memory_order_acquire) != 0; }
+		void Wait();
+
+		SyncContention GetContention() const { return counters.Get(); }
+		void ResetContention() { counters.Reset(); }
+
+		Event& operator=(const Event&) = delete;
+	private:
+		std::atomic<uint32> state;
+		std::atomic<uint32> waiterCount;
+		Internal::SyncContentionCounters counters;
+	};
+
+	/*
+		Counting semaphore. Acquire takes one unit, spinning shortly and then parking while there are none.
+		Releasing doesn't make a system call when nobody is waiting
+	*/
+	class BLAZE_CORE_API Semaphore
+	{
+	public:
+		Semaphore(uint32 initialCount = 0);
+		Semaphore(const Semaphore&) = delete;
+
+		void Acquire();
+		bool TryAcquire();
+		void Release(uint32 count = 1);
+
+		SyncContention GetContention() const { return counters.Get(); }
+		void ResetContention() { counters.Reset(); }
+
+		Semaphore& operator=(const Semaphore&) = delete;
+	private:
+		std::atomic<uint32> count;
+		std::atomic<uint32> waiterCount;
+		Internal::SyncContentionCounters counters;
+	};
+
+	/*
+		Barrier for a fixed number of threads that can be reused every frame. ArriveAndWait returns once all threads
+		have arrived, the last thread to arrive releases the others and starts the next phase.
+		'contendedCount' counts threads that had to wait for others
+	*/
+	class BLAZE_CORE_API FrameBarrier
+	{
+	public:
+		FrameBarrier(uint32 threadCount);
+		FrameBarrier(const FrameBarrier&) = delete;
+
+		/*
+			Returns true on the thread that arrived last, it can do work that must happen once per phase
+		*/
+		bool ArriveAndWait();
+
+		uint32 GetThreadCount() const { return threadCount; }
+
+		SyncContention GetContention() const { return counters.Get(); }
+		void ResetContention() { counters.Reset(); }
+
+		FrameBarrier& operator=(const FrameBarrier&) = delete;
+	private:
+		const uint32 threadCount;
+		std::atomic<uint32> arrivedCount;
+		std::atomic<uint32> phase;
+		Internal::SyncContentionCounters counters;
+	};
+
+	/*
+		Reader-writer lock for data that is read much more often than written, like registries and resource maps.
+		Readers only touch one atomic when no writer is around. A waiting writer stops new readers from entering,
+		so writers aren't starved by a steady stream of readers.
+
+		Has lock/unlock and lock_shared/unlock_shared so it works with std::unique_lock and std::shared_lock
+	*/
+	class BLAZE_CORE_API ReadWriteLock
+	{
+	public:
+		ReadWriteLock();
+		ReadWriteLock(const ReadWriteLock&) = delete;
+
+		void lock_shared()
+		{
+			uint32 value = state.load(std::memory_order_relaxed);
+			if ((value & (WriterBit | WriterWaitingBit)) != 0 || !state.compare_exchange_weak(value, value + 1, std::memory_order_acquire, std::memory_order_relaxed))
+				LockSharedSlow();
+		}
+		bool try_lock_shared();
+		void unlock_shared();
+
+		void lock()
+		{
+			uint32 expected = 0;
+			if (!state.compare_exchange_strong(expected, WriterBit, std::memory_order_acquire, std::memory_order_relaxed))
+				LockSlow();
+		}
+		bool try_lock();
+		void unlock();
+
+		SyncContention GetContention() const { return counters.Get(); }
+		void ResetContention() { counters.Reset(); }
+
+		ReadWriteLock& operator=(const ReadWriteLock&) = delete;
+	private:
+		static constexpr uint32 WriterBit = 1u << 31;
+		static constexpr uint32 WriterWaitingBit = 1u << 30;
+		static constexpr uint32 ReaderCountMask = WriterWaitingBit - 1;
+
+		//Reader count in the low bits and the writer flags in the high ones
+		std::atomic<uint32> state;
+		std::atomic<uint32> waiterCount;
+		Internal::SyncContentionCounters counters;
+
+		void LockSharedSlow();
+		void LockSlow();
+		void WakeWaiters();
+	};
+}
@@ -0,0 +1,290 @@
+#pragma once
+#include "BlazeEngineCore/Threading/JobSystem.h"
+#include "BlazeEngineCore/File/AsyncFileReader.h"
+#include "BlazeEngineCore/DataStructures/Array.h"
+#include <coroutine>
+#include <condition_variable>
+#include <optional>
+
+namespace Blaze
+{
+	/*
+		Allocates coroutine frames from per-thread free lists, so starting a task usually doesn't go to the general
+		allocator. Frames may be freed on a different thread than the one that allocated them
+	*/
+	class BLAZE_CORE_API CoroutineFrameAllocator
+	{
+	public:
+		static void* Allocate(uintMem size);
+		static void Free(void* ptr, uintMem size);
+	};
+
+	template<typename T>
+	class Task;
+
+	namespace Internal
+	{
+		/*
+			Used by SyncWait to block a thread that isn't a coroutine until a task finishes
+		*/
+		struct TaskSyncWaitState
+		{
+			std::mutex mutex;
+			std::condition_variable condition;
+			bool finished = false;
+
+			void Notify()
+			{
+				//Notified while locked, the waiting thread can't destroy the state before this returns
+				std::lock_guard<std::mutex> lk{ mutex };
+				finished = true;
+				condition.notify_one();
+			}
+			void Wait()
+			{
+				std::unique_lock<std::mutex> lk{ mutex };
+				condition.wait(lk, [&]() { return finished; });
+			}
+		};
+
+		struct TaskPromiseBase
+		{
+			//Only one of these is set, depending on how the task was started
+			std::coroutine_handle<> continuation;
+			TaskSyncWaitState* syncWaitState = nullptr;
+			bool detached = false;
+
+			struct FinalAwaiter
+			{
+				bool await_ready() const noexcept { return false; }
+				template<typename Promise>
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+				{
+					TaskPromiseBase& promise = handle.promise();
+
+					if (promise.continuation)
+						return promise.continuation;
+
+					if (promise.syncWaitState != nullptr)
+						promise.syncWaitState->Notify();
+					else if (promise.detached)
+						handle.destroy();
+
+					return std::noop_coroutine();
+				}
+				void await_resume() const noexcept { }
+			};
+
+			std::suspend_always initial_suspend() const noexcept { return { }; }
+			FinalAwaiter final_suspend() const noexcept { return { }; }
+			//The engine doesn't use exceptions
+			void unhandled_exception() const noexcept { std::terminate(); }
+
+			static void* operator new(uintMem size) { return CoroutineFrameAllocator::Allocate(size); }
+			static void operator delete(void* ptr, uintMem size) { CoroutineFrameAllocator::Free(ptr, size); }
+		};
+
+		template<typename T>
+		struct TaskPromise : TaskPromiseBase
+		{
+			std::optional<T> result;
+
+			Task<T> get_return_object() noexcept;
+			template<typename U> requires std::constructible_from<T, U&&>
+			void return_value(U&& value) { result.emplace(std::forward<U>(value)); }
+
+			T TakeResult() { return std::move(*result); }
+		};
+		template<>
+		struct TaskPromise<void> : TaskPromiseBase
+		{
+			Task<void> get_return_object() noexcept;
+			void return_void() const noexcept { }
+
+			void TakeResult() const noexcept { }
+		};
+	}
+
+	/*
+		Coroutine that returns a value of type T. Tasks start suspended and run when they are awaited from another
+		task, waited for with SyncWait or started with StartDetached. A task continues on whatever thread resumes it,
+		use the Resume* awaiters to move it to a job system worker, the main thread or the next frame.
+
+		Awaiting a task transfers control to it directly, so long chains of tasks don't grow the stack.
+	*/
+	template<typename T = void>
+	class Task
+	{
+	public:
+		using promise_type = Internal::TaskPromise<T>;
+
+		Task() : handle(nullptr) { }
+		Task(const Task&) = delete;
+		Task(Task&& other) noexcept : handle(std::exchange(other.handle, nullptr)) { }
+		~Task() { if (handle) handle.destroy(); }
+
+		bool IsValid() const { return (bool)handle; }
+		bool IsFinished() const { return handle && handle.done(); }
+
+		auto operator co_await() && noexcept
+		{
+			struct Awaiter
+			{
+				std::coroutine_handle<promise_type> handle;
+
+				bool await_ready() const noexcept { return !handle || handle.done(); }
+				std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+				{
+					handle.promise().continuation = awaiting;
+					return handle;
+				}
+				T await_resume() { return handle.promise().TakeResult(); }
+			};
+
+			return Awaiter{ handle };
+		}
+
+		Task& operator=(const Task&) = delete;
+		Task& operator=(Task&& other) noexcept
+		{
+			if (handle)
+				handle.destroy();
+			handle = std::exchange(other.handle, nullptr);
+			return *this;
+		}
+	private:
+		std::coroutine_handle<promise_type> handle;
+
+		Task(std::coroutine_handle<promise_type> handle) : handle(handle) { }
+
+		friend struct Internal::TaskPromise<T>;
+		template<typename U>
+		friend U SyncWait(Task<U>&& task);
+		friend void StartDetached(Task<void>&& task);
+	};
+
+	template<typename T>
+	inline Task<T> Internal::TaskPromise<T>::get_return_object() noexcept
+	{
+		return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+	}
+	inline Task<void> Internal::TaskPromise<void>::get_return_object() noexcept
+	{
+		return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+	}
+
+	/*
+		Runs the task and blocks the calling thread until it finishes. Must not be called from a thread the task
+		needs to resume on
+	*/
+	template<typename T>
+	inline T SyncWait(Task<T>&& task)
+	{
+		Task<T> waited = std::move(task);
+		Internal::TaskSyncWaitState state;
+
+		waited.handle.promise().syncWaitState = &state;
+		waited.handle.resume();
+
+		state.Wait();
+
+		return waited.handle.promise().TakeResult();
+	}
+	/*
+		Starts the task without anyone waiting for it. Its frame is freed when it finishes
+	*/
+	inline void StartDetached(Task<void>&& task)
+	{
+		std::coroutine_handle<Internal::TaskPromise<void>> handle = std::exchange(task.handle, nullptr);
+		handle.promise().detached = true;
+		handle.resume();
+	}
+
+	/*
+		Continues the coroutine on 'post', which must call the given function on the thread the coroutine should
+		continue on
+	*/
+	template<typename Post>
+	inline auto ResumeVia(Post post)
+	{
+		struct Awaiter
+		{
+			Post post;
+
+			bool await_ready() const noexcept { return false; }
+			void await_suspend(std::coroutine_handle<> handle) { post([handle]() { handle.resume(); }); }
+			void await_resume() const noexcept { }
+		};
+
+		return Awaiter{ std::move(post) };
+	}
+	/*
+		Continues the coroutine as a job on one of the job system workers
+	*/
+	inline auto ResumeOnJobSystem(JobSystem& jobSystem)
+	{
+		return ResumeVia([&jobSystem](std::function<void()> function) { jobSystem.Schedule(std::move(function)); });
+	}
+	/*
+		Waits for the read to finish and returns the read count. The coroutine continues on the thread that
+		finished the read, which is an I/O thread. No lock of the reader is held there, so the coroutine may start
+		more reads, but other reads aren't finished until it suspends again, so heavy work should hop to a job
+		system first
+	*/
+	inline auto WaitForRead(AsyncReadHandle read)
+	{
+		struct Awaiter
+		{
+			AsyncReadHandle read;
+
+			bool await_ready() const { return !read.IsValid() || read.IsFinished(); }
+			bool await_suspend(std::coroutine_handle<> handle) { return read.OnFinished([handle]() { handle.resume(); }); }
+			uintMem await_resume() const { return read.GetReadCount(); }
+		};
+
+		return Awaiter{ std::move(read) };
+	}
+
+	/*
+		Lets coroutines wait for a frame boundary. Coroutines that await NextFrame are continued by the next call
+		to ResumeWaiting, on the thread that calls it. Coroutines that start waiting while ResumeWaiting runs are
+		left for the call after it.
+
+		The scheduler doesn't own the waiting coroutines. When it is destroyed it continues them on the destroying
+		thread and NextFrame returns false, so they can finish instead of waiting forever
+	*/
+	class BLAZE_CORE_API FrameScheduler
+	{
+	public:
+		struct FrameAwaiter
+		{
+			FrameScheduler& scheduler;
+			std::coroutine_handle<> handle = nullptr;
+			bool cancelled = false;
+
+			bool await_ready() const noexcept { return false; }
+			void await_suspend(std::coroutine_handle<> handle) { this->handle = handle; scheduler.AddWaiting(this); }
+			//False if the scheduler was destroyed before the next frame
+			bool await_resume() const noexcept { return !cancelled; }
+		};
+
+		FrameScheduler();
+		FrameScheduler(const FrameScheduler&) = delete;
+		~FrameScheduler();
+
+		FrameAwaiter NextFrame() { return FrameAwaiter{ *this }; }
+
+		/*
+			Continues all coroutines that waited for the next frame. Returns the number of continued coroutines
+		*/
+		uintMem ResumeWaiting();
+
+		FrameScheduler& operator=(const FrameScheduler&) = delete;
+	private:
+		std::mutex mutex;
+		//The awaiters live in the frames of the waiting coroutines
+		Array<FrameAwaiter*> waiting;
+
+		void AddWaiting(FrameAwaiter* awaiter);
+	};
+}
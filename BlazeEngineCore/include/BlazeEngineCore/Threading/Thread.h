@@ -1,8 +1,32 @@
 #pragma once
+#include "BlazeEngineCore/DataStructures/StringView.h"
 
 namespace Blaze
 {
-	class Thread
+	enum class ThreadPriority
+	{
+		Lowest,
+		Low,
+		Normal,
+		High,
+		Highest,
+		//Real time scheduling on Linux (SCHED_FIFO), time critical priority on Windows. Usually needs elevated
+		//privileges
+		TimeCritical,
+	};
+
+	struct ThreadCreateOptions
+	{
+		//Shown in debuggers and profilers. Linux limits names to 15 characters, longer names are cut
+		StringView name;
+		//0 uses the platform default
+		uintMem stackSize = 0;
+		//Bit i allows the thread to run on logical processor i. 0 leaves the affinity unchanged
+		uint64 affinityMask = 0;
+		ThreadPriority priority = ThreadPriority::Normal;
+	};
+
+	class BLAZE_CORE_API Thread
 	{
 		void* handle;
 	public:
@@ -10,15 +34,35 @@ namespace Blaze
 		Thread(std::function<int()>);
 		Thread(const Thread&) = delete;
 		Thread(Thread&&) noexcept;
+		/*
+			A thread that is still running keeps running after its Thread object is destroyed
+		*/
 		~Thread();
 
 		Result Run(std::function<int()>);
+		Result Run(std::function<int()>, const ThreadCreateOptions& options);
 		Result Run(int(*func)());
 
-		void WaitToFinish() const;				 
+		void WaitToFinish() const;
 		bool IsRunning() const;
 
+		/*
+			These can only be called while the thread is running
+		*/
+		Result SetAffinity(uint64 affinityMask);
+		Result SetPriority(ThreadPriority priority);
+		Result SetName(StringView name);
+
+		static Result SetCurrentThreadAffinity(uint64 affinityMask);
+		static Result SetCurrentThreadPriority(ThreadPriority priority);
+		static Result SetCurrentThreadName(StringView name);
+		/*
+			Returns a small index unique to the calling thread, meant for indexing per thread data. Indices are
+			given out in the order threads first call this function and are never reused
+		*/
+		static uint CurrentIndex();
+
 		Thread& operator=(const Thread&) = delete;
 		Thread& operator=(Thread&&) noexcept;
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,184 @@
+#include "pch.h"
+#include "BlazeEngineCore/File/Archive.h"
+
+namespace Blaze
+{
+	WriteArchive::WriteArchive(WriteStream& stream)
+		: stream(stream), position(0), failed(false)
+	{
+	}
+	WriteArchive::~WriteArchive()
+	{
+		if (!sectionSizePositions.Empty())
+			Debug::Logger::LogError("Blaze Engine", "WriteArchive destroyed while a section is still open");
+	}
+	void WriteArchive::BeginSection(uint32 version)
+	{
+		*this << version;
+
+		sectionSizePositions.AddBack(sectionBuffer.GetPosition());
+
+		//Filled in by EndSection
+		*this << (uint64)0;
+	}
+	void WriteArchive::EndSection()
+	{
+		if (sectionSizePositions.Empty())
+		{
+			Debug::Logger::LogError("Blaze Engine", "WriteArchive::EndSection called without a matching BeginSection");
+			failed = true;
+			return;
+		}
+
+		uintMem sizePosition = sectionSizePositions.Last();
+		sectionSizePositions.EraseLast();
+
+		uintMem end = sectionBuffer.GetPosition();
+		uint64 sectionSize = end - sizePosition - sizeof(uint64);
+
+		//Only moves within the memory buffer
+		sectionBuffer.SetPosition(sizePosition);
+		sectionBuffer.Write(&sectionSize, sizeof(uint64));
+		sectionBuffer.SetPosition(end);
+
+		if (sectionSizePositions.Empty())
+		{
+			if (stream.WriteBytes(sectionBuffer.GetBuffer(), end) != end)
+				failed = true;
+
+			sectionBuffer.SetPosition(0);
+		}
+	}
+	bool WriteArchive::Flush()
+	{
+		if (!stream.Flush())
+			failed = true;
+
+		return !failed;
+	}
+
+	//Used in place of a null pointer so that an empty archive still reads from memory
+	static const byte emptyArchiveData = 0;
+
+	ReadArchive::ReadArchive(ReadStream& stream)
+		: stream(nullptr), contiguousStream(dynamic_cast<ContiguousReadStream*>(&stream)), data(nullptr), size(0), position(0), startPosition(0), failed(false)
+	{
+		if (contiguousStream != nullptr)
+		{
+			uintMem remaining = stream.GetSize() - stream.GetPosition();
+			ArrayView<byte> view = contiguousStream->TryGetContiguous(remaining);
+
+			if (view.Count() == remaining)
+			{
+				data = remaining != 0 ? view.Ptr() : &emptyArchiveData;
+				size = remaining;
+				return;
+			}
+
+			contiguousStream = nullptr;
+		}
+
+		this->stream = new BufferedReadStream(stream);
+		startPosition = this->stream->GetPosition();
+	}
+	ReadArchive::ReadArchive(const void* data, uintMem size)
+		: stream(nullptr), contiguousStream(nullptr), data(data != nullptr ? (const byte*)data : &emptyArchiveData), size(data != nullptr ? size : 0), position(0), startPosition(0), failed(false)
+	{
+	}
+	ReadArchive::~ReadArchive()
+	{
+		if (contiguousStream != nullptr)
+			contiguousStream->Consume(position);
+
+		if (stream != nullptr)
+		{
+			//Leave the wrapped stream right after the data that was read instead of after whatever was read ahead
+			stream->GetStream().SetPosition(stream->GetPosition());
+			delete stream;
+		}
+	}
+	uint32 ReadArchive::BeginSection()
+	{
+		uint32 version = 0;
+		uint64 sectionSize = 0;
+		*this >> version >> sectionSize;
+
+		if (failed || !CanRead((uintMem)sectionSize, 1))
+		{
+			failed = true;
+			return 0;
+		}
+
+		sections.AddBack(Section{ version, GetPosition() + (uintMem)sectionSize });
+
+		return version;
+	}
+	void ReadArchive::EndSection()
+	{
+		if (sections.Empty())
+		{
+			Debug::Logger::LogError("Blaze Engine", "ReadArchive::EndSection called without a matching BeginSection");
+			failed = true;
+			return;
+		}
+
+		uintMem end = sections.Last().end;
+		sections.EraseLast();
+
+		if (failed)
+			return;
+
+		//Reading past the end of the section means the data doesn't match the version
+		if (GetPosition() > end || !SetPosition(end))
+			failed = true;
+	}
+	void ReadArchive::SkipPadding(uintMem alignment)
+	{
+		if (failed)
+			return;
+
+		uintMem offset = GetPosition() - startPosition;
+		uintMem padding = (alignment - offset % alignment) % alignment;
+
+		if (padding != 0 && (!CanRead(padding, 1) || !SetPosition(GetPosition() + padding)))
+			failed = true;
+	}
+	uint32 ReadArchive::GetSectionVersion() const
+	{
+		return sections.Empty() ? 0 : sections.Last().version;
+	}
+	bool ReadArchive::CanRead(uintMem count, uintMem elementSize)
+	{
+		if (failed)
+			return false;
+
+		uintMem position = GetPosition();
+		uintMem end = data != nullptr ? size : stream->GetSize();
+
+		if (!sections.Empty())
+			end = std::min(end, sections.Last().end);
+
+		if (position > end || (elementSize != 0 && count > (end - position) / elementSize))
+		{
+			failed = true;
+			return false;
+		}
+
+		return true;
+	}
+	uintMem ReadArchive::GetPosition() const
+	{
+		return data != nullptr ? position : stream->GetPosition();
+	}
+	bool ReadArchive::SetPosition(uintMem position)
+	{
+		if (data == nullptr)
+			return stream->SetPosition(position);
+
+		if (position > size)
+			return false;
+
+		this->position = position;
+		return true;
+	}
+}
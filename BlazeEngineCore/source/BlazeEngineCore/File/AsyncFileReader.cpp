@@ -0,0 +1,981 @@
+#include "pch.h"
+#include "BlazeEngineCore/File/AsyncFileReader.h"
+#include "BlazeEngineCore/DataStructures/List.h"
+#include "BlazeEngineCore/Threading/Thread.h"
+#include <condition_variable>
+#include <atomic>
+
+#ifdef BLAZE_PLATFORM_WINDOWS
+#include "BlazeEngineCore/Internal/Windows/WindowsPlatform.h"
+#elif defined(BLAZE_PLATFORM_LINUX)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#else
+#error
+#endif
+
+namespace Blaze
+{
+#ifdef BLAZE_PLATFORM_WINDOWS
+	using NativeFile = HANDLE;
+#elif defined(BLAZE_PLATFORM_LINUX)
+	using NativeFile = int;
+#endif
+
+	struct AsyncReadRequest
+	{
+		NativeFile file;
+		bool ownsFile;
+		uintMem offset;
+		byte* buffer;
+		uintMem size;
+		bool ownsBuffer;
+
+		uintMem readCount;
+		bool failed;
+		std::atomic_flag finished;
+
+		std::mutex finishedCallbackMutex;
+		std::function<void()> finishedCallback;
+
+#ifdef BLAZE_PLATFORM_WINDOWS
+		//Set for files opened by the reader, they are opened for overlapped I/O
+		bool overlappedFile = false;
+#elif defined(BLAZE_PLATFORM_LINUX)
+		//Used by the io_uring backend, it has to stay valid until the read is completed
+		iovec iov;
+#endif
+
+		AsyncReadRequest();
+		~AsyncReadRequest();
+
+		void Finish(bool failed);
+	};
+
+	static void CloseNativeFile(NativeFile file)
+	{
+#ifdef BLAZE_PLATFORM_WINDOWS
+		if (CloseHandle(file) == 0)
+			Debug::Logger::LogError("Windows API", "CloseHandle failed with error: \"" + Windows::GetErrorString(GetLastError()) + "\"");
+#elif defined(BLAZE_PLATFORM_LINUX)
+		if (close(file) == -1)
+			Debug::Logger::LogError("Blaze Engine", "close failed with error: \"" + String(strerror(errno)) + "\"");
+#endif
+	}
+	static bool OpenNativeFile(const Path& path, FileUsageHint usageHint, NativeFile& file)
+	{
+#ifdef BLAZE_PLATFORM_WINDOWS
+		//Overlapped so that reads can be completed through an I/O completion port
+		DWORD flagsAndAttributes = FILE_FLAG_OVERLAPPED;
+
+		switch (usageHint)
+		{
+		case FileUsageHint::Normal: break;
+		case FileUsageHint::RandomAccess: flagsAndAttributes |= FILE_FLAG_RANDOM_ACCESS; break;
+		case FileUsageHint::Sequential: flagsAndAttributes |= FILE_FLAG_SEQUENTIAL_SCAN; break;
+		default:
+			Debug::Logger::LogError("Blaze Engine", "Invalid FileUsageHint enum value");
+			break;
+		}
+
+		auto wstring = path.GetUnderlyingObject().wstring();
+		file = CreateFileW(wstring.data(), GENERIC_READ, FILE_SHARE_WRITE | FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, flagsAndAttributes, NULL);
+
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			Debug::Logger::LogError("Windows API", "CreateFileW given a path \"" + path.ToString() + "\" failed with error: \"" + Windows::GetErrorString(GetLastError()) + "\"");
+			return false;
+		}
+#elif defined(BLAZE_PLATFORM_LINUX)
+		file = open(path.GetUnderlyingObject().c_str(), O_RDONLY | O_CLOEXEC);
+
+		if (file == -1)
+		{
+			Debug::Logger::LogError("Blaze Engine", "open given a path \"" + path.ToString() + "\" failed with error: \"" + String(strerror(errno)) + "\"");
+			return false;
+		}
+#endif
+		return true;
+	}
+	/*
+		Tells the OS how the range of the file is going to be read, so it can start reading it ahead
+	*/
+	static void AdviseNativeFile(NativeFile file, uintMem offset, uintMem size, FileUsageHint usageHint)
+	{
+#ifdef BLAZE_PLATFORM_LINUX
+		switch (usageHint)
+		{
+		case FileUsageHint::Normal: break;
+		case FileUsageHint::RandomAccess: posix_fadvise(file, (off_t)offset, (off_t)size, POSIX_FADV_RANDOM); break;
+		case FileUsageHint::Sequential:
+			posix_fadvise(file, (off_t)offset, (off_t)size, POSIX_FADV_SEQUENTIAL);
+			posix_fadvise(file, (off_t)offset, (off_t)size, POSIX_FADV_WILLNEED);
+			break;
+		default:
+			Debug::Logger::LogError("Blaze Engine", "Invalid FileUsageHint enum value");
+			break;
+		}
+#endif
+	}
+	static bool GetNativeFileSize(NativeFile file, uintMem& size)
+	{
+#ifdef BLAZE_PLATFORM_WINDOWS
+		LARGE_INTEGER fileSize;
+		if (GetFileSizeEx(file, &fileSize) == 0)
+		{
+			Debug::Logger::LogError("Windows API", "GetFileSizeEx failed with error: \"" + Windows::GetErrorString(GetLastError()) + "\"");
+			return false;
+		}
+
+		size = (uintMem)fileSize.QuadPart;
+#elif defined(BLAZE_PLATFORM_LINUX)
+		struct stat fileStat;
+		if (fstat(file, &fileStat) == -1)
+		{
+			Debug::Logger::LogError("Blaze Engine", "fstat failed with error: \"" + String(strerror(errno)) + "\"");
+			return false;
+		}
+
+		size = (uintMem)fileStat.st_size;
+#endif
+		return true;
+	}
+	/*
+		Reads at the given offset without using the file position, so multiple threads can read the same file
+		at the same time
+	*/
+	static bool ReadNativeFile(NativeFile file, uintMem offset, byte* buffer, uintMem size, uintMem& readCount)
+	{
+		readCount = 0;
+
+		while (readCount != size)
+		{
+#ifdef BLAZE_PLATFORM_WINDOWS
+			uint64 position = offset + readCount;
+			OVERLAPPED overlapped{ };
+			overlapped.Offset = (DWORD)position;
+			overlapped.OffsetHigh = (DWORD)(position >> 32);
+
+			DWORD read = 0;
+			DWORD toRead = (DWORD)std::min<uintMem>(size - readCount, 0x80000000);
+			DWORD error = ERROR_SUCCESS;
+
+			if (ReadFile(file, buffer + readCount, toRead, &read, &overlapped) == 0)
+			{
+				error = GetLastError();
+
+				//Files opened for overlapped I/O can't be read synchronously, the read is waited for instead. Only
+				//one read at a time is issued on such a file, so waiting on the file handle is safe
+				if (error == ERROR_IO_PENDING)
+					error = GetOverlappedResult(file, &overlapped, &read, TRUE) == 0 ? GetLastError() : ERROR_SUCCESS;
+			}
+
+			if (error != ERROR_SUCCESS)
+			{
+				if (error == ERROR_HANDLE_EOF)
+					break;
+
+				Debug::Logger::LogError("Windows API", "ReadFile failed with error: \"" + Windows::GetErrorString(error) + "\"");
+				return false;
+			}
+#elif defined(BLAZE_PLATFORM_LINUX)
+			ssize_t read = pread(file, buffer + readCount, size - readCount, (off_t)(offset + readCount));
+
+			if (read == -1)
+			{
+				if (errno == EINTR)
+					continue;
+
+				Debug::Logger::LogError("Blaze Engine", "pread failed with error: \"" + String(strerror(errno)) + "\"");
+				return false;
+			}
+#endif
+
+			if (read == 0)
+				break;
+
+			readCount += (uintMem)read;
+		}
+
+		return true;
+	}
+
+	AsyncReadRequest::AsyncReadRequest()
+		: file(), ownsFile(false), offset(0), buffer(nullptr), size(0), ownsBuffer(false), readCount(0), failed(false)
+	{
+	}
+	AsyncReadRequest::~AsyncReadRequest()
+	{
+		if (ownsFile)
+			CloseNativeFile(file);
+
+		if (ownsBuffer)
+			Memory::Free(buffer);
+	}
+	void AsyncReadRequest::Finish(bool failed)
+	{
+		//Files opened by the reader are closed right away so that many queued reads don't keep their files open
+		if (ownsFile)
+		{
+			CloseNativeFile(file);
+			ownsFile = false;
+		}
+
+		this->failed = failed;
+		finished.test_and_set(std::memory_order_release);
+		finished.notify_all();
+
+		std::function<void()> callback;
+
+		{
+			std::lock_guard<std::mutex> lk{ finishedCallbackMutex };
+			callback = std::move(finishedCallback);
+		}
+
+		//Called last, the callback may release the last handle to the request
+		if (callback)
+			callback();
+	}
+
+	AsyncReadHandle::AsyncReadHandle()
+	{
+	}
+	AsyncReadHandle::AsyncReadHandle(std::shared_ptr<AsyncReadRequest> request)
+		: request(std::move(request))
+	{
+	}
+	bool AsyncReadHandle::IsValid() const
+	{
+		return request != nullptr;
+	}
+	bool AsyncReadHandle::IsFinished() const
+	{
+		return request != nullptr && request->finished.test(std::memory_order_acquire);
+	}
+	uintMem AsyncReadHandle::Wait() const
+	{
+		if (request == nullptr)
+			return 0;
+
+		request->finished.wait(false, std::memory_order_acquire);
+
+		return request->readCount;
+	}
+	bool AsyncReadHandle::OnFinished(std::function<void()> function) const
+	{
+		if (request == nullptr)
+			return false;
+
+		std::lock_guard<std::mutex> lk{ request->finishedCallbackMutex };
+
+		//Finish sets the flag before taking the callback, so a callback stored here is always called
+		if (request->finished.test(std::memory_order_acquire))
+			return false;
+
+		request->finishedCallback = std::move(function);
+		return true;
+	}
+	bool AsyncReadHandle::Failed() const
+	{
+		return request == nullptr || request->failed;
+	}
+	uintMem AsyncReadHandle::GetReadCount() const
+	{
+		return request == nullptr ? 0 : request->readCount;
+	}
+	ArrayView<byte> AsyncReadHandle::GetData() const
+	{
+		if (request == nullptr)
+			return ArrayView<byte>();
+
+		return ArrayView<byte>(request->buffer, request->readCount);
+	}
+
+	class AsyncFileReaderBackend
+	{
+	public:
+		virtual ~AsyncFileReaderBackend() { }
+
+		virtual void Submit(ArrayView<std::shared_ptr<AsyncReadRequest>> requests) = 0;
+		virtual AsyncFileReaderBackendType GetType() const = 0;
+	};
+
+	class ThreadPoolAsyncFileReaderBackend : public AsyncFileReaderBackend
+	{
+	public:
+		ThreadPoolAsyncFileReaderBackend(uint threadCount)
+			: stop(false), threads(std::max(threadCount, 1u))
+		{
+			for (auto& thread : threads)
+				thread.Run([this]() { return WorkerProc(); });
+		}
+		~ThreadPoolAsyncFileReaderBackend() override
+		{
+			{
+				std::lock_guard lock{ mutex };
+				stop = true;
+			}
+
+			cv.notify_all();
+
+			for (auto& thread : threads)
+				thread.WaitToFinish();
+		}
+
+		void Submit(ArrayView<std::shared_ptr<AsyncReadRequest>> requests) override
+		{
+			{
+				std::lock_guard lock{ mutex };
+
+				for (uintMem i = 0; i < requests.Count(); ++i)
+					queue.AddBack(requests[i]);
+			}
+
+			if (requests.Count() == 1)
+				cv.notify_one();
+			else
+				cv.notify_all();
+		}
+		AsyncFileReaderBackendType GetType() const override { return AsyncFileReaderBackendType::ThreadPool; }
+	private:
+		std::mutex mutex;
+		std::condition_variable cv;
+		List<std::shared_ptr<AsyncReadRequest>> queue;
+		bool stop;
+
+		Array<Thread> threads;
+
+		int WorkerProc()
+		{
+			while (true)
+			{
+				std::shared_ptr<AsyncReadRequest> request;
+
+				{
+					std::unique_lock lock{ mutex };
+					cv.wait(lock, [&]() { return stop || !queue.Empty(); });
+
+					//The queue is drained before stopping so that every submitted read finishes
+					if (queue.Empty())
+						return 0;
+
+					request = std::move(queue.First());
+					queue.EraseFirst();
+				}
+
+				uintMem readCount = 0;
+				bool succeeded = ReadNativeFile(request->file, request->offset, request->buffer, request->size, readCount);
+				request->readCount = readCount;
+				request->Finish(!succeeded);
+			}
+		}
+	};
+
+#ifdef BLAZE_PLATFORM_LINUX
+	/*
+		Submits reads to an io_uring instance. The submitting thread fills the submission queue and a completion
+		thread waits for completions. Reads that are cut short (large reads are split) are resubmitted from the
+		completion thread until they are done or reach the end of the file.
+	*/
+	class IOUringAsyncFileReaderBackend : public AsyncFileReaderBackend
+	{
+	public:
+		IOUringAsyncFileReaderBackend()
+			: ringFD(-1), sqRing(nullptr), sqRingSize(0), cqRing(nullptr), cqRingSize(0), sqes(nullptr), sqesSize(0),
+			sqHead(nullptr), sqTail(nullptr), sqMask(nullptr), sqArray(nullptr), sqEntries(0),
+			cqHead(nullptr), cqTail(nullptr), cqMask(nullptr), cqes(nullptr), inFlight(0), stop(false)
+		{
+		}
+		~IOUringAsyncFileReaderBackend() override
+		{
+			if (completionThread.IsRunning())
+			{
+				{
+					std::lock_guard lock{ mutex };
+					stop = true;
+
+					//The no-op completion wakes the completion thread in case nothing else is in flight
+					PushNop();
+					Enter();
+				}
+
+				completionThread.WaitToFinish();
+			}
+
+			if (sqes != nullptr)
+				munmap(sqes, sqesSize);
+			if (cqRing != nullptr && cqRing != sqRing)
+				munmap(cqRing, cqRingSize);
+			if (sqRing != nullptr)
+				munmap(sqRing, sqRingSize);
+			if (ringFD != -1)
+				close(ringFD);
+		}
+
+		/*
+			Returns false if io_uring isn't available, the object must then be destroyed
+		*/
+		bool Initialize(uint queueDepth)
+		{
+			io_uring_params params;
+			memset(&params, 0, sizeof(params));
+
+			ringFD = (int)syscall(__NR_io_uring_setup, std::max(queueDepth, 2u), &params);
+
+			if (ringFD == -1)
+				return false;
+
+			sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32);
+			cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+			bool singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+
+			if (singleMap)
+				sqRingSize = cqRingSize = std::max(sqRingSize, cqRingSize);
+
+			void* sqRingMap = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFD, IORING_OFF_SQ_RING);
+			if (sqRingMap == MAP_FAILED)
+				return false;
+			sqRing = sqRingMap;
+
+			if (singleMap)
+				cqRing = sqRing;
+			else
+			{
+				void* cqRingMap = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFD, IORING_OFF_CQ_RING);
+				if (cqRingMap == MAP_FAILED)
+					return false;
+				cqRing = cqRingMap;
+			}
+
+			sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+			void* sqesMap = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFD, IORING_OFF_SQES);
+			if (sqesMap == MAP_FAILED)
+				return false;
+			sqes = (io_uring_sqe*)sqesMap;
+
+			sqHead = (uint32*)((byte*)sqRing + params.sq_off.head);
+			sqTail = (uint32*)((byte*)sqRing + params.sq_off.tail);
+			sqMask = (uint32*)((byte*)sqRing + params.sq_off.ring_mask);
+			sqArray = (uint32*)((byte*)sqRing + params.sq_off.array);
+			sqEntries = params.sq_entries;
+
+			cqHead = (uint32*)((byte*)cqRing + params.cq_off.head);
+			cqTail = (uint32*)((byte*)cqRing + params.cq_off.tail);
+			cqMask = (uint32*)((byte*)cqRing + params.cq_off.ring_mask);
+			cqes = (io_uring_cqe*)((byte*)cqRing + params.cq_off.cqes);
+
+			if (completionThread.Run([this]() { return CompletionProc(); }))
+				return false;
+
+			return true;
+		}
+
+		void Submit(ArrayView<std::shared_ptr<AsyncReadRequest>> requests) override
+		{
+			std::lock_guard lock{ mutex };
+
+			for (uintMem i = 0; i < requests.Count(); ++i)
+				queued.AddBack(requests[i]);
+
+			SubmitQueued();
+		}
+		AsyncFileReaderBackendType GetType() const override { return AsyncFileReaderBackendType::IOUring; }
+	private:
+		//Reads larger than this are split into multiple submissions
+		static constexpr uintMem maxReadSize = 1u << 30;
+
+		int ringFD;
+
+		void* sqRing;
+		uintMem sqRingSize;
+		void* cqRing;
+		uintMem cqRingSize;
+		io_uring_sqe* sqes;
+		uintMem sqesSize;
+
+		uint32* sqHead;
+		uint32* sqTail;
+		uint32* sqMask;
+		uint32* sqArray;
+		uint32 sqEntries;
+
+		uint32* cqHead;
+		uint32* cqTail;
+		uint32* cqMask;
+		io_uring_cqe* cqes;
+
+		//Guards the submission queue and the members below
+		std::mutex mutex;
+		List<std::shared_ptr<AsyncReadRequest>> queued;
+		//Number of submissions that weren't completed yet. It never exceeds the submission queue size, so the
+		//submission queue always has room and the completion queue can't overflow
+		uint32 inFlight;
+		bool stop;
+
+		Thread completionThread;
+
+		io_uring_sqe& GetNextSQE()
+		{
+			uint32 tail = *sqTail;
+			uint32 index = tail & *sqMask;
+
+			io_uring_sqe& sqe = sqes[index];
+			memset(&sqe, 0, sizeof(sqe));
+			sqArray[index] = index;
+
+			return sqe;
+		}
+		void PublishSQE()
+		{
+			__atomic_store_n(sqTail, *sqTail + 1, __ATOMIC_RELEASE);
+			++inFlight;
+		}
+		void PushRead(std::shared_ptr<AsyncReadRequest>* holder)
+		{
+			AsyncReadRequest& request = **holder;
+			io_uring_sqe& sqe = GetNextSQE();
+
+			request.iov.iov_base = request.buffer + request.readCount;
+			request.iov.iov_len = std::min(request.size - request.readCount, maxReadSize);
+
+			sqe.opcode = IORING_OP_READV;
+			sqe.fd = request.file;
+			sqe.addr = (uint64)&request.iov;
+			sqe.len = 1;
+			sqe.off = (uint64)(request.offset + request.readCount);
+			sqe.user_data = (uint64)holder;
+
+			PublishSQE();
+		}
+		void PushNop()
+		{
+			io_uring_sqe& sqe = GetNextSQE();
+			sqe.opcode = IORING_OP_NOP;
+			sqe.user_data = 0;
+
+			PublishSQE();
+		}
+		/*
+			Hands all submission queue entries that the kernel didn't consume yet to the kernel
+		*/
+		void Enter()
+		{
+			uint32 toSubmit = *sqTail - __atomic_load_n(sqHead, __ATOMIC_ACQUIRE);
+
+			while (toSubmit != 0)
+			{
+				int result = (int)syscall(__NR_io_uring_enter, ringFD, toSubmit, 0, 0, nullptr, 0);
+
+				if (result >= 0)
+					break;
+
+				if (errno != EINTR)
+				{
+					Debug::Logger::LogError("Blaze Engine", "io_uring_enter failed with error: \"" + String(strerror(errno)) + "\"");
+					break;
+				}
+			}
+		}
+		void SubmitQueued()
+		{
+			bool pushed = false;
+
+			while (!queued.Empty() && inFlight < sqEntries)
+			{
+				PushRead(new std::shared_ptr<AsyncReadRequest>(std::move(queued.First())));
+				queued.EraseFirst();
+				pushed = true;
+			}
+
+			if (pushed)
+				Enter();
+		}
+		int CompletionProc()
+		{
+			//Requests are finished after the mutex is released. Finishing runs the completion callbacks, which may
+			//submit more reads or take long
+			Array<std::pair<std::shared_ptr<AsyncReadRequest>*, bool>> finished;
+
+			while (true)
+			{
+				int result = (int)syscall(__NR_io_uring_enter, ringFD, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+
+				if (result == -1 && errno != EINTR)
+					Debug::Logger::LogError("Blaze Engine", "io_uring_enter failed with error: \"" + String(strerror(errno)) + "\"");
+
+				bool exit = false;
+
+				{
+					std::lock_guard lock{ mutex };
+
+					uint32 head = *cqHead;
+					uint32 tail = __atomic_load_n(cqTail, __ATOMIC_ACQUIRE);
+					bool pushed = false;
+
+					for (; head != tail; ++head)
+					{
+						const io_uring_cqe& cqe = cqes[head & *cqMask];
+						auto holder = (std::shared_ptr<AsyncReadRequest>*)cqe.user_data;
+						--inFlight;
+
+						if (holder == nullptr)
+							continue;
+
+						AsyncReadRequest& request = **holder;
+
+						if (cqe.res == -EINTR || cqe.res == -EAGAIN)
+						{
+							PushRead(holder);
+							pushed = true;
+							continue;
+						}
+
+						if (cqe.res < 0)
+						{
+							Debug::Logger::LogError("Blaze Engine", "io_uring read failed with error: \"" + String(strerror(-cqe.res)) + "\"");
+							finished.AddBack(holder, true);
+							continue;
+						}
+
+						request.readCount += (uintMem)cqe.res;
+
+						if (cqe.res != 0 && request.readCount != request.size)
+						{
+							PushRead(holder);
+							pushed = true;
+							continue;
+						}
+
+						finished.AddBack(holder, false);
+					}
+
+					__atomic_store_n(cqHead, head, __ATOMIC_RELEASE);
+
+					if (pushed)
+						Enter();
+
+					SubmitQueued();
+
+					exit = stop && inFlight == 0 && queued.Empty();
+				}
+
+				for (auto& [holder, failed] : finished)
+				{
+					(*holder)->Finish(failed);
+					delete holder;
+				}
+
+				finished.Clear();
+
+				if (exit)
+					return 0;
+			}
+		}
+	};
+#endif
+
+#ifdef BLAZE_PLATFORM_WINDOWS
+	/*
+		Reads files opened by the reader through an I/O completion port. A completion thread continues reads that
+		are cut short (large reads are split) and finishes the requests. Files given by FileStreamBase aren't opened
+		for overlapped I/O, their reads go to a thread pool instead.
+	*/
+	class IOCPAsyncFileReaderBackend : public AsyncFileReaderBackend
+	{
+	public:
+		IOCPAsyncFileReaderBackend(uint threadCount)
+			: port(NULL), inFlight(0), stop(false), fallback(threadCount)
+		{
+		}
+		~IOCPAsyncFileReaderBackend() override
+		{
+			if (completionThread.IsRunning())
+			{
+				stop.store(true, std::memory_order_release);
+
+				//Wakes the completion thread in case nothing is in flight
+				if (PostQueuedCompletionStatus(port, 0, 0, NULL) == 0)
+					Debug::Logger::LogError("Windows API", "PostQueuedCompletionStatus failed with error: \"" + Windows::GetErrorString(GetLastError()) + "\"");
+
+				completionThread.WaitToFinish();
+			}
+
+			if (port != NULL)
+				CloseHandle(port);
+		}
+
+		/*
+			Returns false if the completion port couldn't be created, the object must then be destroyed
+		*/
+		bool Initialize()
+		{
+			port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 1);
+
+			if (port == NULL)
+			{
+				Debug::Logger::LogError("Windows API", "CreateIoCompletionPort failed with error: \"" + Windows::GetErrorString(GetLastError()) + "\"");
+				return false;
+			}
+
+			if (completionThread.Run([this]() { return CompletionProc(); }))
+				return false;
+
+			return true;
+		}
+
+		void Submit(ArrayView<std::shared_ptr<AsyncReadRequest>> requests) override
+		{
+			Array<std::shared_ptr<AsyncReadRequest>> fallbackRequests;
+
+			for (uintMem i = 0; i < requests.Count(); ++i)
+			{
+				if (!requests[i]->overlappedFile)
+				{
+					fallbackRequests.AddBack(requests[i]);
+					continue;
+				}
+
+				if (CreateIoCompletionPort(requests[i]->file, port, 0, 0) == NULL)
+				{
+					Debug::Logger::LogError("Windows API", "CreateIoCompletionPort failed with error: \"" + Windows::GetErrorString(GetLastError()) + "\"");
+					requests[i]->Finish(true);
+					continue;
+				}
+
+				inFlight.fetch_add(1, std::memory_order_relaxed);
+				StartRead(new OverlappedRead{ { }, requests[i] });
+			}
+
+			if (!fallbackRequests.Empty())
+				fallback.Submit(ArrayView<std::shared_ptr<AsyncReadRequest>>(fallbackRequests.Ptr(), fallbackRequests.Count()));
+		}
+		AsyncFileReaderBackendType GetType() const override { return AsyncFileReaderBackendType::IOCompletionPort; }
+	private:
+		struct OverlappedRead
+		{
+			//First member, completion packets give a pointer to it
+			OVERLAPPED overlapped;
+			std::shared_ptr<AsyncReadRequest> request;
+		};
+
+		HANDLE port;
+		//Reads that were started but not finished, the completion thread stops only when this is 0
+		std::atomic<uintMem> inFlight;
+		std::atomic<bool> stop;
+
+		ThreadPoolAsyncFileReaderBackend fallback;
+		Thread completionThread;
+
+		void StartRead(OverlappedRead* read)
+		{
+			AsyncReadRequest& request = *read->request;
+			uint64 position = request.offset + request.readCount;
+
+			memset(&read->overlapped, 0, sizeof(read->overlapped));
+			read->overlapped.Offset = (DWORD)position;
+			read->overlapped.OffsetHigh = (DWORD)(position >> 32);
+
+			DWORD toRead = (DWORD)std::min<uintMem>(request.size - request.readCount, 0x80000000);
+
+			//A read that succeeds right away still queues a completion packet
+			if (ReadFile(request.file, request.buffer + request.readCount, toRead, NULL, &read->overlapped) == 0)
+			{
+				DWORD error = GetLastError();
+
+				if (error != ERROR_IO_PENDING)
+					CompleteRead(read, error, 0);
+			}
+		}
+		void CompleteRead(OverlappedRead* read, DWORD error, DWORD readCount)
+		{
+			AsyncReadRequest& request = *read->request;
+			bool failed = false;
+
+			if (error == ERROR_SUCCESS)
+			{
+				request.readCount += readCount;
+
+				if (readCount != 0 && request.readCount != request.size)
+				{
+					StartRead(read);
+					return;
+				}
+			}
+			else if (error != ERROR_HANDLE_EOF)
+			{
+				Debug::Logger::LogError("Windows API", "ReadFile failed with error: \"" + Windows::GetErrorString(error) + "\"");
+				failed = true;
+			}
+
+			request.Finish(failed);
+			delete read;
+
+			inFlight.fetch_sub(1, std::memory_order_release);
+		}
+		int CompletionProc()
+		{
+			while (true)
+			{
+				DWORD readCount = 0;
+				ULONG_PTR key = 0;
+				OVERLAPPED* overlapped = NULL;
+
+				BOOL succeeded = GetQueuedCompletionStatus(port, &readCount, &key, &overlapped, INFINITE);
+
+				if (overlapped != NULL)
+					CompleteRead((OverlappedRead*)overlapped, succeeded ? ERROR_SUCCESS : GetLastError(), readCount);
+				else if (succeeded == 0)
+					Debug::Logger::LogError("Windows API", "GetQueuedCompletionStatus failed with error: \"" + Windows::GetErrorString(GetLastError()) + "\"");
+
+				if (stop.load(std::memory_order_acquire) && inFlight.load(std::memory_order_acquire) == 0)
+					return 0;
+			}
+		}
+	};
+#endif
+
+	AsyncFileReader::AsyncFileReader()
+		: AsyncFileReader(4)
+	{
+	}
+	AsyncFileReader::AsyncFileReader(uint threadCount, uint queueDepth)
+		: backend(nullptr)
+	{
+#ifdef BLAZE_PLATFORM_WINDOWS
+		auto iocpBackend = new IOCPAsyncFileReaderBackend(threadCount);
+
+		if (iocpBackend->Initialize())
+		{
+			backend = iocpBackend;
+			return;
+		}
+
+		delete iocpBackend;
+#elif defined(BLAZE_PLATFORM_LINUX)
+		auto ioUringBackend = new IOUringAsyncFileReaderBackend();
+
+		if (ioUringBackend->Initialize(queueDepth))
+		{
+			backend = ioUringBackend;
+			return;
+		}
+
+		delete ioUringBackend;
+#endif
+
+		backend = new ThreadPoolAsyncFileReaderBackend(threadCount);
+	}
+	AsyncFileReader::~AsyncFileReader()
+	{
+		Submit();
+		delete backend;
+	}
+	AsyncReadHandle AsyncFileReader::ReadAsync(const FileStreamBase& file, uintMem offset, void* buffer, uintMem size)
+	{
+		auto request = std::make_shared<AsyncReadRequest>();
+#ifdef BLAZE_PLATFORM_WINDOWS
+		request->file = (NativeFile)file.GetHandle();
+#elif defined(BLAZE_PLATFORM_LINUX)
+		request->file = file.GetFileDescriptor();
+#endif
+		request->offset = offset;
+		request->buffer = (byte*)buffer;
+		request->size = size;
+
+		if (!file.IsOpen())
+		{
+			Debug::Logger::LogError("Blaze Engine", "Reading from a file that isn't open");
+			request->Finish(true);
+			return AsyncReadHandle(std::move(request));
+		}
+
+		return Queue(std::move(request));
+	}
+	AsyncReadHandle AsyncFileReader::ReadAsync(const Path& path, uintMem offset, void* buffer, uintMem size, FileUsageHint usageHint)
+	{
+		auto request = std::make_shared<AsyncReadRequest>();
+		request->offset = offset;
+		request->buffer = (byte*)buffer;
+		request->size = size;
+
+		if (!OpenNativeFile(path, usageHint, request->file))
+		{
+			request->Finish(true);
+			return AsyncReadHandle(std::move(request));
+		}
+
+		request->ownsFile = true;
+#ifdef BLAZE_PLATFORM_WINDOWS
+		request->overlappedFile = true;
+#endif
+		AdviseNativeFile(request->file, offset, size, usageHint);
+
+		return Queue(std::move(request));
+	}
+	AsyncReadHandle AsyncFileReader::ReadAsync(const Path& path, FileUsageHint usageHint)
+	{
+		auto request = std::make_shared<AsyncReadRequest>();
+
+		if (!OpenNativeFile(path, usageHint, request->file))
+		{
+			request->Finish(true);
+			return AsyncReadHandle(std::move(request));
+		}
+
+		request->ownsFile = true;
+#ifdef BLAZE_PLATFORM_WINDOWS
+		request->overlappedFile = true;
+#endif
+
+		if (!GetNativeFileSize(request->file, request->size))
+		{
+			request->Finish(true);
+			return AsyncReadHandle(std::move(request));
+		}
+
+		request->buffer = (byte*)Memory::Allocate(request->size);
+		request->ownsBuffer = true;
+		AdviseNativeFile(request->file, 0, request->size, usageHint);
+
+		return Queue(std::move(request));
+	}
+	void AsyncFileReader::Submit()
+	{
+		Array<std::shared_ptr<AsyncReadRequest>> requests;
+
+		{
+			std::lock_guard lock{ pendingMutex };
+			std::swap(requests, pending);
+		}
+
+		if (!requests.Empty())
+			backend->Submit(ArrayView<std::shared_ptr<AsyncReadRequest>>(requests.Ptr(), requests.Count()));
+	}
+	AsyncFileReaderBackendType AsyncFileReader::GetBackendType() const
+	{
+		return backend->GetType();
+	}
+	AsyncReadHandle AsyncFileReader::Queue(std::shared_ptr<AsyncReadRequest> request)
+	{
+		if (request->size == 0)
+		{
+			request->Finish(false);
+			return AsyncReadHandle(std::move(request));
+		}
+
+		AsyncReadHandle handle{ request };
+
+		std::lock_guard lock{ pendingMutex };
+		pending.AddBack(std::move(request));
+
+		return handle;
+	}
+}
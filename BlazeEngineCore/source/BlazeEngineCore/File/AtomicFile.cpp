@@ -0,0 +1,325 @@
+#include "pch.h"
+#include "BlazeEngineCore/File/AtomicFile.h"
+#include "BlazeEngineCore/File/FileSystem.h"
+#include "BlazeEngineCore/Utilities/StringParsing.h"
+#include <atomic>
+
+#ifdef BLAZE_PLATFORM_WINDOWS
+#include "BlazeEngineCore/Internal/Windows/WindowsPlatform.h"
+#undef CreateDirectory
+#undef DeleteFile
+#elif defined(BLAZE_PLATFORM_LINUX)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#else
+#error
+#endif
+
+namespace Blaze
+{
+	static constexpr uint MaxTemporaryFileAttempts = 16;
+
+	static Path GetTemporaryFilePath(const Path& path)
+	{
+		static std::atomic<uint32> counter = 0;
+
+#ifdef BLAZE_PLATFORM_WINDOWS
+		uint64 processID = GetCurrentProcessId();
+#elif defined(BLAZE_PLATFORM_LINUX)
+		uint64 processID = (uint64)getpid();
+#endif
+
+		std::filesystem::path temporaryPath = path.GetUnderlyingObject();
+		temporaryPath += "." + std::to_string(processID) + "-" + std::to_string(counter.fetch_add(1, std::memory_order_relaxed)) + ".tmp";
+		return Path(temporaryPath);
+	}
+	static Result SyncDirectory(const Path& directory)
+	{
+#ifdef BLAZE_PLATFORM_WINDOWS
+		//MoveFileEx with MOVEFILE_WRITE_THROUGH already waits for the rename to reach the disk
+		return Result();
+#elif defined(BLAZE_PLATFORM_LINUX)
+		//The rename is only durable once the directory entry is synced
+		int directoryDescriptor = open(directory.Empty() ? "." : directory.GetUnderlyingObject().c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+		if (directoryDescriptor == -1)
+			return BLAZE_ERROR_RESULT("Blaze Engine", "open given a path \"" + directory.ToString() + "\" failed with error: \"" + String(strerror(errno)) + "\"");
+
+		Result result;
+
+		if (fsync(directoryDescriptor) == -1)
+			result = BLAZE_ERROR_RESULT("Blaze Engine", "fsync given a path \"" + directory.ToString() + "\" failed with error: \"" + String(strerror(errno)) + "\"");
+
+		close(directoryDescriptor);
+
+		return result;
+#endif
+	}
+
+	AtomicFile::AtomicFile()
+	{
+	}
+	AtomicFile::AtomicFile(AtomicFile&& other) noexcept
+		: FileStreamBase(std::move(other)), FileStream(std::move(other)), path(std::move(other.path)), temporaryPath(std::move(other.temporaryPath))
+	{
+		other.temporaryPath = Path();
+	}
+	AtomicFile::AtomicFile(const Path& path)
+	{
+		Open(path);
+	}
+	AtomicFile::~AtomicFile()
+	{
+		if (IsOpen() || !temporaryPath.Empty())
+			Discard();
+	}
+	Result AtomicFile::Open(const Path& path)
+	{
+		if (IsOpen() || !temporaryPath.Empty())
+			CHECK_RESULT(Discard());
+
+		this->path = path;
+
+		Path parentPath = path.ParentPath();
+
+		if (!parentPath.Empty() && !parentPath.Exists())
+			CHECK_RESULT(FileSystem::CreateDirectoryRecursive(parentPath));
+
+#ifdef BLAZE_PLATFORM_WINDOWS
+		HANDLE handle = INVALID_HANDLE_VALUE;
+
+		for (uint i = 0; i < MaxTemporaryFileAttempts && handle == INVALID_HANDLE_VALUE; ++i)
+		{
+			Path candidate = GetTemporaryFilePath(path);
+			handle = CreateFileW(candidate.GetUnderlyingObject().c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, CREATE_NEW, FILE_ATTRIBUTE_NORMAL, NULL);
+
+			if (handle != INVALID_HANDLE_VALUE)
+				temporaryPath = candidate;
+			else if (GetLastError() != ERROR_FILE_EXISTS)
+				break;
+		}
+
+		if (handle == INVALID_HANDLE_VALUE)
+			return BLAZE_ERROR_RESULT("Windows API", "Failed to create a temporary file for a path \"" + path.ToString() + "\" with error: \"" + Windows::GetErrorString(GetLastError()) + "\"");
+
+		FileStreamBase::Open(handle);
+#elif defined(BLAZE_PLATFORM_LINUX)
+		//A replaced file keeps its permissions
+		struct stat targetStat;
+		bool targetExists = stat(path.GetUnderlyingObject().c_str(), &targetStat) == 0;
+		mode_t mode = targetExists ? (targetStat.st_mode & 07777) : 0644;
+
+		int fileDescriptor = open(parentPath.Empty() ? "." : parentPath.GetUnderlyingObject().c_str(), O_TMPFILE | O_RDWR | O_CLOEXEC, mode);
+
+		//Not every file system supports O_TMPFILE, in that case a named temporary file is used
+		if (fileDescriptor == -1 && (errno == EOPNOTSUPP || errno == EISDIR || errno == EINVAL))
+		{
+			for (uint i = 0; i < MaxTemporaryFileAttempts; ++i)
+			{
+				Path candidate = GetTemporaryFilePath(path);
+				fileDescriptor = open(candidate.GetUnderlyingObject().c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, mode);
+
+				if (fileDescriptor != -1)
+				{
+					temporaryPath = candidate;
+					break;
+				}
+
+				if (errno != EEXIST)
+					break;
+			}
+		}
+
+		if (fileDescriptor == -1)
+			return BLAZE_ERROR_RESULT("Blaze Engine", "Failed to create a temporary file for a path \"" + path.ToString() + "\" with error: \"" + String(strerror(errno)) + "\"");
+
+		//The mode given to open is masked by the umask
+		if (targetExists)
+			fchmod(fileDescriptor, mode);
+
+		FileStreamBase::Open(fileDescriptor);
+#endif
+
+		return Result();
+	}
+	Result AtomicFile::Commit()
+	{
+		if (!IsOpen())
+			return BLAZE_ERROR_RESULT("Blaze Engine", "Committing an atomic file that isn't open");
+
+		Result result = FinishSync();
+
+		if (!result)
+			result = ReplaceTarget();
+
+		if (result)
+		{
+			Discard();
+			return result;
+		}
+
+		return SyncDirectory(path.ParentPath());
+	}
+	Result AtomicFile::Discard()
+	{
+		CHECK_RESULT(Close());
+
+		if (!temporaryPath.Empty())
+		{
+			Path removedPath = std::move(temporaryPath);
+			temporaryPath = Path();
+
+			CHECK_RESULT(FileSystem::DeleteFile(removedPath));
+		}
+
+		return Result();
+	}
+	AtomicFile& AtomicFile::operator=(AtomicFile&& other) noexcept
+	{
+		if (IsOpen() || !temporaryPath.Empty())
+			Discard();
+
+		FileStream::operator=(std::move(other));
+		path = std::move(other.path);
+		temporaryPath = std::move(other.temporaryPath);
+		other.temporaryPath = Path();
+
+		return *this;
+	}
+	Result AtomicFile::StartSync()
+	{
+#ifdef BLAZE_PLATFORM_LINUX
+		//Starts writing the data out without waiting, so a group of files is written in parallel. Failing only loses
+		//that overlap, FinishSync still waits for the data
+		sync_file_range(GetFileDescriptor(), 0, 0, SYNC_FILE_RANGE_WRITE);
+#endif
+		return Result();
+	}
+	Result AtomicFile::FinishSync()
+	{
+#ifdef BLAZE_PLATFORM_WINDOWS
+		if (FlushFileBuffers(GetHandle()) == 0)
+			return BLAZE_ERROR_RESULT("Windows API", "FlushFileBuffers given a path \"" + temporaryPath.ToString() + "\" failed with error: \"" + Windows::GetErrorString(GetLastError()) + "\"");
+#elif defined(BLAZE_PLATFORM_LINUX)
+		if (fdatasync(GetFileDescriptor()) == -1)
+			return BLAZE_ERROR_RESULT("Blaze Engine", "fdatasync for a path \"" + path.ToString() + "\" failed with error: \"" + String(strerror(errno)) + "\"");
+#endif
+		return Result();
+	}
+	Result AtomicFile::ReplaceTarget()
+	{
+#ifdef BLAZE_PLATFORM_WINDOWS
+		//The file can't be renamed while it's open
+		CHECK_RESULT(Close());
+
+		if (MoveFileExW(temporaryPath.GetUnderlyingObject().c_str(), path.GetUnderlyingObject().c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) == 0)
+			return BLAZE_ERROR_RESULT("Windows API", "MoveFileExW given a path \"" + temporaryPath.ToString() + "\" as source and \"" + path.ToString() + "\" as destination failed with error: \"" + Windows::GetErrorString(GetLastError()) + "\"");
+
+		temporaryPath = Path();
+#elif defined(BLAZE_PLATFORM_LINUX)
+		if (temporaryPath.Empty())
+		{
+			//linkat can't replace an existing file, so the unnamed file is linked under a temporary name first and
+			//then renamed over the target like a named one
+			std::string fileDescriptorPath = "/proc/self/fd/" + std::to_string(GetFileDescriptor());
+
+			for (uint i = 0; i < MaxTemporaryFileAttempts; ++i)
+			{
+				Path candidate = GetTemporaryFilePath(path);
+
+				if (linkat(AT_FDCWD, fileDescriptorPath.c_str(), AT_FDCWD, candidate.GetUnderlyingObject().c_str(), AT_SYMLINK_FOLLOW) == 0)
+				{
+					temporaryPath = candidate;
+					break;
+				}
+
+				if (errno != EEXIST)
+					break;
+			}
+
+			if (temporaryPath.Empty())
+				return BLAZE_ERROR_RESULT("Blaze Engine", "linkat for a path \"" + path.ToString() + "\" failed with error: \"" + String(strerror(errno)) + "\"");
+		}
+
+		if (rename(temporaryPath.GetUnderlyingObject().c_str(), path.GetUnderlyingObject().c_str()) == -1)
+			return BLAZE_ERROR_RESULT("Blaze Engine", "rename given a path \"" + temporaryPath.ToString() + "\" as source and \"" + path.ToString() + "\" as destination failed with error: \"" + String(strerror(errno)) + "\"");
+
+		temporaryPath = Path();
+
+		CHECK_RESULT(Close());
+#endif
+		return Result();
+	}
+
+	FileCommitGroup::FileCommitGroup()
+	{
+	}
+	FileCommitGroup::~FileCommitGroup()
+	{
+		Clear();
+	}
+	void FileCommitGroup::Add(AtomicFile&& file)
+	{
+		files.AddBack(std::move(file));
+	}
+	Result FileCommitGroup::Commit()
+	{
+		Result result;
+
+		for (auto& file : files)
+			if (file.IsOpen())
+				file.StartSync();
+
+		Array<Path> directories;
+
+		for (auto& file : files)
+		{
+			if (!file.IsOpen())
+			{
+				result += BLAZE_ERROR_RESULT("Blaze Engine", "Committing an atomic file that isn't open");
+				continue;
+			}
+
+			Result fileResult = file.FinishSync();
+
+			if (!fileResult)
+				fileResult = file.ReplaceTarget();
+
+			if (fileResult)
+			{
+				file.Discard();
+				result += std::move(fileResult);
+				continue;
+			}
+
+			Path directory = file.GetPath().ParentPath();
+
+			bool found = false;
+			for (auto& other : directories)
+				if (other == directory)
+				{
+					found = true;
+					break;
+				}
+
+			if (!found)
+				directories.AddBack(std::move(directory));
+		}
+
+		//Every directory is synced once no matter how many of the files it holds
+		for (auto& directory : directories)
+			result += SyncDirectory(directory);
+
+		files.Clear();
+
+		return result;
+	}
+	void FileCommitGroup::Clear()
+	{
+		//Destroying the files discards them
+		files.Clear();
+	}
+}
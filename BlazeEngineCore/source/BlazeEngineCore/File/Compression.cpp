@@ -0,0 +1,362 @@
+#include "pch.h"
+#include "BlazeEngineCore/File/Compression.h"
+
+namespace Blaze::BlazeLZ
+{
+	static constexpr uintMem MinMatch = 4;
+	//The last 5 bytes of a block are always literals
+	static constexpr uintMem LastLiterals = 5;
+	//The last match must start at least 12 bytes before the end of the block
+	static constexpr uintMem MatchFindLimit = 12;
+	static constexpr uintMem MaxOffset = 65535;
+
+	static constexpr uintMem FastHashLog = 14;
+	static constexpr uintMem HighHashLog = 16;
+	static constexpr uintMem HighSearchDepth = 64;
+
+	static inline uint32 Read32(const byte* ptr)
+	{
+		uint32 value;
+		memcpy(&value, ptr, sizeof(value));
+		return value;
+	}
+	template<uintMem HashLog>
+	static inline uint32 HashSequence(const byte* ptr)
+	{
+		return (Read32(ptr) * 2654435761u) >> (32 - HashLog);
+	}
+	static inline uintMem MatchLength(const byte* a, const byte* b, const byte* aLimit)
+	{
+		const byte* start = a;
+
+		while (a < aLimit && *a == *b)
+		{
+			++a;
+			++b;
+		}
+
+		return a - start;
+	}
+
+	static inline void WriteLength(byte*& out, uintMem length)
+	{
+		while (length >= 255)
+		{
+			*out++ = 255;
+			length -= 255;
+		}
+
+		*out++ = (byte)length;
+	}
+	/*
+		Writes a sequence of literals followed by a match, or only literals if 'matchLength' is 0. Returns false if
+		the sequence doesn't fit
+	*/
+	static bool WriteSequence(byte*& out, byte* outEnd, const byte* literals, uintMem literalCount, uintMem offset, uintMem matchLength)
+	{
+		uintMem maxSize = 1 + literalCount / 255 + 1 + literalCount + (matchLength == 0 ? 0 : 2 + matchLength / 255 + 1);
+
+		if ((uintMem)(outEnd - out) < maxSize)
+			return false;
+
+		byte* token = out++;
+
+		if (literalCount >= 15)
+		{
+			*token = 15 << 4;
+			WriteLength(out, literalCount - 15);
+		}
+		else
+			*token = (byte)(literalCount << 4);
+
+		if (literalCount != 0)
+			memcpy(out, literals, literalCount);
+
+		out += literalCount;
+
+		if (matchLength == 0)
+			return true;
+
+		out[0] = (byte)offset;
+		out[1] = (byte)(offset >> 8);
+		out += 2;
+
+		uintMem matchCode = matchLength - MinMatch;
+
+		if (matchCode >= 15)
+		{
+			*token |= 15;
+			WriteLength(out, matchCode - 15);
+		}
+		else
+			*token |= (byte)matchCode;
+
+		return true;
+	}
+
+	static uintMem CompressFast(const byte* src, uintMem srcSize, byte* dst, uintMem dstCapacity)
+	{
+		const byte* ip = src;
+		const byte* anchor = src;
+		const byte* end = src + srcSize;
+		byte* out = dst;
+		byte* outEnd = dst + dstCapacity;
+
+		if (srcSize > MatchFindLimit)
+		{
+			const byte* matchFindLimit = end - MatchFindLimit;
+			const byte* matchLimit = end - LastLiterals;
+
+			//Positions are relative to 'src', a zero initialized table points every hash at the start of the block
+			//which is always a valid position to compare against
+			uint32* table = (uint32*)Memory::Allocate(sizeof(uint32) << FastHashLog);
+			memset(table, 0, sizeof(uint32) << FastHashLog);
+
+			while (ip <= matchFindLimit)
+			{
+				uint32 hash = HashSequence<FastHashLog>(ip);
+				const byte* ref = src + table[hash];
+				table[hash] = (uint32)(ip - src);
+
+				if (ref >= ip || (uintMem)(ip - ref) > MaxOffset || Read32(ref) != Read32(ip))
+				{
+					//Step faster through data that doesn't compress
+					ip += 1 + ((ip - anchor) >> 6);
+					continue;
+				}
+
+				uintMem length = MinMatch + MatchLength(ip + MinMatch, ref + MinMatch, matchLimit);
+
+				while (ip > anchor && ref > src && ip[-1] == ref[-1])
+				{
+					--ip;
+					--ref;
+					++length;
+				}
+
+				if (!WriteSequence(out, outEnd, anchor, ip - anchor, ip - ref, length))
+				{
+					Memory::Free(table);
+					return 0;
+				}
+
+				ip += length;
+				anchor = ip;
+
+				if (ip <= matchFindLimit)
+					table[HashSequence<FastHashLog>(ip - 2)] = (uint32)(ip - 2 - src);
+			}
+
+			Memory::Free(table);
+		}
+
+		if (!WriteSequence(out, outEnd, anchor, end - anchor, 0, 0))
+			return 0;
+
+		return out - dst;
+	}
+
+	static uintMem CompressHigh(const byte* src, uintMem srcSize, byte* dst, uintMem dstCapacity)
+	{
+		const byte* ip = src;
+		const byte* anchor = src;
+		const byte* end = src + srcSize;
+		byte* out = dst;
+		byte* outEnd = dst + dstCapacity;
+
+		if (srcSize > MatchFindLimit)
+		{
+			const byte* matchFindLimit = end - MatchFindLimit;
+			const byte* matchLimit = end - LastLiterals;
+
+			//'head' holds the last position + 1 with each hash, 0 meaning none. 'chain' holds the distance from each
+			//position to the previous one with the same hash, indexed by the position modulo the window size
+			uint32* head = (uint32*)Memory::Allocate(sizeof(uint32) << HighHashLog);
+			uint16* chain = (uint16*)Memory::Allocate(sizeof(uint16) * (MaxOffset + 1));
+			memset(head, 0, sizeof(uint32) << HighHashLog);
+
+			const byte* nextInsert = src;
+
+			while (ip <= matchFindLimit)
+			{
+				for (; nextInsert < ip; ++nextInsert)
+				{
+					uint32 position = (uint32)(nextInsert - src);
+					uint32 hash = HashSequence<HighHashLog>(nextInsert);
+					uintMem distance = head[hash] == 0 ? 0 : position - (head[hash] - 1);
+
+					chain[position & MaxOffset] = distance > MaxOffset ? 0 : (uint16)distance;
+					head[hash] = position + 1;
+				}
+
+				const byte* bestRef = nullptr;
+				uintMem bestLength = MinMatch - 1;
+				uint32 candidate = head[HashSequence<HighHashLog>(ip)];
+
+				for (uintMem depth = 0; candidate != 0 && depth < HighSearchDepth; ++depth)
+				{
+					uint32 position = candidate - 1;
+					const byte* ref = src + position;
+
+					if ((uintMem)(ip - ref) > MaxOffset)
+						break;
+
+					//Checking the byte past the best length first rejects most candidates without a full compare
+					if (ip + bestLength < matchLimit && ref[bestLength] == ip[bestLength] && Read32(ref) == Read32(ip))
+					{
+						uintMem length = MinMatch + MatchLength(ip + MinMatch, ref + MinMatch, matchLimit);
+
+						if (length > bestLength)
+						{
+							bestLength = length;
+							bestRef = ref;
+
+							if (ip + length == matchLimit)
+								break;
+						}
+					}
+
+					uint16 distance = chain[position & MaxOffset];
+
+					if (distance == 0)
+						break;
+
+					candidate = position - distance + 1;
+				}
+
+				if (bestRef == nullptr)
+				{
+					++ip;
+					continue;
+				}
+
+				while (ip > anchor && bestRef > src && ip[-1] == bestRef[-1])
+				{
+					--ip;
+					--bestRef;
+					++bestLength;
+				}
+
+				if (!WriteSequence(out, outEnd, anchor, ip - anchor, ip - bestRef, bestLength))
+				{
+					Memory::Free(head);
+					Memory::Free(chain);
+					return 0;
+				}
+
+				ip += bestLength;
+				anchor = ip;
+			}
+
+			Memory::Free(head);
+			Memory::Free(chain);
+		}
+
+		if (!WriteSequence(out, outEnd, anchor, end - anchor, 0, 0))
+			return 0;
+
+		return out - dst;
+	}
+
+	uintMem CompressBound(uintMem size)
+	{
+		return size + size / 255 + 16;
+	}
+	uintMem Compress(const void* src, uintMem srcSize, void* dst, uintMem dstCapacity, CompressionLevel level)
+	{
+		//Positions are stored as 32-bit values
+		if (srcSize > 0x7E000000)
+			return 0;
+
+		switch (level)
+		{
+		case CompressionLevel::High:
+			return CompressHigh((const byte*)src, srcSize, (byte*)dst, dstCapacity);
+		case CompressionLevel::Fast:
+		default:
+			return CompressFast((const byte*)src, srcSize, (byte*)dst, dstCapacity);
+		}
+	}
+	bool Decompress(const void* src, uintMem srcSize, void* dst, uintMem dstSize)
+	{
+		const byte* ip = (const byte*)src;
+		const byte* ipEnd = ip + srcSize;
+		byte* out = (byte*)dst;
+		byte* outStart = out;
+		byte* outEnd = out + dstSize;
+
+		while (ip < ipEnd)
+		{
+			byte token = *ip++;
+			uintMem literalCount = token >> 4;
+
+			if (literalCount == 15)
+			{
+				byte value;
+				do
+				{
+					if (ip == ipEnd)
+						return false;
+
+					value = *ip++;
+					literalCount += value;
+				} while (value == 255);
+			}
+
+			if (literalCount > (uintMem)(ipEnd - ip) || literalCount > (uintMem)(outEnd - out))
+				return false;
+
+			if (literalCount != 0)
+				memcpy(out, ip, literalCount);
+
+			ip += literalCount;
+			out += literalCount;
+
+			//The last sequence has no match
+			if (ip == ipEnd)
+				break;
+
+			if (ipEnd - ip < 2)
+				return false;
+
+			uintMem offset = ip[0] | ((uintMem)ip[1] << 8);
+			ip += 2;
+
+			if (offset == 0 || offset > (uintMem)(out - outStart))
+				return false;
+
+			uintMem length = token & 15;
+
+			if (length == 15)
+			{
+				byte value;
+				do
+				{
+					if (ip == ipEnd)
+						return false;
+
+					value = *ip++;
+					length += value;
+				} while (value == 255);
+			}
+
+			length += MinMatch;
+
+			if (length > (uintMem)(outEnd - out))
+				return false;
+
+			const byte* match = out - offset;
+
+			if (offset >= length)
+				memcpy(out, match, length);
+			else
+				//Overlapping matches repeat the last 'offset' bytes
+				for (uintMem i = 0; i < length; ++i)
+					out[i] = match[i];
+
+			out += length;
+		}
+
+		return out == outEnd;
+	}
+}
@@ -0,0 +1,581 @@
+#include "pch.h"
+#include "BlazeEngineCore/File/DirectoryWalker.h"
+#include "BlazeEngineCore/Threading/JobSystem.h"
+#include <algorithm>
+
+#ifdef BLAZE_PLATFORM_WINDOWS
+#include "BlazeEngineCore/Internal/Windows/WindowsPlatform.h"
+#elif defined(BLAZE_PLATFORM_LINUX)
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <ctime>
+#include <cerrno>
+#include <cstring>
+#else
+#error
+#endif
+
+namespace Blaze
+{
+	struct DirectoryWalkEntry
+	{
+		String name;
+		uint64 size;
+		uint64 modificationTime;
+		bool isDirectory;
+	};
+
+	static std::filesystem::path GetDirectoryWalkPath(const std::filesystem::path& root, StringView relativePath)
+	{
+		if (relativePath.Empty())
+			return root;
+
+		return root / std::u8string_view((const char8_t*)relativePath.Ptr(), relativePath.Count());
+	}
+
+#ifdef BLAZE_PLATFORM_WINDOWS
+	//Modification times are FILETIMEs, in 100ns units
+	static constexpr uint64 RacyModificationTimeWindow = 20000000;
+
+	static uint64 FileTimeToUInt64(const FILETIME& time)
+	{
+		return ((uint64)time.dwHighDateTime << 32) | time.dwLowDateTime;
+	}
+	static uint64 GetCurrentFileTime()
+	{
+		FILETIME time;
+		GetSystemTimeAsFileTime(&time);
+		return FileTimeToUInt64(time);
+	}
+	static Result GetDirectoryModificationTime(const std::filesystem::path& path, uint64& time)
+	{
+		WIN32_FILE_ATTRIBUTE_DATA data;
+
+		if (GetFileAttributesExW(path.c_str(), GetFileExInfoStandard, &data) == 0)
+			return BLAZE_ERROR_RESULT("Windows API", "GetFileAttributesExW given a path \"" + Path(path).ToString() + "\" failed with error: \"" + Windows::GetErrorString(GetLastError()) + "\"");
+
+		time = FileTimeToUInt64(data.ftLastWriteTime);
+		return Result();
+	}
+	static Result EnumerateDirectory(const std::filesystem::path& path, Array<DirectoryWalkEntry>& entries)
+	{
+		WIN32_FIND_DATAW data;
+		//FindExInfoBasic skips the short names and the large fetch returns more entries per system call
+		HANDLE find = FindFirstFileExW((path / L"*").c_str(), FindExInfoBasic, &data, FindExSearchNameMatch, NULL, FIND_FIRST_EX_LARGE_FETCH);
+
+		if (find == INVALID_HANDLE_VALUE)
+		{
+			DWORD error = GetLastError();
+
+			if (error == ERROR_FILE_NOT_FOUND)
+				return Result();
+
+			return BLAZE_ERROR_RESULT("Windows API", "FindFirstFileExW given a path \"" + Path(path).ToString() + "\" failed with error: \"" + Windows::GetErrorString(error) + "\"");
+		}
+
+		do
+		{
+			const wchar_t* name = data.cFileName;
+
+			if (name[0] == L'.' && (name[1] == L'\0' || (name[1] == L'.' && name[2] == L'\0')))
+				continue;
+
+			bool isDirectory = (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0;
+
+			//Don't follow directory symbolic links and junctions
+			if (isDirectory && (data.dwFileAttributes & FILE_ATTRIBUTE_REPARSE_POINT) != 0)
+				continue;
+
+			auto u8 = std::filesystem::path(name).u8string();
+
+			DirectoryWalkEntry& entry = *entries.AddBack();
+			entry.name = String((const char*)u8.data(), u8.size());
+			entry.isDirectory = isDirectory;
+			entry.size = isDirectory ? 0 : ((uint64)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+			entry.modificationTime = FileTimeToUInt64(data.ftLastWriteTime);
+		} while (FindNextFileW(find, &data) != 0);
+
+		DWORD error = GetLastError();
+		FindClose(find);
+
+		if (error != ERROR_NO_MORE_FILES)
+			return BLAZE_ERROR_RESULT("Windows API", "FindNextFileW given a path \"" + Path(path).ToString() + "\" failed with error: \"" + Windows::GetErrorString(error) + "\"");
+
+		return Result();
+	}
+	static void StatDirectoryFiles(const std::filesystem::path& path, Array<DirectoryWalkEntry>& entries)
+	{
+		for (uintMem i = 0; i < entries.Count();)
+		{
+			DirectoryWalkEntry& entry = entries[i];
+
+			if (entry.isDirectory)
+			{
+				++i;
+				continue;
+			}
+
+			WIN32_FILE_ATTRIBUTE_DATA data;
+
+			if (GetFileAttributesExW(GetDirectoryWalkPath(path, entry.name).c_str(), GetFileExInfoStandard, &data) == 0)
+			{
+				//The file was deleted after the directory was checked
+				entries.EraseAt(i);
+				continue;
+			}
+
+			entry.size = ((uint64)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+			entry.modificationTime = FileTimeToUInt64(data.ftLastWriteTime);
+			++i;
+		}
+	}
+#elif defined(BLAZE_PLATFORM_LINUX)
+	//Modification times are in nanoseconds since the epoch
+	static constexpr uint64 RacyModificationTimeWindow = 2000000000;
+
+	struct LinuxDirent64
+	{
+		uint64 d_ino;
+		int64 d_off;
+		unsigned short d_reclen;
+		unsigned char d_type;
+		char d_name[];
+	};
+
+	static uint64 StatModificationTime(const struct stat& st)
+	{
+		return (uint64)st.st_mtim.tv_sec * 1000000000 + (uint64)st.st_mtim.tv_nsec;
+	}
+	static uint64 GetCurrentFileTime()
+	{
+		timespec time;
+		clock_gettime(CLOCK_REALTIME, &time);
+		return (uint64)time.tv_sec * 1000000000 + (uint64)time.tv_nsec;
+	}
+	static Result GetDirectoryModificationTime(const std::filesystem::path& path, uint64& time)
+	{
+		struct stat st;
+
+		if (stat(path.c_str(), &st) != 0)
+			return BLAZE_ERROR_RESULT("Blaze Engine", "stat given a path \"" + Path(path).ToString() + "\" failed with error: \"" + String(strerror(errno)) + "\"");
+
+		time = StatModificationTime(st);
+		return Result();
+	}
+	static Result EnumerateDirectory(const std::filesystem::path& path, Array<DirectoryWalkEntry>& entries)
+	{
+		int fd = open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+		if (fd == -1)
+			return BLAZE_ERROR_RESULT("Blaze Engine", "open given a path \"" + Path(path).ToString() + "\" failed with error: \"" + String(strerror(errno)) + "\"");
+
+		alignas(LinuxDirent64) char buffer[32768];
+
+		while (true)
+		{
+			long count = syscall(SYS_getdents64, fd, buffer, sizeof(buffer));
+
+			if (count == -1)
+			{
+				if (errno == EINTR)
+					continue;
+
+				Result result = BLAZE_ERROR_RESULT("Blaze Engine", "getdents64 given a path \"" + Path(path).ToString() + "\" failed with error: \"" + String(strerror(errno)) + "\"");
+				close(fd);
+				return result;
+			}
+
+			if (count == 0)
+				break;
+
+			for (long offset = 0; offset < count;)
+			{
+				const LinuxDirent64* dirent = (const LinuxDirent64*)(buffer + offset);
+				offset += dirent->d_reclen;
+
+				const char* name = dirent->d_name;
+
+				if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))
+					continue;
+
+				unsigned char type = dirent->d_type;
+				struct stat st;
+
+				//Some file systems don't report the type
+				if (type == DT_UNKNOWN)
+				{
+					if (fstatat(fd, name, &st, AT_SYMLINK_NOFOLLOW) != 0)
+						continue;
+
+					type = S_ISDIR(st.st_mode) ? DT_DIR : S_ISLNK(st.st_mode) ? DT_LNK : S_ISREG(st.st_mode) ? DT_REG : DT_UNKNOWN;
+				}
+
+				if (type == DT_DIR)
+				{
+					DirectoryWalkEntry& entry = *entries.AddBack();
+					entry.name = String(name, strlen(name));
+					entry.isDirectory = true;
+					entry.size = 0;
+					entry.modificationTime = 0;
+					continue;
+				}
+
+				//Symbolic links are followed only to regular files
+				if (type != DT_REG && type != DT_LNK)
+					continue;
+
+				if (fstatat(fd, name, &st, 0) != 0 || !S_ISREG(st.st_mode))
+					continue;
+
+				DirectoryWalkEntry& entry = *entries.AddBack();
+				entry.name = String(name, strlen(name));
+				entry.isDirectory = false;
+				entry.size = (uint64)st.st_size;
+				entry.modificationTime = StatModificationTime(st);
+			}
+		}
+
+		close(fd);
+		return Result();
+	}
+	static void StatDirectoryFiles(const std::filesystem::path& path, Array<DirectoryWalkEntry>& entries)
+	{
+		int fd = open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+		for (uintMem i = 0; i < entries.Count();)
+		{
+			DirectoryWalkEntry& entry = entries[i];
+
+			if (entry.isDirectory)
+			{
+				++i;
+				continue;
+			}
+
+			struct stat st;
+
+			//The file was deleted after the directory was checked
+			if (fd == -1 || fstatat(fd, entry.name.Ptr(), &st, 0) != 0 || !S_ISREG(st.st_mode))
+			{
+				entries.EraseAt(i);
+				continue;
+			}
+
+			entry.size = (uint64)st.st_size;
+			entry.modificationTime = StatModificationTime(st);
+			++i;
+		}
+
+		if (fd != -1)
+			close(fd);
+	}
+#endif
+
+	/*
+		Orders paths as if '/' was smaller than any other character, so that a directory is directly followed by its
+		contents
+	*/
+	static bool IsDirectoryWalkPathLess(StringView left, StringView right)
+	{
+		uintMem count = std::min(left.Count(), right.Count());
+
+		for (uintMem i = 0; i < count; ++i)
+		{
+			unsigned char a = left[i] == '/' ? 0 : (unsigned char)left[i];
+			unsigned char b = right[i] == '/' ? 0 : (unsigned char)right[i];
+
+			if (a != b)
+				return a < b;
+		}
+
+		return left.Count() < right.Count();
+	}
+	static bool IsInDirectory(StringView path, StringView directory)
+	{
+		if (directory.Empty())
+			return true;
+
+		return path.Count() > directory.Count() && path[directory.Count()] == '/' && memcmp(path.Ptr(), directory.Ptr(), directory.Count()) == 0;
+	}
+	static const DirectoryEntryInfo* FindDirectoryWalkEntry(ArrayView<DirectoryEntryInfo> entries, StringView path)
+	{
+		const DirectoryEntryInfo* end = entries.Ptr() + entries.Count();
+		const DirectoryEntryInfo* it = std::lower_bound(entries.Ptr(), end, path, [](const DirectoryEntryInfo& entry, StringView path) { return IsDirectoryWalkPathLess(entry.path, path); });
+
+		if (it == end || StringView(it->path) != path)
+			return nullptr;
+
+		return it;
+	}
+	/*
+		Collects the direct children of a directory from a snapshot, their sizes and times are read again later
+	*/
+	static void GetSnapshotDirectoryChildren(ArrayView<DirectoryEntryInfo> entries, StringView directory, Array<DirectoryWalkEntry>& children)
+	{
+		const DirectoryEntryInfo* end = entries.Ptr() + entries.Count();
+		const DirectoryEntryInfo* it = entries.Ptr();
+
+		if (!directory.Empty())
+			it = FindDirectoryWalkEntry(entries, directory) + 1;
+
+		uintMem prefixSize = directory.Empty() ? 0 : directory.Count() + 1;
+
+		while (it != end && IsInDirectory(it->path, directory))
+		{
+			DirectoryWalkEntry& child = *children.AddBack();
+			child.name = String(StringView(it->path.Ptr() + prefixSize, it->path.Count() - prefixSize));
+			child.isDirectory = it->isDirectory;
+			child.size = 0;
+			child.modificationTime = 0;
+
+			if (it->isDirectory)
+			{
+				//Skip the contents of the subdirectory, they directly follow it
+				StringView subdirectory = it->path;
+				it = std::partition_point(it + 1, end, [&](const DirectoryEntryInfo& entry) { return IsInDirectory(entry.path, subdirectory); });
+			}
+			else
+				++it;
+		}
+	}
+
+	struct DirectoryWalkState
+	{
+		std::filesystem::path root;
+		const DirectorySnapshot* previous;
+		uint64 previousRootModificationTime;
+		uint64 previousScanTime;
+
+		JobSystem* jobSystem;
+		//Directories scheduled or being walked, the walk is finished when it reaches 0
+		std::atomic<uint32> pendingCount;
+
+		//Guards the result and the entries
+		std::mutex mutex;
+		Result result;
+		Array<DirectoryEntryInfo> entries;
+	};
+
+	static void WalkDirectory(DirectoryWalkState& state, StringView relativePath, Array<DirectoryEntryInfo>& outputEntries, Array<String>& subdirectories)
+	{
+		std::filesystem::path path = GetDirectoryWalkPath(state.root, relativePath);
+
+		uint64 modificationTime = 0;
+
+		//A subdirectory that can't be read was most likely deleted while walking, it is left out of the snapshot
+		if (Result result = GetDirectoryModificationTime(path, modificationTime))
+		{
+			result.ClearSilent();
+			return;
+		}
+
+		Array<DirectoryWalkEntry> children;
+		bool reused = false;
+
+		if (state.previous != nullptr)
+		{
+			uint64 previousModificationTime;
+			bool found = true;
+
+			if (relativePath.Empty())
+				previousModificationTime = state.previousRootModificationTime;
+			else if (const DirectoryEntryInfo* previousEntry = FindDirectoryWalkEntry(state.previous->GetEntries(), relativePath); previousEntry != nullptr && previousEntry->isDirectory)
+				previousModificationTime = previousEntry->modificationTime;
+			else
+				found = false;
+
+			//Adding, removing or renaming an entry changes the directory modification time. Changes made in the same
+			//time step as the previous snapshot could have the same time, so recently changed directories are read again
+			if (found && previousModificationTime == modificationTime && modificationTime + RacyModificationTimeWindow < state.previousScanTime)
+			{
+				GetSnapshotDirectoryChildren(state.previous->GetEntries(), relativePath, children);
+				StatDirectoryFiles(path, children);
+				reused = true;
+			}
+		}
+
+		if (!reused)
+			if (Result result = EnumerateDirectory(path, children))
+			{
+				std::lock_guard lock{ state.mutex };
+				state.result += std::move(result);
+				return;
+			}
+
+		if (!relativePath.Empty())
+		{
+			DirectoryEntryInfo& entry = *outputEntries.AddBack();
+			entry.path = relativePath;
+			entry.size = 0;
+			entry.modificationTime = modificationTime;
+			entry.isDirectory = true;
+		}
+
+		for (auto& child : children)
+		{
+			String childPath = relativePath.Empty() ? std::move(child.name) : relativePath + StringView("/") + child.name;
+
+			if (child.isDirectory)
+				subdirectories.AddBack(std::move(childPath));
+			else
+			{
+				DirectoryEntryInfo& entry = *outputEntries.AddBack();
+				entry.path = std::move(childPath);
+				entry.size = child.size;
+				entry.modificationTime = child.modificationTime;
+				entry.isDirectory = false;
+			}
+		}
+	}
+	static void WalkDirectoryJob(DirectoryWalkState& state, const String& relativePath)
+	{
+		Array<DirectoryEntryInfo> entries;
+		Array<String> subdirectories;
+
+		WalkDirectory(state, relativePath, entries, subdirectories);
+
+		//Counted before this directory is done, so the count can't reach 0 while subdirectories are left
+		state.pendingCount.fetch_add((uint32)subdirectories.Count(), std::memory_order_relaxed);
+
+		for (auto& subdirectory : subdirectories)
+			state.jobSystem->Schedule([&state, subdirectory = std::move(subdirectory)]() { WalkDirectoryJob(state, subdirectory); });
+
+		std::lock_guard lock{ state.mutex };
+
+		for (auto& entry : entries)
+			state.entries.AddBack(std::move(entry));
+
+		//Notified under the lock, the walking thread locks the mutex before the state is destroyed
+		if (state.pendingCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			state.pendingCount.notify_all();
+	}
+
+	DirectorySnapshot::DirectorySnapshot()
+		: rootModificationTime(0), scanTime(0)
+	{
+	}
+	void DirectorySnapshot::Clear()
+	{
+		root = Path();
+		rootModificationTime = 0;
+		scanTime = 0;
+		entries.Clear();
+	}
+	const DirectoryEntryInfo* DirectorySnapshot::Find(StringView path) const
+	{
+		return FindDirectoryWalkEntry(entries, path);
+	}
+
+	DirectoryWalker::DirectoryWalker(JobSystem* jobSystem)
+		: jobSystem(jobSystem)
+	{
+	}
+	Result DirectoryWalker::Walk(const Path& directory, DirectorySnapshot& snapshot)
+	{
+		DirectorySnapshot newSnapshot;
+		CHECK_RESULT(Walk(directory, nullptr, newSnapshot));
+		snapshot = std::move(newSnapshot);
+		return Result();
+	}
+	Result DirectoryWalker::Rescan(DirectorySnapshot& snapshot, Array<DirectoryChange>& changes)
+	{
+		DirectorySnapshot newSnapshot;
+		CHECK_RESULT(Walk(snapshot.root, &snapshot, newSnapshot));
+
+		ArrayView<DirectoryEntryInfo> oldEntries = snapshot.entries;
+		ArrayView<DirectoryEntryInfo> newEntries = newSnapshot.entries;
+		uintMem i = 0;
+		uintMem j = 0;
+
+		//Both snapshots are sorted the same way so they are compared in a single pass
+		while (i < oldEntries.Count() || j < newEntries.Count())
+		{
+			if (j == newEntries.Count() || (i < oldEntries.Count() && IsDirectoryWalkPathLess(oldEntries[i].path, newEntries[j].path)))
+			{
+				changes.AddBack(DirectoryChange{ DirectoryChangeType::Removed, oldEntries[i].path, oldEntries[i].isDirectory });
+				++i;
+			}
+			else if (i == oldEntries.Count() || IsDirectoryWalkPathLess(newEntries[j].path, oldEntries[i].path))
+			{
+				changes.AddBack(DirectoryChange{ DirectoryChangeType::Added, newEntries[j].path, newEntries[j].isDirectory });
+				++j;
+			}
+			else
+			{
+				const DirectoryEntryInfo& oldEntry = oldEntries[i];
+				const DirectoryEntryInfo& newEntry = newEntries[j];
+
+				if (oldEntry.isDirectory != newEntry.isDirectory)
+				{
+					changes.AddBack(DirectoryChange{ DirectoryChangeType::Removed, oldEntry.path, oldEntry.isDirectory });
+					changes.AddBack(DirectoryChange{ DirectoryChangeType::Added, newEntry.path, newEntry.isDirectory });
+				}
+				else if (!newEntry.isDirectory && (oldEntry.size != newEntry.size || oldEntry.modificationTime != newEntry.modificationTime))
+					changes.AddBack(DirectoryChange{ DirectoryChangeType::Modified, newEntry.path, false });
+
+				++i;
+				++j;
+			}
+		}
+
+		snapshot = std::move(newSnapshot);
+		return Result();
+	}
+	Result DirectoryWalker::Walk(const Path& directory, const DirectorySnapshot* previous, DirectorySnapshot& snapshot)
+	{
+		DirectoryWalkState state;
+		state.root = directory.GetUnderlyingObject();
+		state.previous = previous;
+		state.previousRootModificationTime = previous != nullptr ? previous->rootModificationTime : 0;
+		state.previousScanTime = previous != nullptr ? previous->scanTime : 0;
+		state.jobSystem = jobSystem;
+		state.pendingCount.store(1, std::memory_order_relaxed);
+
+		snapshot.root = directory;
+		//Taken before reading anything, changes made during the walk are newer than the snapshot
+		snapshot.scanTime = GetCurrentFileTime();
+		CHECK_RESULT(GetDirectoryModificationTime(state.root, snapshot.rootModificationTime));
+
+		if (jobSystem != nullptr)
+		{
+			//Every directory is walked by its own job, the calling thread runs jobs until all of them are done
+			jobSystem->Schedule([&state]() { WalkDirectoryJob(state, String()); });
+			jobSystem->Wait(state.pendingCount);
+
+			//The last job may still be notifying
+			std::lock_guard lock{ state.mutex };
+		}
+		else
+		{
+			Array<String> directories;
+			Array<String> subdirectories;
+			directories.AddBack(String());
+
+			while (!directories.Empty())
+			{
+				String relativePath = std::move(directories.Last());
+				directories.EraseLast();
+
+				WalkDirectory(state, relativePath, state.entries, subdirectories);
+
+				for (auto& subdirectory : subdirectories)
+					directories.AddBack(std::move(subdirectory));
+
+				subdirectories.Clear();
+			}
+		}
+
+		CHECK_RESULT(std::move(state.result));
+
+		snapshot.entries = std::move(state.entries);
+
+		std::sort(snapshot.entries.Ptr(), snapshot.entries.Ptr() + snapshot.entries.Count(), [](const DirectoryEntryInfo& left, const DirectoryEntryInfo& right) {
+			return IsDirectoryWalkPathLess(left.path, right.path);
+			});
+
+		return Result();
+	}
+}
@@ -5,6 +5,11 @@
 #ifdef BLAZE_PLATFORM_WINDOWS
 #include "BlazeEngineCore/Internal/Windows/WindowsPlatform.h"
 #undef CreateDirectory
+#elif defined(BLAZE_PLATFORM_LINUX)
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
 #else
 #error
 #endif 
@@ -15,7 +20,7 @@ namespace Blaze
 	{
 	}
 	File::File(File&& other) noexcept
-		: FileStream(std::move(other))
+		: FileStreamBase(std::move(other)), FileStream(std::move(other))
 	{ 
 	}
 	File::File(const Path& path, FileAccessPermission mode)
@@ -117,6 +122,91 @@ namespace Blaze
 			return	BLAZE_ERROR_RESULT("Windows API", "CreateFileA given a path \"" + path.ToString() + "\" failed with error: \"" + Windows::GetErrorString(GetLastError()) + "\"");		
 
 		FileStreamBase::Open(handle);
+#elif defined(BLAZE_PLATFORM_LINUX)
+		int flags = O_CLOEXEC;
+
+		switch (mode)
+		{
+		case Blaze::FileAccessPermission::Read: flags |= O_RDONLY; break;
+		case Blaze::FileAccessPermission::Write: flags |= O_WRONLY; break;
+		case Blaze::FileAccessPermission::ReadWrite: flags |= O_RDWR; break;
+		default:
+			Debug::Logger::LogError("Blaze Engine", "Invalid FileAccessPermission enum value");
+			break;
+		}
+
+		switch (parameters.openOption)
+		{
+		case FileOpenOptions::CreateAlways: flags |= O_CREAT | O_TRUNC; break;
+		case FileOpenOptions::CreateNew: flags |= O_CREAT | O_EXCL; break;
+		case FileOpenOptions::OpenAlways: flags |= O_CREAT; break;
+		case FileOpenOptions::OpenExisting: break;
+		case FileOpenOptions::TruncateExisting: flags |= O_TRUNC; break;
+		default:
+			Debug::Logger::LogError("Blaze Engine", "Invalid FileOpenOption enum value");
+			break;
+		}
+
+		if (parameters.createSubdirectories)
+		{
+			Path parentPath = path.ParentPath();
+
+			if (!parentPath.Exists() && !parentPath.Empty())
+				FileSystem::CreateDirectory(parentPath);
+		}
+
+		int fileDescriptor = -1;
+
+		switch (parameters.locationHint)
+		{
+		case FileLifetimeOption::Normal: break;
+		case FileLifetimeOption::ShortLived: break;
+		case FileLifetimeOption::Temporary: {
+			//The file is written to before it can be read, so it needs write access
+			int tmpFileFlags = (flags & ~(O_ACCMODE | O_CREAT | O_EXCL | O_TRUNC)) | (mode == FileAccessPermission::Read ? O_RDWR : (flags & O_ACCMODE));
+			Path parentPath = path.ParentPath();
+
+			//An unnamed file in the directory of the path. It is never visible in the file system and is deleted
+			//when the last file descriptor is closed
+			fileDescriptor = open(parentPath.Empty() ? "." : parentPath.GetUnderlyingObject().c_str(), tmpFileFlags | O_TMPFILE, 0600);
+
+			//Not every file system supports O_TMPFILE, in that case the file is created normally and unlinked right away
+			if (fileDescriptor == -1 && (errno == EOPNOTSUPP || errno == EISDIR || errno == EINVAL))
+			{
+				fileDescriptor = open(path.GetUnderlyingObject().c_str(), tmpFileFlags | O_CREAT | O_EXCL, 0600);
+
+				if (fileDescriptor != -1)
+					unlink(path.GetUnderlyingObject().c_str());
+			}
+
+			if (fileDescriptor == -1)
+				return BLAZE_ERROR_RESULT("Blaze Engine", "Failed to create a temporary file given a path \"" + path.ToString() + "\" with error: \"" + String(strerror(errno)) + "\"");
+			break;
+		}
+		default:
+			Debug::Logger::LogError("Blaze Engine", "Invalid FileLifetimeOption enum value");
+			break;
+		}
+
+		if (fileDescriptor == -1)
+		{
+			fileDescriptor = open(path.GetUnderlyingObject().c_str(), flags, 0644);
+
+			if (fileDescriptor == -1)
+				return BLAZE_ERROR_RESULT("Blaze Engine", "open given a path \"" + path.ToString() + "\" failed with error: \"" + String(strerror(errno)) + "\"");
+		}
+
+		switch (parameters.usageHint)
+		{
+		case FileUsageHint::Normal: break;
+		case FileUsageHint::RandomAccess: posix_fadvise(fileDescriptor, 0, 0, POSIX_FADV_RANDOM); break;
+		case FileUsageHint::Sequential: posix_fadvise(fileDescriptor, 0, 0, POSIX_FADV_SEQUENTIAL); break;
+		default:
+			Debug::Logger::LogError("Blaze Engine", "Invalid FileUsageHint enum value");
+			break;
+		}
+
+		FileStreamBase::Open(fileDescriptor);
 #else
 #error
 #endif
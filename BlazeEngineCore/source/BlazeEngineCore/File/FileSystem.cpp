@@ -1,6 +1,14 @@
 #include "pch.h"
 #include "BlazeEngineCore/File/FileSystem.h"
 
+#ifdef BLAZE_PLATFORM_LINUX
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
 namespace Blaze
 {
     namespace FileSystem
@@ -44,6 +52,33 @@ namespace Blaze
         }
         Result ResizeFile(const Path& path, uintMem newSize)
         {
+#ifdef BLAZE_PLATFORM_LINUX
+            int fileDescriptor = open(path.GetUnderlyingObject().c_str(), O_WRONLY | O_CLOEXEC);
+            if (fileDescriptor == -1)
+                return BLAZE_ERROR_RESULT("Blaze Engine", "open given an path \"" + path.ToString() + "\" returned a error: \"" + String(strerror(errno)) + "\"");
+
+            Result result;
+            struct stat fileStat;
+
+            if (fstat(fileDescriptor, &fileStat) == -1)
+                result = BLAZE_ERROR_RESULT("Blaze Engine", "fstat given an path \"" + path.ToString() + "\" returned a error: \"" + String(strerror(errno)) + "\"");
+            else if (newSize > (uintMem)fileStat.st_size)
+            {
+                //Growing reserves the blocks up front so later writes don't fragment the file or fail on a full disk.
+                //File systems that don't support it fall back to a sparse extension
+                if (fallocate(fileDescriptor, 0, fileStat.st_size, (off_t)newSize - fileStat.st_size) == -1)
+                {
+                    if ((errno != EOPNOTSUPP && errno != ENOSYS) || ftruncate(fileDescriptor, (off_t)newSize) == -1)
+                        result = BLAZE_ERROR_RESULT("Blaze Engine", "Resizing a file given an path \"" + path.ToString() + "\" returned a error: \"" + String(strerror(errno)) + "\"");
+                }
+            }
+            else if (ftruncate(fileDescriptor, (off_t)newSize) == -1)
+                result = BLAZE_ERROR_RESULT("Blaze Engine", "ftruncate given an path \"" + path.ToString() + "\" returned a error: \"" + String(strerror(errno)) + "\"");
+
+            close(fileDescriptor);
+
+            return result;
+#else
             std::error_code ec;
             std::filesystem::resize_file(path.GetUnderlyingObject(), newSize, ec);
             if (ec)
@@ -52,6 +87,7 @@ namespace Blaze
                 return BLAZE_ERROR_RESULT("Blaze Engine", "std::filesystem::resize_file given an path \"" + path.ToString() + "\" returned a error: \"" + StringView(message.data(), message.size()) + "\"");
             }
             return Result();
+#endif
         }
         uintMem FileSize(const Path& path)
         {
@@ -0,0 +1,186 @@
+#include "pch.h"
+#include "BlazeEngineCore/File/MappedFile.h"
+
+#ifdef BLAZE_PLATFORM_WINDOWS
+#include "BlazeEngineCore/Internal/Windows/WindowsPlatform.h"
+#elif defined(BLAZE_PLATFORM_LINUX)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#else
+#error
+#endif
+
+namespace Blaze
+{
+	MappedFile::MappedFile()
+		: data(nullptr), size(0), isOpen(false)
+	{
+	}
+	MappedFile::MappedFile(MappedFile&& other) noexcept
+		: data(other.data), size(other.size), isOpen(other.isOpen)
+	{
+		other.data = nullptr;
+		other.size = 0;
+		other.isOpen = false;
+	}
+	MappedFile::MappedFile(const Path& path, FileUsageHint usageHint)
+		: data(nullptr), size(0), isOpen(false)
+	{
+		Open(path, usageHint);
+	}
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+	Result MappedFile::Open(const Path& path, FileUsageHint usageHint)
+	{
+		CHECK_RESULT(Close());
+
+#ifdef BLAZE_PLATFORM_WINDOWS
+		DWORD flagsAndAttributes = 0;
+
+		switch (usageHint)
+		{
+		case FileUsageHint::Normal: break;
+		case FileUsageHint::RandomAccess: flagsAndAttributes |= FILE_FLAG_RANDOM_ACCESS; break;
+		case FileUsageHint::Sequential: flagsAndAttributes |= FILE_FLAG_SEQUENTIAL_SCAN; break;
+		default:
+			Debug::Logger::LogError("Blaze Engine", "Invalid FileUsageHint enum value");
+			break;
+		}
+
+		auto wstring = path.GetUnderlyingObject().wstring();
+		HANDLE fileHandle = CreateFileW(wstring.data(), GENERIC_READ, FILE_SHARE_WRITE | FILE_SHARE_READ | FILE_SHARE_DELETE, NULL, OPEN_EXISTING, flagsAndAttributes, NULL);
+
+		if (fileHandle == INVALID_HANDLE_VALUE)
+			return BLAZE_ERROR_RESULT("Windows API", "CreateFileW given a path \"" + path.ToString() + "\" failed with error: \"" + Windows::GetErrorString(GetLastError()) + "\"");
+
+		LARGE_INTEGER fileSize;
+		if (GetFileSizeEx(fileHandle, &fileSize) == 0)
+		{
+			Result result = BLAZE_ERROR_RESULT("Windows API", "GetFileSizeEx failed with error: \"" + Windows::GetErrorString(GetLastError()) + "\"");
+			CloseHandle(fileHandle);
+			return result;
+		}
+
+		//Empty files cannot be mapped, they are represented by an open file with no data
+		if (fileSize.QuadPart == 0)
+		{
+			CloseHandle(fileHandle);
+			isOpen = true;
+			return Result();
+		}
+
+		HANDLE mappingHandle = CreateFileMappingW(fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+
+		if (mappingHandle == NULL)
+		{
+			Result result = BLAZE_ERROR_RESULT("Windows API", "CreateFileMappingW given a path \"" + path.ToString() + "\" failed with error: \"" + Windows::GetErrorString(GetLastError()) + "\"");
+			CloseHandle(fileHandle);
+			return result;
+		}
+
+		void* view = MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+
+		//The view keeps the mapping alive, the handles aren't needed anymore
+		CloseHandle(mappingHandle);
+		CloseHandle(fileHandle);
+
+		if (view == nullptr)
+			return BLAZE_ERROR_RESULT("Windows API", "MapViewOfFile given a path \"" + path.ToString() + "\" failed with error: \"" + Windows::GetErrorString(GetLastError()) + "\"");
+
+		data = view;
+		size = (uintMem)fileSize.QuadPart;
+		isOpen = true;
+#elif defined(BLAZE_PLATFORM_LINUX)
+		int fd = open(path.GetUnderlyingObject().c_str(), O_RDONLY | O_CLOEXEC);
+
+		if (fd == -1)
+			return BLAZE_ERROR_RESULT("Blaze Engine", "open given a path \"" + path.ToString() + "\" failed with error: \"" + String(strerror(errno)) + "\"");
+
+		struct stat fileStat;
+		if (fstat(fd, &fileStat) == -1)
+		{
+			Result result = BLAZE_ERROR_RESULT("Blaze Engine", "fstat failed with error: \"" + String(strerror(errno)) + "\"");
+			close(fd);
+			return result;
+		}
+
+		//Empty files cannot be mapped, they are represented by an open file with no data
+		if (fileStat.st_size == 0)
+		{
+			close(fd);
+			isOpen = true;
+			return Result();
+		}
+
+		void* view = mmap(nullptr, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+		//The mapping holds its own reference to the file
+		close(fd);
+
+		if (view == MAP_FAILED)
+			return BLAZE_ERROR_RESULT("Blaze Engine", "mmap given a path \"" + path.ToString() + "\" failed with error: \"" + String(strerror(errno)) + "\"");
+
+		switch (usageHint)
+		{
+		case FileUsageHint::Normal: break;
+		case FileUsageHint::RandomAccess: madvise(view, (size_t)fileStat.st_size, MADV_RANDOM); break;
+		case FileUsageHint::Sequential:
+			madvise(view, (size_t)fileStat.st_size, MADV_SEQUENTIAL);
+			madvise(view, (size_t)fileStat.st_size, MADV_WILLNEED);
+			break;
+		default:
+			Debug::Logger::LogError("Blaze Engine", "Invalid FileUsageHint enum value");
+			break;
+		}
+
+		data = view;
+		size = (uintMem)fileStat.st_size;
+		isOpen = true;
+#endif
+
+		return Result();
+	}
+	Result MappedFile::Close()
+	{
+		if (!isOpen)
+			return Result();
+
+		Result result;
+
+		if (data != nullptr)
+		{
+#ifdef BLAZE_PLATFORM_WINDOWS
+			if (UnmapViewOfFile(data) == 0)
+				result = BLAZE_ERROR_RESULT("Windows API", "UnmapViewOfFile failed with error: \"" + Windows::GetErrorString(GetLastError()) + "\"");
+#elif defined(BLAZE_PLATFORM_LINUX)
+			if (munmap(data, size) == -1)
+				result = BLAZE_ERROR_RESULT("Blaze Engine", "munmap failed with error: \"" + String(strerror(errno)) + "\"");
+#endif
+		}
+
+		data = nullptr;
+		size = 0;
+		isOpen = false;
+
+		return result;
+	}
+	MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+	{
+		Close();
+
+		data = other.data;
+		size = other.size;
+		isOpen = other.isOpen;
+		other.data = nullptr;
+		other.size = 0;
+		other.isOpen = false;
+
+		return *this;
+	}
+}
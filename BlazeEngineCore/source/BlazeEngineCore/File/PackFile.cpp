@@ -0,0 +1,245 @@
+#include "pch.h"
+#include "BlazeEngineCore/File/PackFile.h"
+#include "BlazeEngineCore/File/AtomicFile.h"
+#include "BlazeEngineCore/File/Compression.h"
+#include "BlazeEngineCore/File/MappedFile.h"
+#include "BlazeEngineCore/File/Stream/BufferedStream.h"
+#include <algorithm>
+
+namespace Blaze
+{
+	namespace PackFileFormat
+	{
+		uint64 Hash(const void* data, uintMem size, uint64 hash)
+		{
+			const byte* bytes = (const byte*)data;
+
+			for (uintMem i = 0; i < size; ++i)
+			{
+				hash ^= bytes[i];
+				hash *= 1099511628211ull;
+			}
+
+			return hash;
+		}
+		String NormalizePath(StringView path)
+		{
+			uintMem start = 0;
+			while (start < path.Count() && (path[start] == '/' || path[start] == '\\'))
+				++start;
+
+			String normalized{ StringView(path.Ptr() + start, path.Count() - start) };
+
+			for (uintMem i = 0; i < normalized.Count(); ++i)
+				if (normalized[i] == '\\')
+					normalized[i] = '/';
+
+			return normalized;
+		}
+		uint64 HashPath(StringView path)
+		{
+			uintMem start = 0;
+			while (start < path.Count() && (path[start] == '/' || path[start] == '\\'))
+				++start;
+
+			//Same as hashing the normalized path, without allocating it
+			uint64 hash = Hash(nullptr, 0);
+
+			for (uintMem i = start; i < path.Count(); ++i)
+			{
+				char character = path[i] == '\\' ? '/' : path[i];
+				hash = Hash(&character, 1, hash);
+			}
+
+			return hash;
+		}
+	}
+
+	static constexpr uintMem AlignPackOffset(uintMem offset)
+	{
+		return (offset + PackFileFormat::DataAlignment - 1) & ~(PackFileFormat::DataAlignment - 1);
+	}
+
+	PackFileBuilder::PackFileBuilder()
+	{
+	}
+	PackFileBuilder::~PackFileBuilder()
+	{
+	}
+	Result PackFileBuilder::AddFile(StringView packPath, const Path& sourcePath, PackFileFormat::Compression compression)
+	{
+		if (!sourcePath.IsFile())
+			return BLAZE_ERROR_RESULT("Blaze Engine", "Adding a file to a pack file builder that doesn't exist: \"" + sourcePath.ToString() + "\"");
+
+		BuilderEntry entry;
+		entry.packPath = PackFileFormat::NormalizePath(packPath);
+		entry.sourcePath = sourcePath;
+		entry.fromFile = true;
+		entry.compression = compression;
+
+		return AddEntry(std::move(entry));
+	}
+	Result PackFileBuilder::AddData(StringView packPath, ArrayView<byte> data, PackFileFormat::Compression compression)
+	{
+		BuilderEntry entry;
+		entry.packPath = PackFileFormat::NormalizePath(packPath);
+		entry.data = Array<byte>(data);
+		entry.fromFile = false;
+		entry.compression = compression;
+
+		return AddEntry(std::move(entry));
+	}
+	Result PackFileBuilder::AddDirectory(const Path& directory, StringView packPrefix, PackFileFormat::Compression compression)
+	{
+		std::error_code ec;
+		std::filesystem::recursive_directory_iterator it{ directory.GetUnderlyingObject(), ec };
+
+		if (ec)
+		{
+			auto message = ec.message();
+			return BLAZE_ERROR_RESULT("Blaze Engine", "std::filesystem::recursive_directory_iterator given a path \"" + directory.ToString() + "\" returned a error: \"" + StringView(message.data(), message.size()) + "\"");
+		}
+
+		Result result;
+
+		for (auto& directoryEntry : it)
+		{
+			if (!directoryEntry.is_regular_file())
+				continue;
+
+			auto relativePath = directoryEntry.path().lexically_relative(directory.GetUnderlyingObject()).generic_u8string();
+			String packPath = packPrefix.Empty() ? String() : String(packPrefix) + StringView("/");
+			packPath += StringView((const char*)relativePath.data(), relativePath.size());
+
+			result += AddFile(packPath, Path(directoryEntry.path()), compression);
+		}
+
+		return result;
+	}
+	Result PackFileBuilder::Build(const Path& outputPath)
+	{
+		using namespace PackFileFormat;
+
+		Array<Entry> table(entries.Count());
+		Array<uintMem> order(entries.Count());
+
+		for (uintMem i = 0; i < entries.Count(); ++i)
+		{
+			order[i] = i;
+			table[i] = Entry{ };
+			table[i].pathHash = PackFileFormat::Hash(entries[i].packPath.Ptr(), entries[i].packPath.Count());
+		}
+
+		//The table is sorted by path hash so that lookups can binary search it
+		std::sort(order.Ptr(), order.Ptr() + order.Count(), [&](uintMem a, uintMem b) { return table[a].pathHash < table[b].pathHash; });
+
+		//Equal paths have equal hashes, so only entries next to each other in the sorted order can be duplicates
+		for (uintMem i = 1; i < order.Count(); ++i)
+			for (uintMem j = i; j != 0 && table[order[j - 1]].pathHash == table[order[i]].pathHash; --j)
+				if (entries[order[j - 1]].packPath == entries[order[i]].packPath)
+					return BLAZE_ERROR_RESULT("Blaze Engine", "A file with the path \"" + entries[order[i]].packPath + "\" was added to the pack file builder more than once");
+
+		Header header{ };
+		header.magic = Magic;
+		header.version = Version;
+		header.entryCount = entries.Count();
+		header.entriesOffset = sizeof(Header);
+		header.pathsOffset = header.entriesOffset + entries.Count() * sizeof(Entry);
+
+		uint64 pathOffset = header.pathsOffset;
+		for (uintMem index : order)
+		{
+			table[index].pathOffset = pathOffset;
+			table[index].pathSize = (uint32)entries[index].packPath.Count();
+			pathOffset += entries[index].packPath.Count();
+		}
+		header.pathsSize = pathOffset - header.pathsOffset;
+
+		AtomicFile file;
+		CHECK_RESULT(file.Open(outputPath));
+
+		BufferedWriteStream stream{ file };
+		static const byte padding[DataAlignment]{ };
+
+		//The header and the table are written again at the end when the data offsets, sizes and hashes are known
+		stream.WriteValue(header);
+		for (uintMem index : order)
+			stream.WriteValue(table[index]);
+		for (uintMem index : order)
+			stream.WriteBytes(entries[index].packPath.Ptr(), entries[index].packPath.Count());
+
+		uint64 dataOffset = AlignPackOffset(pathOffset);
+		Array<byte> compressed;
+
+		for (uintMem index : order)
+		{
+			Entry& entry = table[index];
+			stream.WriteBytes(padding, dataOffset - stream.GetPosition());
+
+			ArrayView<byte> data;
+			MappedFile mappedFile;
+
+			if (entries[index].fromFile)
+			{
+				CHECK_RESULT(mappedFile.Open(entries[index].sourcePath, FileUsageHint::Sequential));
+				data = mappedFile.GetView();
+			}
+			else
+				data = entries[index].data;
+
+			entry.dataOffset = dataOffset;
+			entry.size = data.Count();
+			entry.compression = Compression::None;
+
+			if (entries[index].compression == Compression::BlazeLZ && data.Count() != 0)
+			{
+				//Packs are built ahead of time, so the slower level is worth it. Decompression speed is the same
+				compressed.Resize(BlazeLZ::CompressBound(data.Count()));
+				uintMem compressedSize = BlazeLZ::Compress(data.Ptr(), data.Count(), compressed.Ptr(), compressed.Count(), CompressionLevel::High);
+
+				//Data that doesn't get smaller is stored as it is, it can then be read without a copy
+				if (compressedSize != 0 && compressedSize < data.Count())
+				{
+					data = ArrayView<byte>(compressed.Ptr(), compressedSize);
+					entry.compression = Compression::BlazeLZ;
+				}
+			}
+
+			entry.storedSize = data.Count();
+			entry.contentHash = PackFileFormat::Hash(data.Ptr(), data.Count());
+
+			if (data.Count() != 0 && stream.WriteBytes(data.Ptr(), data.Count()) != data.Count())
+				return BLAZE_ERROR_RESULT("Blaze Engine", "Failed to write to pack file \"" + outputPath.ToString() + "\"");
+
+			dataOffset = AlignPackOffset(dataOffset + data.Count());
+		}
+
+		uint64 tableHash = PackFileFormat::Hash(nullptr, 0);
+		for (uintMem index : order)
+			tableHash = PackFileFormat::Hash(&table[index], sizeof(Entry), tableHash);
+		header.tableHash = tableHash;
+
+		if (!stream.SetPosition(0))
+			return BLAZE_ERROR_RESULT("Blaze Engine", "Failed to write to pack file \"" + outputPath.ToString() + "\"");
+
+		stream.WriteValue(header);
+		for (uintMem index : order)
+			stream.WriteValue(table[index]);
+
+		if (!stream.Flush())
+			return BLAZE_ERROR_RESULT("Blaze Engine", "Failed to write to pack file \"" + outputPath.ToString() + "\"");
+
+		return file.Commit();
+	}
+	Result PackFileBuilder::AddEntry(BuilderEntry&& entry)
+	{
+		if (entry.packPath.Empty())
+			return BLAZE_ERROR_RESULT("Blaze Engine", "Adding a file with an empty path to a pack file builder");
+
+		//Duplicate paths are found when building, checking them here would make adding many files quadratic
+
+		entries.AddBack(std::move(entry));
+
+		return Result();
+	}
+}
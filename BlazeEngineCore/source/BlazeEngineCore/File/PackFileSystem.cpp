@@ -0,0 +1,322 @@
+#include "pch.h"
+#include "BlazeEngineCore/File/PackFileSystem.h"
+#include "BlazeEngineCore/File/Compression.h"
+#include "BlazeEngineCore/Utilities/StringParsing.h"
+#include <algorithm>
+
+namespace Blaze
+{
+	PackFileReadStream::PackFileReadStream()
+		: position(0)
+	{
+	}
+	PackFileReadStream::PackFileReadStream(ArrayView<byte> data)
+		: data(data), position(0)
+	{
+	}
+	PackFileReadStream::~PackFileReadStream()
+	{
+	}
+	bool PackFileReadStream::MovePosition(intMem offset)
+	{
+		if (offset < 0 && (uintMem)-offset > position)
+			return false;
+		if (offset > 0 && position + (uintMem)offset > data.Count())
+			return false;
+
+		position += offset;
+		return true;
+	}
+	bool PackFileReadStream::SetPosition(uintMem offset)
+	{
+		if (offset > data.Count())
+			return false;
+
+		position = offset;
+		return true;
+	}
+	bool PackFileReadStream::SetPositionFromEnd(intMem offset)
+	{
+		if (offset > 0 || (uintMem)-offset > data.Count())
+			return false;
+
+		position = data.Count() + offset;
+		return true;
+	}
+	uintMem PackFileReadStream::GetPosition() const
+	{
+		return position;
+	}
+	uintMem PackFileReadStream::GetSize() const
+	{
+		return data.Count();
+	}
+	uintMem PackFileReadStream::Read(void* ptr, uintMem byteCount)
+	{
+		byteCount = std::min(byteCount, data.Count() - position);
+
+		if (byteCount == 0)
+			return 0;
+
+		memcpy(ptr, data.Ptr() + position, byteCount);
+		position += byteCount;
+
+		return byteCount;
+	}
+	ArrayView<byte> PackFileReadStream::TryGetContiguous(uintMem byteCount)
+	{
+		if (byteCount > data.Count() - position)
+			return ArrayView<byte>();
+
+		return ArrayView<byte>(data.Ptr() + position, byteCount);
+	}
+	bool PackFileReadStream::Consume(uintMem byteCount)
+	{
+		if (byteCount > data.Count() - position)
+			return false;
+
+		position += byteCount;
+		return true;
+	}
+
+	//Checks that [offset, offset + size) lies inside a file of 'fileSize' bytes without overflowing
+	static bool IsPackRangeValid(uint64 offset, uint64 size, uintMem fileSize)
+	{
+		return offset <= fileSize && size <= fileSize - offset;
+	}
+	//Compares a path stored in the pack with a path that isn't normalized
+	static bool IsSamePackPath(StringView packPath, StringView path)
+	{
+		uintMem start = 0;
+		while (start < path.Count() && (path[start] == '/' || path[start] == '\\'))
+			++start;
+
+		if (path.Count() - start != packPath.Count())
+			return false;
+
+		for (uintMem i = 0; i < packPath.Count(); ++i)
+			if (packPath[i] != (path[start + i] == '\\' ? '/' : path[start + i]))
+				return false;
+
+		return true;
+	}
+
+	PackFileSystem::PackFileSystem()
+		: entries(nullptr), entryCount(0)
+	{
+	}
+	PackFileSystem::PackFileSystem(PackFileSystem&& other) noexcept
+		: file(std::move(other.file)), entries(other.entries), entryCount(other.entryCount)
+	{
+		other.entries = nullptr;
+		other.entryCount = 0;
+	}
+	PackFileSystem::PackFileSystem(const Path& path)
+		: entries(nullptr), entryCount(0)
+	{
+		Open(path);
+	}
+	PackFileSystem::~PackFileSystem()
+	{
+	}
+	Result PackFileSystem::Open(const Path& path)
+	{
+		using namespace PackFileFormat;
+
+		CHECK_RESULT(Close());
+		//Lookups touch only a few pages of the table, so don't read the whole pack ahead
+		CHECK_RESULT(file.Open(path, FileUsageHint::RandomAccess));
+
+		const byte* data = (const byte*)file.GetData();
+		uintMem size = file.GetSize();
+
+		if (size < sizeof(Header))
+		{
+			file.Close();
+			return BLAZE_ERROR_RESULT("Blaze Engine", "File \"" + path.ToString() + "\" is not a pack file");
+		}
+
+		Header header;
+		memcpy(&header, data, sizeof(Header));
+
+		if (header.magic != Magic)
+		{
+			file.Close();
+			return BLAZE_ERROR_RESULT("Blaze Engine", "File \"" + path.ToString() + "\" is not a pack file");
+		}
+
+		if (header.version != Version)
+		{
+			file.Close();
+			return BLAZE_ERROR_RESULT("Blaze Engine", "Pack file \"" + path.ToString() + "\" has an unsupported version " + StringParsing::Convert(header.version));
+		}
+
+		if (header.entriesOffset % alignof(Entry) != 0 ||
+			header.entryCount > size / sizeof(Entry) ||
+			!IsPackRangeValid(header.entriesOffset, header.entryCount * sizeof(Entry), size) ||
+			!IsPackRangeValid(header.pathsOffset, header.pathsSize, size))
+		{
+			file.Close();
+			return BLAZE_ERROR_RESULT("Blaze Engine", "Pack file \"" + path.ToString() + "\" has an invalid table of contents");
+		}
+
+		const Entry* tableEntries = (const Entry*)(data + header.entriesOffset);
+
+		if (PackFileFormat::Hash(tableEntries, header.entryCount * sizeof(Entry)) != header.tableHash)
+		{
+			file.Close();
+			return BLAZE_ERROR_RESULT("Blaze Engine", "Pack file \"" + path.ToString() + "\" has a corrupted table of contents");
+		}
+
+		for (uintMem i = 0; i < header.entryCount; ++i)
+		{
+			const Entry& entry = tableEntries[i];
+
+			if (!IsPackRangeValid(entry.pathOffset, entry.pathSize, size) ||
+				!IsPackRangeValid(entry.dataOffset, entry.storedSize, size) ||
+				(entry.compression == Compression::None ? entry.storedSize != entry.size : entry.compression != Compression::BlazeLZ) ||
+				(i != 0 && tableEntries[i - 1].pathHash > entry.pathHash))
+			{
+				file.Close();
+				return BLAZE_ERROR_RESULT("Blaze Engine", "Pack file \"" + path.ToString() + "\" has an invalid entry " + StringParsing::Convert(i));
+			}
+		}
+
+		entries = tableEntries;
+		entryCount = header.entryCount;
+
+		return Result();
+	}
+	Result PackFileSystem::Close()
+	{
+		entries = nullptr;
+		entryCount = 0;
+
+		return file.Close();
+	}
+	bool PackFileSystem::Contains(StringView path) const
+	{
+		return FindEntry(path) != nullptr;
+	}
+	ArrayView<byte> PackFileSystem::GetFileData(StringView path) const
+	{
+		const PackFileFormat::Entry* entry = FindEntry(path);
+
+		if (entry == nullptr)
+			return ArrayView<byte>();
+
+		return GetEntryData(*entry);
+	}
+	Result PackFileSystem::OpenStream(StringView path, PackFileReadStream& stream) const
+	{
+		const PackFileFormat::Entry* entry = FindEntry(path);
+
+		if (entry == nullptr)
+			return BLAZE_ERROR_RESULT("Blaze Engine", "File \"" + path + "\" is not in the pack file");
+
+		if (entry->compression == PackFileFormat::Compression::None)
+		{
+			stream = PackFileReadStream(GetEntryData(*entry));
+			return Result();
+		}
+
+		CHECK_RESULT(DecompressEntry(*entry, stream.buffer));
+		stream.data = stream.buffer;
+		stream.position = 0;
+
+		return Result();
+	}
+	Result PackFileSystem::ReadFile(StringView path, Array<byte>& data) const
+	{
+		const PackFileFormat::Entry* entry = FindEntry(path);
+
+		if (entry == nullptr)
+			return BLAZE_ERROR_RESULT("Blaze Engine", "File \"" + path + "\" is not in the pack file");
+
+		if (entry->compression == PackFileFormat::Compression::None)
+		{
+			data = GetEntryData(*entry);
+			return Result();
+		}
+
+		return DecompressEntry(*entry, data);
+	}
+	bool PackFileSystem::VerifyFile(StringView path) const
+	{
+		const PackFileFormat::Entry* entry = FindEntry(path);
+
+		if (entry == nullptr)
+			return false;
+
+		ArrayView<byte> data = GetStoredEntryData(*entry);
+		return PackFileFormat::Hash(data.Ptr(), data.Count()) == entry->contentHash;
+	}
+	StringView PackFileSystem::GetFilePath(uintMem index) const
+	{
+		if (index >= entryCount)
+			return StringView();
+
+		return GetEntryPath(entries[index]);
+	}
+	ArrayView<byte> PackFileSystem::GetFileData(uintMem index) const
+	{
+		if (index >= entryCount)
+			return ArrayView<byte>();
+
+		return GetEntryData(entries[index]);
+	}
+	PackFileSystem& PackFileSystem::operator=(PackFileSystem&& other) noexcept
+	{
+		file = std::move(other.file);
+		entries = other.entries;
+		entryCount = other.entryCount;
+		other.entries = nullptr;
+		other.entryCount = 0;
+
+		return *this;
+	}
+	const PackFileFormat::Entry* PackFileSystem::FindEntry(StringView path) const
+	{
+		if (entryCount == 0)
+			return nullptr;
+
+		uint64 hash = PackFileFormat::HashPath(path);
+
+		const PackFileFormat::Entry* it = std::lower_bound(entries, entries + entryCount, hash, [](const PackFileFormat::Entry& entry, uint64 hash) { return entry.pathHash < hash; });
+
+		//Different paths can have the same hash, so compare the paths of all entries with the hash
+		for (; it != entries + entryCount && it->pathHash == hash; ++it)
+			if (IsSamePackPath(GetEntryPath(*it), path))
+				return it;
+
+		return nullptr;
+	}
+	ArrayView<byte> PackFileSystem::GetEntryData(const PackFileFormat::Entry& entry) const
+	{
+		if (entry.compression != PackFileFormat::Compression::None)
+			return ArrayView<byte>();
+
+		return GetStoredEntryData(entry);
+	}
+	ArrayView<byte> PackFileSystem::GetStoredEntryData(const PackFileFormat::Entry& entry) const
+	{
+		return ArrayView<byte>((const byte*)file.GetData() + entry.dataOffset, entry.storedSize);
+	}
+	Result PackFileSystem::DecompressEntry(const PackFileFormat::Entry& entry, Array<byte>& data) const
+	{
+		ArrayView<byte> stored = GetStoredEntryData(entry);
+		data.Resize(entry.size);
+
+		if (!BlazeLZ::Decompress(stored.Ptr(), stored.Count(), data.Ptr(), data.Count()))
+		{
+			data.Clear();
+			return BLAZE_ERROR_RESULT("Blaze Engine", "Failed to decompress a file in a pack file, the pack is corrupted");
+		}
+
+		return Result();
+	}
+	StringView PackFileSystem::GetEntryPath(const PackFileFormat::Entry& entry) const
+	{
+		return StringView((const char*)file.GetData() + entry.pathOffset, entry.pathSize);
+	}
+}
@@ -4,16 +4,16 @@
 namespace Blaze
 {
 	Blaze::BufferStreamBase::BufferStreamBase()
-		: buffer(nullptr), size(0), position(0)
+		: buffer(nullptr), size(0), position(0), ownsBuffer(false)
 	{
 	}
 	BufferStreamBase::BufferStreamBase(uintMem size)
-		: size(size), position(0)
+		: size(size), position(0), ownsBuffer(true)
 	{
-		buffer = malloc(size);		
+		buffer = Memory::Allocate(size);
 	}
 	BufferStreamBase::BufferStreamBase(void* buffer, uintMem size)
-		: buffer(buffer), size(size), position(0)
+		: buffer(buffer), size(size), position(0), ownsBuffer(false)
 	{
 	}
 	BufferStreamBase::~BufferStreamBase()
@@ -31,32 +31,45 @@ namespace Blaze
 	}
 	Result BufferStreamBase::Clear()
 	{
-		free(this->buffer);
+		if (ownsBuffer)
+			Memory::Free(this->buffer);
+
+		this->buffer = nullptr;
 		this->size = 0;
 		this->position = 0;
+		this->ownsBuffer = false;
 
 		return Result();
 	}
 	bool BufferStreamBase::MovePosition(intMem offset)
 	{
-		uintMem newPos = position + offset;
-
-		if (std::cmp_greater_equal(offset, size) || newPos >= size)
+		if (offset < 0 && (uintMem)-offset > position)
 			return false;
-		
-		position = newPos;
+		if (offset > 0 && (uintMem)offset > size - position)
+			return false;
+
+		position += offset;
 
 		return true;
 	}
 	bool BufferStreamBase::SetPosition(uintMem offset)
 	{
-		if (offset >= size)
+		if (offset > size)
 			return false;
 
 		position = offset;
 
 		return true;
 	}
+	bool BufferStreamBase::SetPositionFromEnd(intMem offset)
+	{
+		if (offset > 0 || (uintMem)-offset > size)
+			return false;
+
+		position = size + offset;
+
+		return true;
+	}
 	uintMem BufferStreamBase::GetPosition() const
 	{
 		return position;
@@ -68,7 +81,7 @@ namespace Blaze
 	const void* BufferStreamBase::GetBuffer() const
 	{
 		return buffer;
-	}	
+	}
 
 	BufferWriteStream::BufferWriteStream()
 	{
@@ -88,21 +101,23 @@ namespace Blaze
 	}
 	uintMem BufferWriteStream::Write(const void* ptr, uintMem byteCount)
 	{
-		uintMem newSize = size;
-		uintMem leftBytes = newSize - position;
+		if (byteCount == 0)
+			return 0;
 
-		while (leftBytes < byteCount)
+		if (byteCount > size - position)
 		{
-			newSize *= 2;
-			leftBytes = size - position;
-		}
+			uintMem newSize = std::max(size * 2, position + byteCount);
+			void* newBuffer = Memory::Allocate(newSize);
 
-		if (newSize != size)
-		{
-			void* old = buffer;
-			buffer = malloc(newSize);
-			memcpy(buffer, old, size);
+			if (size != 0)
+				memcpy(newBuffer, buffer, size);
+
+			if (ownsBuffer)
+				Memory::Free(buffer);
+
+			buffer = newBuffer;
 			size = newSize;
+			ownsBuffer = true;
 		}
 
 		memcpy((char*)buffer + position, ptr, byteCount);
@@ -120,8 +135,9 @@ namespace Blaze
 	{
 
 	}
-	BufferReadStream::BufferReadStream(void* buffer, uintMem size)
-		: BufferStreamBase(buffer, size)
+	BufferReadStream::BufferReadStream(const void* buffer, uintMem size)
+		//The buffer is never written through a read stream
+		: BufferStreamBase(const_cast<void*>(buffer), size)
 	{
 
 	}
@@ -130,15 +146,32 @@ namespace Blaze
 	}
 	uintMem BufferReadStream::Read(void* ptr, uintMem byteCount)
 	{
-		uintMem position = GetPosition();
-		uintMem leftBytes = GetSize() - position;
+		uintMem leftBytes = size - position;
 
 		if (leftBytes < byteCount)
 			byteCount = leftBytes;
 
-		memcpy(ptr, (char*)GetBuffer() + position, byteCount);
-		MovePosition(byteCount);
+		if (byteCount == 0)
+			return 0;
+
+		memcpy(ptr, (char*)buffer + position, byteCount);
+		position += byteCount;
 
 		return byteCount;
 	}
-}
\ No newline at end of file
+	ArrayView<byte> BufferReadStream::TryGetContiguous(uintMem byteCount)
+	{
+		if (byteCount > size - position)
+			return ArrayView<byte>();
+
+		return ArrayView<byte>((const byte*)buffer + position, byteCount);
+	}
+	bool BufferReadStream::Consume(uintMem byteCount)
+	{
+		if (byteCount > size - position)
+			return false;
+
+		position += byteCount;
+		return true;
+	}
+}
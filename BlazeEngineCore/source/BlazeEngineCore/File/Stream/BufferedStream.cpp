@@ -0,0 +1,210 @@
+#include "pch.h"
+#include "BlazeEngineCore/File/Stream/BufferedStream.h"
+
+namespace Blaze
+{
+	BufferedReadStream::BufferedReadStream(ReadStream& stream, uintMem bufferSize)
+		: stream(&stream), buffer(nullptr), bufferSize(std::max<uintMem>(bufferSize, 1)), bufferPosition(0), bufferEnd(0)
+	{
+		buffer = (byte*)Memory::Allocate(this->bufferSize);
+	}
+	BufferedReadStream::~BufferedReadStream()
+	{
+		Memory::Free(buffer);
+	}
+	bool BufferedReadStream::MovePosition(intMem offset)
+	{
+		if (offset < 0 && (uintMem)-offset > GetPosition())
+			return false;
+
+		return SetPosition(GetPosition() + offset);
+	}
+	bool BufferedReadStream::SetPosition(uintMem offset)
+	{
+		uintMem streamPosition = stream->GetPosition();
+		uintMem bufferStart = streamPosition - bufferEnd;
+
+		//Seeking inside the buffered block doesn't need to touch the wrapped stream
+		if (offset >= bufferStart && offset <= streamPosition)
+		{
+			bufferPosition = offset - bufferStart;
+			return true;
+		}
+
+		DiscardBuffer();
+		return stream->SetPosition(offset);
+	}
+	bool BufferedReadStream::SetPositionFromEnd(intMem offset)
+	{
+		DiscardBuffer();
+		return stream->SetPositionFromEnd(offset);
+	}
+	uintMem BufferedReadStream::GetPosition() const
+	{
+		return stream->GetPosition() - (bufferEnd - bufferPosition);
+	}
+	uintMem BufferedReadStream::GetSize() const
+	{
+		return stream->GetSize();
+	}
+	uintMem BufferedReadStream::Read(void* ptr, uintMem byteCount)
+	{
+		return ReadBytes(ptr, byteCount);
+	}
+	ArrayView<byte> BufferedReadStream::TryGetContiguous(uintMem byteCount)
+	{
+		if (bufferEnd - bufferPosition < byteCount)
+		{
+			if (byteCount > bufferSize)
+				return ArrayView<byte>();
+
+			//Move the unread bytes to the start of the buffer and fill the rest from the wrapped stream
+			uintMem available = bufferEnd - bufferPosition;
+			memmove(buffer, buffer + bufferPosition, available);
+			bufferPosition = 0;
+			bufferEnd = available;
+
+			while (bufferEnd < byteCount)
+			{
+				uintMem count = stream->Read(buffer + bufferEnd, bufferSize - bufferEnd);
+
+				if (count == 0)
+					return ArrayView<byte>();
+
+				bufferEnd += count;
+			}
+		}
+
+		return ArrayView<byte>(buffer + bufferPosition, byteCount);
+	}
+	bool BufferedReadStream::Consume(uintMem byteCount)
+	{
+		if (bufferEnd - bufferPosition >= byteCount)
+		{
+			bufferPosition += byteCount;
+			return true;
+		}
+
+		return MovePosition((intMem)byteCount);
+	}
+	uintMem BufferedReadStream::ReadSlow(void* ptr, uintMem byteCount)
+	{
+		byte* dst = (byte*)ptr;
+		uintMem read = 0;
+
+		while (read != byteCount)
+		{
+			uintMem available = bufferEnd - bufferPosition;
+
+			if (available != 0)
+			{
+				uintMem count = std::min(available, byteCount - read);
+				memcpy(dst + read, buffer + bufferPosition, count);
+				bufferPosition += count;
+				read += count;
+				continue;
+			}
+
+			bufferPosition = 0;
+			bufferEnd = 0;
+
+			//Large reads go directly into the destination, there is no point in copying them through the buffer
+			if (byteCount - read >= bufferSize)
+			{
+				uintMem count = stream->Read(dst + read, byteCount - read);
+				read += count;
+				break;
+			}
+
+			bufferEnd = stream->Read(buffer, bufferSize);
+
+			if (bufferEnd == 0)
+				break;
+		}
+
+		return read;
+	}
+	void BufferedReadStream::DiscardBuffer()
+	{
+		bufferPosition = 0;
+		bufferEnd = 0;
+	}
+
+	BufferedWriteStream::BufferedWriteStream(WriteStream& stream, uintMem bufferSize)
+		: stream(&stream), buffer(nullptr), bufferSize(std::max<uintMem>(bufferSize, 1)), bufferPosition(0)
+	{
+		buffer = (byte*)Memory::Allocate(this->bufferSize);
+	}
+	BufferedWriteStream::~BufferedWriteStream()
+	{
+		if (!Flush())
+			Debug::Logger::LogError("Blaze Engine", "Failed to flush buffered write stream, some data was lost");
+
+		Memory::Free(buffer);
+	}
+	bool BufferedWriteStream::Flush()
+	{
+		if (bufferPosition == 0)
+			return true;
+
+		uintMem written = stream->Write(buffer, bufferPosition);
+
+		if (written != bufferPosition)
+		{
+			//Keep the data that wasn't written so a later flush can retry
+			memmove(buffer, buffer + written, bufferPosition - written);
+			bufferPosition -= written;
+			return false;
+		}
+
+		bufferPosition = 0;
+		return true;
+	}
+	bool BufferedWriteStream::MovePosition(intMem offset)
+	{
+		if (!Flush())
+			return false;
+
+		return stream->MovePosition(offset);
+	}
+	bool BufferedWriteStream::SetPosition(uintMem offset)
+	{
+		if (!Flush())
+			return false;
+
+		return stream->SetPosition(offset);
+	}
+	bool BufferedWriteStream::SetPositionFromEnd(intMem offset)
+	{
+		if (!Flush())
+			return false;
+
+		return stream->SetPositionFromEnd(offset);
+	}
+	uintMem BufferedWriteStream::GetPosition() const
+	{
+		return stream->GetPosition() + bufferPosition;
+	}
+	uintMem BufferedWriteStream::GetSize() const
+	{
+		return std::max(stream->GetSize(), GetPosition());
+	}
+	uintMem BufferedWriteStream::Write(const void* ptr, uintMem byteCount)
+	{
+		return WriteBytes(ptr, byteCount);
+	}
+	uintMem BufferedWriteStream::WriteSlow(const void* ptr, uintMem byteCount)
+	{
+		if (!Flush())
+			return 0;
+
+		//Large writes go directly to the wrapped stream, there is no point in copying them through the buffer
+		if (byteCount >= bufferSize)
+			return stream->Write(ptr, byteCount);
+
+		memcpy(buffer, ptr, byteCount);
+		bufferPosition = byteCount;
+
+		return byteCount;
+	}
+}
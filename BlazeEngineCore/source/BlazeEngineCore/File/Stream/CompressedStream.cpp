@@ -0,0 +1,445 @@
+#include "pch.h"
+#include "BlazeEngineCore/File/Stream/CompressedStream.h"
+#include "BlazeEngineCore/Threading/JobSystem.h"
+#include "BlazeEngineCore/Utilities/StringParsing.h"
+
+namespace Blaze
+{
+	static constexpr uintMem MinCompressedBlockSize = 1024;
+	static constexpr uintMem MaxCompressedBlockSize = 64 * 1024 * 1024;
+	static constexpr uintMem NoBufferedBlock = (uintMem)-1;
+
+	CompressedWriteStream::CompressedWriteStream(WriteStream& stream, CompressionLevel level, uintMem blockSize, JobSystem* jobSystem)
+		: stream(&stream), level(level), blockSize(std::clamp(blockSize, MinCompressedBlockSize, MaxCompressedBlockSize)), jobSystem(jobSystem), batchBlockCount(jobSystem == nullptr ? 1 : jobSystem->GetWorkerCount() + 1),
+		batchBuffer(nullptr), batchSize(0), compressedBuffer(nullptr), compressedBlockCapacity(0), uncompressedSize(0), compressedSize(0), finished(false), failed(false)
+	{
+		compressedBlockCapacity = BlazeLZ::CompressBound(this->blockSize);
+		batchBuffer = (byte*)Memory::Allocate(this->blockSize * batchBlockCount);
+		compressedBuffer = (byte*)Memory::Allocate(compressedBlockCapacity * batchBlockCount);
+
+		CompressedStreamFormat::Header header{ };
+		header.magic = CompressedStreamFormat::Magic;
+		header.version = CompressedStreamFormat::Version;
+		header.codec = CompressionCodec::BlazeLZ;
+		header.blockSize = (uint32)this->blockSize;
+
+		if (Result result = WriteData(&header, sizeof(header)))
+			failed = true;
+	}
+	CompressedWriteStream::~CompressedWriteStream()
+	{
+		Finish();
+
+		Memory::Free(batchBuffer);
+		Memory::Free(compressedBuffer);
+	}
+	Result CompressedWriteStream::Finish()
+	{
+		if (finished)
+			return Result();
+
+		finished = true;
+
+		if (failed)
+			return BLAZE_ERROR_RESULT("Blaze Engine", "Finishing a compressed write stream that failed to write earlier");
+
+		if (batchSize != 0)
+		{
+			if (Result result = CompressBlocks(batchBuffer, batchSize))
+			{
+				failed = true;
+				return result;
+			}
+
+			batchSize = 0;
+		}
+
+		CompressedStreamFormat::Footer footer{ };
+		footer.indexOffset = compressedSize;
+		footer.blockCount = blocks.Count();
+		footer.uncompressedSize = uncompressedSize;
+		footer.magic = CompressedStreamFormat::Magic;
+
+		if (Result result = WriteData(blocks.Ptr(), blocks.Count() * sizeof(CompressedStreamFormat::BlockEntry)))
+		{
+			failed = true;
+			return result;
+		}
+		if (Result result = WriteData(&footer, sizeof(footer)))
+		{
+			failed = true;
+			return result;
+		}
+
+		return Result();
+	}
+	bool CompressedWriteStream::MovePosition(intMem offset)
+	{
+		return offset == 0;
+	}
+	bool CompressedWriteStream::SetPosition(uintMem offset)
+	{
+		return offset == uncompressedSize;
+	}
+	bool CompressedWriteStream::SetPositionFromEnd(intMem offset)
+	{
+		return offset == 0;
+	}
+	uintMem CompressedWriteStream::GetPosition() const
+	{
+		return uncompressedSize;
+	}
+	uintMem CompressedWriteStream::GetSize() const
+	{
+		return uncompressedSize;
+	}
+	uintMem CompressedWriteStream::Write(const void* ptr, uintMem byteCount)
+	{
+		if (finished || failed)
+			return 0;
+
+		const byte* data = (const byte*)ptr;
+		const uintMem batchCapacity = blockSize * batchBlockCount;
+		uintMem left = byteCount;
+
+		while (left != 0)
+		{
+			//Whole batches are compressed straight from the caller's memory
+			if (batchSize == 0 && left >= batchCapacity)
+			{
+				if (Result result = CompressBlocks(data, batchCapacity))
+				{
+					failed = true;
+					break;
+				}
+
+				data += batchCapacity;
+				left -= batchCapacity;
+				continue;
+			}
+
+			uintMem count = std::min(left, batchCapacity - batchSize);
+			memcpy(batchBuffer + batchSize, data, count);
+			batchSize += count;
+			data += count;
+			left -= count;
+
+			if (batchSize == batchCapacity)
+			{
+				if (Result result = CompressBlocks(batchBuffer, batchSize))
+				{
+					failed = true;
+					break;
+				}
+
+				batchSize = 0;
+			}
+		}
+
+		uncompressedSize += byteCount - left;
+
+		return byteCount - left;
+	}
+	Result CompressedWriteStream::CompressBlocks(const byte* data, uintMem size)
+	{
+		uintMem blockCount = (size + blockSize - 1) / blockSize;
+		Array<uintMem> blockCompressedSizes;
+		blockCompressedSizes.Resize(blockCount, 0);
+
+		auto compressBlocks = [&](uintMem begin, uintMem end) {
+			for (uintMem index = begin; index < end; ++index)
+			{
+				uintMem offset = index * blockSize;
+				blockCompressedSizes[index] = BlazeLZ::Compress(data + offset, std::min(blockSize, size - offset), compressedBuffer + index * compressedBlockCapacity, compressedBlockCapacity, level);
+			}
+			};
+
+		//The job system keeps its workers between batches, the writing thread compresses blocks too while it waits
+		if (jobSystem != nullptr && blockCount > 1)
+			jobSystem->ParallelFor(blockCount, 1, compressBlocks);
+		else
+			compressBlocks(0, blockCount);
+
+		for (uintMem i = 0; i < blockCount; ++i)
+		{
+			uintMem offset = i * blockSize;
+			uintMem dataSize = std::min(blockSize, size - offset);
+
+			CompressedStreamFormat::BlockEntry entry{ };
+			entry.offset = compressedSize;
+
+			//The compressed buffers are CompressBound big, so compressing can't run out of space
+			if (blockCompressedSizes[i] == 0)
+				return BLAZE_ERROR_RESULT("Blaze Engine", "Failed to compress a block of a compressed write stream");
+
+			//Blocks that didn't compress are stored as they are, so reading them is a plain copy
+			if (blockCompressedSizes[i] >= dataSize)
+			{
+				entry.storedSize = (uint32)dataSize;
+				entry.flags = CompressedStreamFormat::BlockFlags::Uncompressed;
+				CHECK_RESULT(WriteData(data + offset, dataSize));
+			}
+			else
+			{
+				entry.storedSize = (uint32)blockCompressedSizes[i];
+				entry.flags = CompressedStreamFormat::BlockFlags::None;
+				CHECK_RESULT(WriteData(compressedBuffer + i * compressedBlockCapacity, blockCompressedSizes[i]));
+			}
+
+			blocks.AddBack(entry);
+		}
+
+		return Result();
+	}
+	Result CompressedWriteStream::WriteData(const void* ptr, uintMem byteCount)
+	{
+		if (byteCount == 0)
+			return Result();
+
+		uintMem written = stream->Write(ptr, byteCount);
+		compressedSize += written;
+
+		if (written != byteCount)
+			return BLAZE_ERROR_RESULT("Blaze Engine", "Failed to write to the stream wrapped by a compressed write stream");
+
+		return Result();
+	}
+
+	DecompressingReadStream::DecompressingReadStream()
+		: stream(nullptr), baseOffset(0), blockSize(0), size(0), position(0), blockBuffer(nullptr), compressedBuffer(nullptr), compressedBufferSize(0), bufferedBlockIndex(NoBufferedBlock)
+	{
+	}
+	DecompressingReadStream::DecompressingReadStream(ReadStream& stream)
+		: DecompressingReadStream()
+	{
+		Open(stream);
+	}
+	DecompressingReadStream::~DecompressingReadStream()
+	{
+		Close();
+	}
+	Result DecompressingReadStream::Open(ReadStream& stream)
+	{
+		Close();
+
+		uintMem start = stream.GetPosition();
+		uintMem streamSize = stream.GetSize();
+
+		if (streamSize < start || streamSize - start < sizeof(CompressedStreamFormat::Header) + sizeof(CompressedStreamFormat::Footer))
+			return BLAZE_ERROR_RESULT("Blaze Engine", "Invalid compressed stream, the stream is too small");
+
+		uintMem dataSize = streamSize - start;
+
+		CompressedStreamFormat::Header header;
+		if (stream.Read(&header, sizeof(header)) != sizeof(header))
+			return BLAZE_ERROR_RESULT("Blaze Engine", "Failed to read the compressed stream header");
+
+		if (header.magic != CompressedStreamFormat::Magic)
+			return BLAZE_ERROR_RESULT("Blaze Engine", "Invalid compressed stream, the magic number doesn't match");
+		if (header.version != CompressedStreamFormat::Version)
+			return BLAZE_ERROR_RESULT("Blaze Engine", "Unsupported compressed stream version " + StringParsing::Convert(header.version));
+		if (header.codec != CompressionCodec::BlazeLZ)
+			return BLAZE_ERROR_RESULT("Blaze Engine", "Unsupported compressed stream codec " + StringParsing::Convert((uint32)header.codec));
+		if (header.blockSize < MinCompressedBlockSize || header.blockSize > MaxCompressedBlockSize)
+			return BLAZE_ERROR_RESULT("Blaze Engine", "Invalid compressed stream, the block size is invalid");
+
+		CompressedStreamFormat::Footer footer;
+		if (!stream.SetPosition(streamSize - sizeof(footer)) || stream.Read(&footer, sizeof(footer)) != sizeof(footer))
+			return BLAZE_ERROR_RESULT("Blaze Engine", "Failed to read the compressed stream footer");
+
+		if (footer.magic != CompressedStreamFormat::Magic)
+			return BLAZE_ERROR_RESULT("Blaze Engine", "Invalid compressed stream, the footer magic number doesn't match");
+
+		uintMem indexSize = dataSize - sizeof(footer) - sizeof(header);
+		if (footer.blockCount > indexSize / sizeof(CompressedStreamFormat::BlockEntry) ||
+			footer.indexOffset != dataSize - sizeof(footer) - footer.blockCount * sizeof(CompressedStreamFormat::BlockEntry) ||
+			footer.blockCount != (footer.uncompressedSize + header.blockSize - 1) / header.blockSize)
+			return BLAZE_ERROR_RESULT("Blaze Engine", "Invalid compressed stream, the block index is invalid");
+
+		blockSize = header.blockSize;
+		size = footer.uncompressedSize;
+		blocks.Resize(footer.blockCount);
+
+		uintMem blocksSize = blocks.Count() * sizeof(CompressedStreamFormat::BlockEntry);
+		if (!stream.SetPosition(start + footer.indexOffset) || stream.Read(blocks.Ptr(), blocksSize) != blocksSize)
+		{
+			blocks.Clear();
+			return BLAZE_ERROR_RESULT("Blaze Engine", "Failed to read the compressed stream block index");
+		}
+
+		for (uintMem i = 0; i < blocks.Count(); ++i)
+		{
+			const auto& entry = blocks[i];
+			uintMem blockDataSize = GetBlockDataSize(i);
+
+			bool valid =
+				entry.offset >= sizeof(header) && entry.offset <= footer.indexOffset && entry.storedSize <= footer.indexOffset - entry.offset &&
+				(entry.flags == CompressedStreamFormat::BlockFlags::None ? entry.storedSize <= BlazeLZ::CompressBound(blockDataSize) :
+				entry.flags == CompressedStreamFormat::BlockFlags::Uncompressed && entry.storedSize == blockDataSize);
+
+			if (!valid)
+			{
+				blocks.Clear();
+				return BLAZE_ERROR_RESULT("Blaze Engine", "Invalid compressed stream, block " + StringParsing::Convert((uint64)i) + " is invalid");
+			}
+
+			if (entry.flags == CompressedStreamFormat::BlockFlags::None)
+				compressedBufferSize = std::max<uintMem>(compressedBufferSize, entry.storedSize);
+		}
+
+		blockBuffer = (byte*)Memory::Allocate(blockSize);
+		compressedBuffer = compressedBufferSize != 0 ? (byte*)Memory::Allocate(compressedBufferSize) : nullptr;
+
+		this->stream = &stream;
+		this->baseOffset = start;
+
+		return Result();
+	}
+	void DecompressingReadStream::Close()
+	{
+		Memory::Free(blockBuffer);
+		Memory::Free(compressedBuffer);
+
+		stream = nullptr;
+		baseOffset = 0;
+		blockSize = 0;
+		size = 0;
+		position = 0;
+		blocks.Clear();
+		blockBuffer = nullptr;
+		compressedBuffer = nullptr;
+		compressedBufferSize = 0;
+		bufferedBlockIndex = NoBufferedBlock;
+	}
+	bool DecompressingReadStream::MovePosition(intMem offset)
+	{
+		if (offset < 0 && (uint64)-offset > position)
+			return false;
+
+		return SetPosition(position + offset);
+	}
+	bool DecompressingReadStream::SetPosition(uintMem offset)
+	{
+		if (stream == nullptr || offset > size)
+			return false;
+
+		//Blocks are decompressed lazily when they are read
+		position = offset;
+		return true;
+	}
+	bool DecompressingReadStream::SetPositionFromEnd(intMem offset)
+	{
+		if (offset > 0 || (uint64)-offset > size)
+			return false;
+
+		return SetPosition(size + offset);
+	}
+	uintMem DecompressingReadStream::GetPosition() const
+	{
+		return position;
+	}
+	uintMem DecompressingReadStream::GetSize() const
+	{
+		return size;
+	}
+	uintMem DecompressingReadStream::Read(void* ptr, uintMem byteCount)
+	{
+		if (stream == nullptr)
+			return 0;
+
+		byte* out = (byte*)ptr;
+		uintMem total = 0;
+
+		while (byteCount != 0 && position < size)
+		{
+			uintMem blockIndex = position / blockSize;
+			uintMem blockOffset = position % blockSize;
+			uintMem blockDataSize = GetBlockDataSize(blockIndex);
+			uintMem count = std::min(byteCount, blockDataSize - blockOffset);
+
+			if (count == blockDataSize && blockIndex != bufferedBlockIndex)
+			{
+				//Whole blocks are decompressed straight into the caller's memory
+				if (Result result = DecompressBlock(blockIndex, out))
+					break;
+			}
+			else
+			{
+				if (!LoadBlock(blockIndex))
+					break;
+
+				memcpy(out, blockBuffer + blockOffset, count);
+			}
+
+			out += count;
+			total += count;
+			byteCount -= count;
+			position += count;
+		}
+
+		return total;
+	}
+	ArrayView<byte> DecompressingReadStream::TryGetContiguous(uintMem byteCount)
+	{
+		if (stream == nullptr || position >= size)
+			return ArrayView<byte>();
+
+		uintMem blockIndex = position / blockSize;
+		uintMem blockOffset = position % blockSize;
+
+		if (byteCount > GetBlockDataSize(blockIndex) - blockOffset || !LoadBlock(blockIndex))
+			return ArrayView<byte>();
+
+		return ArrayView<byte>(blockBuffer + blockOffset, byteCount);
+	}
+	bool DecompressingReadStream::Consume(uintMem byteCount)
+	{
+		if (byteCount > size - position)
+			return false;
+
+		position += byteCount;
+		return true;
+	}
+	uintMem DecompressingReadStream::GetBlockDataSize(uintMem index) const
+	{
+		return std::min<uint64>(blockSize, size - (uint64)index * blockSize);
+	}
+	Result DecompressingReadStream::DecompressBlock(uintMem index, byte* dst)
+	{
+		const auto& entry = blocks[index];
+		uintMem blockDataSize = GetBlockDataSize(index);
+
+		if (!stream->SetPosition(baseOffset + entry.offset))
+			return BLAZE_ERROR_RESULT("Blaze Engine", "Failed to seek to block " + StringParsing::Convert((uint64)index) + " of a compressed stream");
+
+		if (entry.flags == CompressedStreamFormat::BlockFlags::Uncompressed)
+		{
+			if (stream->Read(dst, blockDataSize) != blockDataSize)
+				return BLAZE_ERROR_RESULT("Blaze Engine", "Failed to read block " + StringParsing::Convert((uint64)index) + " of a compressed stream");
+
+			return Result();
+		}
+
+		if (stream->Read(compressedBuffer, entry.storedSize) != entry.storedSize)
+			return BLAZE_ERROR_RESULT("Blaze Engine", "Failed to read block " + StringParsing::Convert((uint64)index) + " of a compressed stream");
+
+		if (!BlazeLZ::Decompress(compressedBuffer, entry.storedSize, dst, blockDataSize))
+			return BLAZE_ERROR_RESULT("Blaze Engine", "Block " + StringParsing::Convert((uint64)index) + " of a compressed stream is corrupted");
+
+		return Result();
+	}
+	bool DecompressingReadStream::LoadBlock(uintMem index)
+	{
+		if (bufferedBlockIndex == index)
+			return true;
+
+		if (Result result = DecompressBlock(index, blockBuffer))
+		{
+			bufferedBlockIndex = NoBufferedBlock;
+			return false;
+		}
+
+		bufferedBlockIndex = index;
+		return true;
+	}
+}
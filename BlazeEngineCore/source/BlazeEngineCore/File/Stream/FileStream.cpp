@@ -4,12 +4,18 @@
 
 #ifdef BLAZE_PLATFORM_WINDOWS
 #include "BlazeEngineCore/Internal/Windows/WindowsPlatform.h"
+#elif defined(BLAZE_PLATFORM_LINUX)
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
 #else
-#pragma error
+#error
 #endif
 
 namespace Blaze
 {
+#ifdef BLAZE_PLATFORM_WINDOWS
 	FileStreamBase::FileStreamBase()
 		: file(nullptr)
 	{
@@ -24,10 +30,28 @@ namespace Blaze
 	{
 		Open(file);
 	}
+#elif defined(BLAZE_PLATFORM_LINUX)
+	FileStreamBase::FileStreamBase()
+		: fileDescriptor(-1), position(0)
+	{
+	}
+	FileStreamBase::FileStreamBase(FileStreamBase&& other) noexcept
+		: StreamBase(std::move(other)), fileDescriptor(other.fileDescriptor), position(other.position)
+	{
+		other.fileDescriptor = -1;
+		other.position = 0;
+	}
+	FileStreamBase::FileStreamBase(int fileDescriptor)
+		: fileDescriptor(-1), position(0)
+	{
+		Open(fileDescriptor);
+	}
+#endif
 	FileStreamBase::~FileStreamBase()
 	{
 		Close();
 	}
+#ifdef BLAZE_PLATFORM_WINDOWS
 	Result FileStreamBase::Open(void* file)
 	{
 		Close();
@@ -40,6 +64,21 @@ namespace Blaze
 	{
 		return file != nullptr;
 	}
+#elif defined(BLAZE_PLATFORM_LINUX)
+	Result FileStreamBase::Open(int fileDescriptor)
+	{
+		Close();
+
+		this->fileDescriptor = fileDescriptor;
+		this->position = 0;
+
+		return Result();
+	}
+	bool FileStreamBase::IsOpen() const
+	{
+		return fileDescriptor != -1;
+	}
+#endif
 	Result FileStreamBase::Close()
 	{
 #ifdef BLAZE_PLATFORM_WINDOWS
@@ -53,9 +92,20 @@ namespace Blaze
 
 		file = nullptr;
 
+		return Result();
+#elif defined(BLAZE_PLATFORM_LINUX)
+		if (fileDescriptor == -1)
+			return Result();
+
+		if (close(fileDescriptor) == -1)
+			Debug::Logger::LogError("Blaze Engine", "close failed with error :\"" + String(strerror(errno)) + "\"");
+
+		fileDescriptor = -1;
+		position = 0;
+
 		return Result();
 #else
-#pragma error
+#error
 #endif
 	}
 	Result FileStreamBase::Flush()
@@ -69,9 +119,18 @@ namespace Blaze
 		if (result == 0)
 			Debug::Logger::LogError("Windows API", "FlushFileBuffers failed with error :\"" + Windows::GetErrorString(GetLastError()) + "\"");
 
+		return Result();
+#elif defined(BLAZE_PLATFORM_LINUX)
+		if (fileDescriptor == -1)
+			return BLAZE_ERROR_RESULT("Blaze Engine", "file is not open");
+
+		//Only the file data has to reach the disk, metadata like the modification time can be written later
+		if (fdatasync(fileDescriptor) == -1)
+			Debug::Logger::LogError("Blaze Engine", "fdatasync failed with error :\"" + String(strerror(errno)) + "\"");
+
 		return Result();
 #else
-#pragma error
+#error
 #endif
 	}
 	bool FileStreamBase::MovePosition(intMem offset)
@@ -90,9 +149,19 @@ namespace Blaze
 			return false;
 		}
 
+		return true;
+#elif defined(BLAZE_PLATFORM_LINUX)
+		if (fileDescriptor == -1)
+			return false;
+
+		if (offset < 0 && (uintMem)-offset > position)
+			return false;
+
+		position += offset;
+
 		return true;
 #else
-#pragma error
+#error
 #endif
 	}
 	bool FileStreamBase::SetPosition(uintMem offset)
@@ -111,9 +180,16 @@ namespace Blaze
 			return false;
 		}
 
+		return true;
+#elif defined(BLAZE_PLATFORM_LINUX)
+		if (fileDescriptor == -1)
+			return false;
+
+		position = offset;
+
 		return true;
 #else
-#pragma error
+#error
 #endif
 	}
 	bool FileStreamBase::SetPositionFromEnd(intMem offset)
@@ -132,9 +208,21 @@ namespace Blaze
 			return false;
 		}
 
+		return true;
+#elif defined(BLAZE_PLATFORM_LINUX)
+		if (fileDescriptor == -1)
+			return false;
+
+		uintMem size = GetSize();
+
+		if (offset < 0 && (uintMem)-offset > size)
+			return false;
+
+		position = size + offset;
+
 		return true;
 #else
-#pragma error
+#error
 #endif
 	}
 	uintMem FileStreamBase::GetPosition() const
@@ -152,8 +240,10 @@ namespace Blaze
 			Debug::Logger::LogError("Windows API", "SetFilePointerEx failed with error :\"" + Windows::GetErrorString(GetLastError()) + "\"");
 
 		return (uintMem)position.QuadPart;
+#elif defined(BLAZE_PLATFORM_LINUX)
+		return position;
 #else
-#pragma error
+#error
 #endif
 	}
 	uintMem FileStreamBase::GetSize() const
@@ -173,8 +263,21 @@ namespace Blaze
 		}
 
 		return size.QuadPart;
+#elif defined(BLAZE_PLATFORM_LINUX)
+		if (fileDescriptor == -1)
+			return 0;
+
+		struct stat fileStat;
+		if (fstat(fileDescriptor, &fileStat) == -1)
+		{
+			Debug::Logger::LogError("Blaze Engine", "fstat failed with error :\"" + String(strerror(errno)) + "\"");
+
+			return 0;
+		}
+
+		return (uintMem)fileStat.st_size;
 #else
-#pragma error
+#error
 #endif
 	}
 
@@ -184,8 +287,15 @@ namespace Blaze
 
 		StreamBase::operator=(std::move(other));
 
+#ifdef BLAZE_PLATFORM_WINDOWS
 		file = other.file;
 		other.file = nullptr;
+#elif defined(BLAZE_PLATFORM_LINUX)
+		fileDescriptor = other.fileDescriptor;
+		position = other.position;
+		other.fileDescriptor = -1;
+		other.position = 0;
+#endif
 
 		return *this;
 	}
@@ -199,6 +309,29 @@ namespace Blaze
 		if (result == 0)
 			Debug::Logger::LogError("Windows API", "WriteFile failed with error :\"" + Windows::GetErrorString(GetLastError()) + "\"");
 
+		return bytesWritten;
+#elif defined(BLAZE_PLATFORM_LINUX)
+		const byte* src = (const byte*)ptr;
+		uintMem bytesWritten = 0;
+
+		while (bytesWritten != byteCount)
+		{
+			ssize_t result = pwrite(fileDescriptor, src + bytesWritten, byteCount - bytesWritten, (off_t)(position + bytesWritten));
+
+			if (result == -1)
+			{
+				if (errno == EINTR)
+					continue;
+
+				Debug::Logger::LogError("Blaze Engine", "pwrite failed with error :\"" + String(strerror(errno)) + "\"");
+				break;
+			}
+
+			bytesWritten += (uintMem)result;
+		}
+
+		position += bytesWritten;
+
 		return bytesWritten;
 #else
 #error
@@ -229,6 +362,32 @@ namespace Blaze
 		if (result == 0)
 			Debug::Logger::LogError("Windows API", "ReadFile failed with error :\"" + Windows::GetErrorString(GetLastError()) + "\"");
 
+		return bytesRead;
+#elif defined(BLAZE_PLATFORM_LINUX)
+		byte* dst = (byte*)ptr;
+		uintMem bytesRead = 0;
+
+		while (bytesRead != byteCount)
+		{
+			ssize_t result = pread(fileDescriptor, dst + bytesRead, byteCount - bytesRead, (off_t)(position + bytesRead));
+
+			if (result == -1)
+			{
+				if (errno == EINTR)
+					continue;
+
+				Debug::Logger::LogError("Blaze Engine", "pread failed with error :\"" + String(strerror(errno)) + "\"");
+				break;
+			}
+
+			if (result == 0)
+				break;
+
+			bytesRead += (uintMem)result;
+		}
+
+		position += bytesRead;
+
 		return bytesRead;
 #else
 #error
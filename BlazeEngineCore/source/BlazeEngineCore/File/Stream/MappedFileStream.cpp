@@ -0,0 +1,113 @@
+#include "pch.h"
+#include "BlazeEngineCore/File/Stream/MappedFileStream.h"
+
+namespace Blaze
+{
+	MappedFileReadStream::MappedFileReadStream()
+		: position(0)
+	{
+	}
+	MappedFileReadStream::MappedFileReadStream(MappedFileReadStream&& other) noexcept
+		: ContiguousReadStream(std::move(other)), file(std::move(other.file)), position(other.position)
+	{
+		other.position = 0;
+	}
+	MappedFileReadStream::MappedFileReadStream(const Path& path, FileUsageHint usageHint)
+		: position(0)
+	{
+		Open(path, usageHint);
+	}
+	MappedFileReadStream::MappedFileReadStream(MappedFile&& file)
+		: file(std::move(file)), position(0)
+	{
+	}
+	MappedFileReadStream::~MappedFileReadStream()
+	{
+	}
+	Result MappedFileReadStream::Open(const Path& path, FileUsageHint usageHint)
+	{
+		position = 0;
+		return file.Open(path, usageHint);
+	}
+	Result MappedFileReadStream::Open(MappedFile&& file)
+	{
+		position = 0;
+		this->file = std::move(file);
+		return Result();
+	}
+	Result MappedFileReadStream::Close()
+	{
+		position = 0;
+		return file.Close();
+	}
+	bool MappedFileReadStream::MovePosition(intMem offset)
+	{
+		if (offset < 0 && (uintMem)-offset > position)
+			return false;
+		if (offset > 0 && position + (uintMem)offset > file.GetSize())
+			return false;
+
+		position += offset;
+		return true;
+	}
+	bool MappedFileReadStream::SetPosition(uintMem offset)
+	{
+		if (offset > file.GetSize())
+			return false;
+
+		position = offset;
+		return true;
+	}
+	bool MappedFileReadStream::SetPositionFromEnd(intMem offset)
+	{
+		if (offset > 0 || (uintMem)-offset > file.GetSize())
+			return false;
+
+		position = file.GetSize() + offset;
+		return true;
+	}
+	uintMem MappedFileReadStream::GetPosition() const
+	{
+		return position;
+	}
+	uintMem MappedFileReadStream::GetSize() const
+	{
+		return file.GetSize();
+	}
+	uintMem MappedFileReadStream::Read(void* ptr, uintMem byteCount)
+	{
+		byteCount = std::min(byteCount, file.GetSize() - position);
+
+		if (byteCount == 0)
+			return 0;
+
+		memcpy(ptr, (const byte*)file.GetData() + position, byteCount);
+		position += byteCount;
+
+		return byteCount;
+	}
+	ArrayView<byte> MappedFileReadStream::TryGetContiguous(uintMem byteCount)
+	{
+		if (byteCount > file.GetSize() - position)
+			return ArrayView<byte>();
+
+		return ArrayView<byte>((const byte*)file.GetData() + position, byteCount);
+	}
+	bool MappedFileReadStream::Consume(uintMem byteCount)
+	{
+		if (byteCount > file.GetSize() - position)
+			return false;
+
+		position += byteCount;
+		return true;
+	}
+	MappedFileReadStream& MappedFileReadStream::operator=(MappedFileReadStream&& other) noexcept
+	{
+		ContiguousReadStream::operator=(std::move(other));
+		file = std::move(other.file);
+		position = other.position;
+		other.position = 0;
+
+		return *this;
+	}
+}
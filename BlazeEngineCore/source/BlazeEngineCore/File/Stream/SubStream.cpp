@@ -4,19 +4,32 @@
 namespace Blaze
 {
 	ReadSubStream::ReadSubStream(ReadStream& stream, uintMem offset, uintMem size)
-		: parentStream(&stream), offset(offset), size(size)
+		: parentStream(&stream), contiguousParentStream(dynamic_cast<ContiguousReadStream*>(&stream)), offset(offset), size(size)
 	{
 	}
 	bool ReadSubStream::MovePosition(intMem offset)
 	{
+		uintMem position = GetPosition();
+
+		if (offset < 0 && (uintMem)-offset > position)
+			return false;
+		if (offset > 0 && (uintMem)offset > size - position)
+			return false;
+
 		return parentStream->MovePosition(offset);
 	}
 	bool ReadSubStream::SetPosition(uintMem offset)
 	{
+		if (offset > size)
+			return false;
+
 		return parentStream->SetPosition(offset + this->offset);
 	}
 	bool ReadSubStream::SetPositionFromEnd(intMem offset)
 	{
+		if (offset > 0 || (uintMem)-offset > size)
+			return false;
+
 		return parentStream->SetPosition(this->offset + this->size + offset);
 	}
 	uintMem ReadSubStream::GetPosition() const
@@ -42,4 +55,25 @@ namespace Blaze
 
 		return parentStream->Read(ptr, byteCount);
 	}
-}
\ No newline at end of file
+	ArrayView<byte> ReadSubStream::TryGetContiguous(uintMem byteCount)
+	{
+		uintMem position = parentStream->GetPosition();
+
+		if (contiguousParentStream == nullptr || position > offset + size || position < offset || byteCount > offset + size - position)
+			return ArrayView<byte>();
+
+		return contiguousParentStream->TryGetContiguous(byteCount);
+	}
+	bool ReadSubStream::Consume(uintMem byteCount)
+	{
+		uintMem position = parentStream->GetPosition();
+
+		if (position > offset + size || position < offset || byteCount > offset + size - position)
+			return false;
+
+		if (contiguousParentStream != nullptr)
+			return contiguousParentStream->Consume(byteCount);
+
+		return parentStream->MovePosition(byteCount);
+	}
+}
@@ -0,0 +1,466 @@
+#include "pch.h"
+#include "BlazeEngineCore/Threading/JobSystem.h"
+#include <thread>
+
+namespace Blaze
+{
+	struct Job
+	{
+		std::function<void()> function;
+		std::atomic<uint32> referenceCount;
+		//Unfinished dependencies, plus one while the job is being scheduled
+		std::atomic<uint32> dependencyCount;
+		std::atomic<bool> finished;
+
+		//Jobs waiting for this one. Guarded by the mutex so that a dependency can't finish while it's being added
+		AdaptiveMutex dependentsMutex;
+		Array<Job*> dependents;
+	};
+
+	static void AddJobReference(Job* job)
+	{
+		job->referenceCount.fetch_add(1, std::memory_order_relaxed);
+	}
+	static void ReleaseJobReference(Job* job)
+	{
+		if (job->referenceCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			delete job;
+	}
+
+	/*
+		Chase-Lev work stealing deque with a fixed capacity. The owning worker pushes and pops at the bottom, other
+		threads steal from the top
+	*/
+	class JobWorkQueue
+	{
+	public:
+		static constexpr int64 Capacity = 4096;
+
+		JobWorkQueue()
+			: top(0), bottom(0)
+		{
+			for (auto& job : jobs)
+				job.store(nullptr, std::memory_order_relaxed);
+		}
+
+		/*
+			Only called by the owning worker. Returns false if the queue is full
+		*/
+		bool Push(Job* job)
+		{
+			int64 b = bottom.load(std::memory_order_relaxed);
+			int64 t = top.load(std::memory_order_acquire);
+
+			if (b - t >= Capacity)
+				return false;
+
+			jobs[b & (Capacity - 1)].store(job, std::memory_order_relaxed);
+			//Publishes the job to thieves that read the new bottom
+			bottom.store(b + 1, std::memory_order_release);
+
+			return true;
+		}
+		/*
+			Only called by the owning worker
+		*/
+		Job* Pop()
+		{
+			int64 b = bottom.load(std::memory_order_relaxed) - 1;
+			bottom.store(b, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64 t = top.load(std::memory_order_relaxed);
+
+			if (t > b)
+			{
+				bottom.store(b + 1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			Job* job = jobs[b & (Capacity - 1)].load(std::memory_order_relaxed);
+
+			//The last job can be stolen at the same time, whoever moves the top first gets it
+			if (t == b)
+			{
+				if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+					job = nullptr;
+
+				bottom.store(b + 1, std::memory_order_relaxed);
+			}
+
+			return job;
+		}
+		/*
+			Called by any thread. Returns nullptr if the queue is empty or another thread stole the job first
+		*/
+		Job* Steal()
+		{
+			int64 t = top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64 b = bottom.load(std::memory_order_acquire);
+
+			if (t >= b)
+				return nullptr;
+
+			Job* job = jobs[t & (Capacity - 1)].load(std::memory_order_relaxed);
+
+			if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				return nullptr;
+
+			return job;
+		}
+	private:
+		//On separate cache lines, the top is written by thieves and the bottom by the owner
+		alignas(64) std::atomic<int64> top;
+		alignas(64) std::atomic<int64> bottom;
+		alignas(64) std::atomic<Job*> jobs[Capacity];
+	};
+
+	static thread_local JobSystem* currentJobSystem = nullptr;
+	static thread_local int currentWorkerIndex = -1;
+	//Where threads that aren't workers start stealing, spreads them over the workers
+	static thread_local uint stealStartIndex = 0;
+
+	JobHandle::JobHandle()
+		: job(nullptr)
+	{
+	}
+	JobHandle::JobHandle(const JobHandle& other)
+		: job(other.job)
+	{
+		if (job != nullptr)
+			AddJobReference(job);
+	}
+	JobHandle::JobHandle(JobHandle&& other) noexcept
+		: job(other.job)
+	{
+		other.job = nullptr;
+	}
+	JobHandle::JobHandle(Job* job)
+		: job(job)
+	{
+	}
+	JobHandle::~JobHandle()
+	{
+		if (job != nullptr)
+			ReleaseJobReference(job);
+	}
+	bool JobHandle::IsFinished() const
+	{
+		return job == nullptr || job->finished.load(std::memory_order_acquire);
+	}
+	JobHandle& JobHandle::operator=(const JobHandle& other)
+	{
+		if (other.job != nullptr)
+			AddJobReference(other.job);
+		if (job != nullptr)
+			ReleaseJobReference(job);
+
+		job = other.job;
+
+		return *this;
+	}
+	JobHandle& JobHandle::operator=(JobHandle&& other) noexcept
+	{
+		if (this == &other)
+			return *this;
+
+		if (job != nullptr)
+			ReleaseJobReference(job);
+
+		job = other.job;
+		other.job = nullptr;
+
+		return *this;
+	}
+
+	JobSystem::JobSystem(uint workerCount)
+		: workerCount(workerCount), workQueues(nullptr), sharedQueueHead(0), sharedQueueSize(0), workVersion(0), sleepingWorkerCount(0), stopping(false)
+	{
+		if (this->workerCount == 0)
+			this->workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+		workQueues = new JobWorkQueue[this->workerCount];
+		threads.Resize(this->workerCount);
+
+		for (uint i = 0; i < this->workerCount; ++i)
+			threads[i].Run([this, i]() { return WorkerProc(i); });
+	}
+	JobSystem::~JobSystem()
+	{
+		stopping.store(true, std::memory_order_seq_cst);
+
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex);
+			sleepCondition.notify_all();
+		}
+
+		for (auto& thread : threads)
+			thread.WaitToFinish();
+
+		delete[] workQueues;
+	}
+	JobHandle JobSystem::Schedule(std::function<void()> function)
+	{
+		return Schedule(std::move(function), ArrayView<JobHandle>());
+	}
+	JobHandle JobSystem::Schedule(std::function<void()> function, ArrayView<JobHandle> dependencies)
+	{
+		Job* job = new Job();
+		job->function = std::move(function);
+		//One reference for the returned handle and one for whoever enqueues the job
+		job->referenceCount.store(2, std::memory_order_relaxed);
+		job->dependencyCount.store(1, std::memory_order_relaxed);
+		job->finished.store(false, std::memory_order_relaxed);
+
+		for (const auto& dependency : dependencies)
+		{
+			if (dependency.job == nullptr)
+				continue;
+
+			std::lock_guard<AdaptiveMutex> lock(dependency.job->dependentsMutex);
+
+			if (dependency.job->finished.load(std::memory_order_relaxed))
+				continue;
+
+			//The dependency holds a reference until it has decremented the dependency count
+			job->dependencyCount.fetch_add(1, std::memory_order_relaxed);
+			AddJobReference(job);
+			dependency.job->dependents.AddBack(job);
+		}
+
+		if (job->dependencyCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			Enqueue(job);
+		else
+			ReleaseJobReference(job);
+
+		return JobHandle(job);
+	}
+	void JobSystem::Wait(const JobHandle& handle)
+	{
+		Job* job = handle.job;
+
+		if (job == nullptr)
+			return;
+
+		uint idleCount = 0;
+
+		while (!job->finished.load(std::memory_order_acquire))
+		{
+			if (Job* other = FindJob())
+			{
+				Execute(other);
+				idleCount = 0;
+				continue;
+			}
+
+			//Nothing to help with, the job is running on another thread or waits for jobs that are
+			if (++idleCount < 64)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			job->finished.wait(false, std::memory_order_acquire);
+		}
+	}
+	void JobSystem::Wait(ArrayView<JobHandle> jobs)
+	{
+		for (const auto& job : jobs)
+			Wait(job);
+	}
+	void JobSystem::Wait(const std::atomic<uint32>& counter)
+	{
+		uint idleCount = 0;
+
+		while (true)
+		{
+			uint32 value = counter.load(std::memory_order_acquire);
+
+			if (value == 0)
+				break;
+
+			if (Job* other = FindJob())
+			{
+				Execute(other);
+				idleCount = 0;
+				continue;
+			}
+
+			if (++idleCount < 64)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+
+			//Returns right away if the counter changed since it was read
+			counter.wait(value, std::memory_order_acquire);
+		}
+	}
+	void JobSystem::ParallelFor(uintMem count, uintMem grainSize, const std::function<void(uintMem begin, uintMem end)>& function)
+	{
+		if (count == 0)
+			return;
+
+		if (grainSize == 0)
+			grainSize = std::max<uintMem>(count / ((workerCount + 1) * 4), 1);
+
+		uintMem rangeCount = (count + grainSize - 1) / grainSize;
+
+		if (rangeCount == 1)
+		{
+			function(0, count);
+			return;
+		}
+
+		//Ranges are handed out from a shared counter, threads that get to the work sooner take more of it
+		std::atomic<uintMem> next = 0;
+
+		auto body = [&]() {
+			while (true)
+			{
+				uintMem begin = next.fetch_add(grainSize, std::memory_order_relaxed);
+
+				if (begin >= count)
+					break;
+
+				function(begin, std::min(begin + grainSize, count));
+			}
+			};
+
+		uintMem helperCount = std::min<uintMem>(rangeCount - 1, workerCount);
+		Array<JobHandle> helpers;
+		helpers.ReserveExactly(helperCount);
+
+		for (uintMem i = 0; i < helperCount; ++i)
+			helpers.AddBack(Schedule(body));
+
+		body();
+
+		Wait(helpers);
+	}
+	int JobSystem::GetCurrentWorkerIndex() const
+	{
+		return currentJobSystem == this ? currentWorkerIndex : -1;
+	}
+	int JobSystem::WorkerProc(uint workerIndex)
+	{
+		currentJobSystem = this;
+		currentWorkerIndex = (int)workerIndex;
+
+		while (true)
+		{
+			uint64 version = workVersion.load(std::memory_order_seq_cst);
+
+			if (Job* job = FindJob())
+			{
+				Execute(job);
+				continue;
+			}
+
+			if (stopping.load(std::memory_order_seq_cst))
+				break;
+
+			std::unique_lock<std::mutex> lock(sleepMutex);
+			sleepingWorkerCount.fetch_add(1, std::memory_order_seq_cst);
+			//Work enqueued after the version was read changes it, so the worker can't miss it
+			sleepCondition.wait(lock, [&]() { return workVersion.load(std::memory_order_seq_cst) != version || stopping.load(std::memory_order_seq_cst); });
+			sleepingWorkerCount.fetch_sub(1, std::memory_order_seq_cst);
+		}
+
+		currentJobSystem = nullptr;
+		currentWorkerIndex = -1;
+
+		return 0;
+	}
+	void JobSystem::Enqueue(Job* job)
+	{
+		int workerIndex = GetCurrentWorkerIndex();
+
+		if (workerIndex == -1 || !workQueues[workerIndex].Push(job))
+		{
+			std::lock_guard<AdaptiveMutex> lock(sharedQueueMutex);
+			sharedQueue.AddBack(job);
+			sharedQueueSize.fetch_add(1, std::memory_order_release);
+		}
+
+		WakeWorker();
+	}
+	Job* JobSystem::FindJob()
+	{
+		int workerIndex = GetCurrentWorkerIndex();
+
+		if (workerIndex != -1)
+			if (Job* job = workQueues[workerIndex].Pop())
+				return job;
+
+		if (sharedQueueSize.load(std::memory_order_acquire) != 0)
+		{
+			std::lock_guard<AdaptiveMutex> lock(sharedQueueMutex);
+
+			if (sharedQueueHead != sharedQueue.Count())
+			{
+				Job* job = sharedQueue[sharedQueueHead++];
+				sharedQueueSize.fetch_sub(1, std::memory_order_relaxed);
+
+				if (sharedQueueHead == sharedQueue.Count())
+				{
+					sharedQueue.Clear();
+					sharedQueueHead = 0;
+				}
+
+				return job;
+			}
+		}
+
+		uint start = workerIndex != -1 ? (uint)workerIndex : stealStartIndex++;
+
+		for (uint i = 1; i <= workerCount; ++i)
+		{
+			uint victim = (start + i) % workerCount;
+
+			if ((int)victim == workerIndex)
+				continue;
+
+			if (Job* job = workQueues[victim].Steal())
+				return job;
+		}
+
+		return nullptr;
+	}
+	void JobSystem::Execute(Job* job)
+	{
+		job->function();
+		//Releases whatever the function captured without waiting for the last handle
+		job->function = nullptr;
+
+		Array<Job*> dependents;
+
+		{
+			std::lock_guard<AdaptiveMutex> lock(job->dependentsMutex);
+			job->finished.store(true, std::memory_order_release);
+			dependents = std::move(job->dependents);
+		}
+
+		job->finished.notify_all();
+
+		for (Job* dependent : dependents)
+		{
+			if (dependent->dependencyCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+				Enqueue(dependent);
+			else
+				ReleaseJobReference(dependent);
+		}
+
+		ReleaseJobReference(job);
+	}
+	void JobSystem::WakeWorker()
+	{
+		workVersion.fetch_add(1, std::memory_order_seq_cst);
+
+		if (sleepingWorkerCount.load(std::memory_order_seq_cst) != 0)
+		{
+			std::lock_guard<std::mutex> lock(sleepMutex);
+			sleepCondition.notify_one();
+		}
+	}
+}
@@ -0,0 +1,308 @@
+#include "pch.h"
+#include "BlazeEngineCore/Threading/SyncPrimitives.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#elif defined(_M_ARM64)
+#include <intrin.h>
+#endif
+
+namespace Blaze
+{
+	//How many times waiting operations spin before parking the thread
+	static constexpr uint32 DefaultSpinCount = 128;
+	//The adaptive mutex spins between these counts
+	static constexpr uint32 MinMutexSpinCount = 16;
+	static constexpr uint32 MaxMutexSpinCount = 2048;
+
+	void Internal::CpuRelax()
+	{
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+		_mm_pause();
+#elif defined(_M_ARM64)
+		__yield();
+#elif defined(__aarch64__) || defined(__arm__)
+		asm volatile("yield");
+#endif
+	}
+
+	template<typename F>
+	static bool SpinUntil(F&& condition, uint32 spinCount)
+	{
+		for (uint32 i = 0; i < spinCount; ++i)
+		{
+			if (condition())
+				return true;
+
+			Internal::CpuRelax();
+		}
+
+		return false;
+	}
+
+	AdaptiveMutex::AdaptiveMutex()
+		: state(Unlocked), spinEstimate(0)
+	{
+	}
+	void AdaptiveMutex::LockSlow()
+	{
+		counters.AddContended();
+
+		uint32 estimate = spinEstimate.load(std::memory_order_relaxed);
+		uint32 spinLimit = std::min(estimate * 2 + MinMutexSpinCount, MaxMutexSpinCount);
+
+		for (uint32 spins = 0; spins < spinLimit; ++spins)
+		{
+			uint32 expected = Unlocked;
+			if (state.load(std::memory_order_relaxed) == Unlocked && state.compare_exchange_weak(expected, Locked, std::memory_order_acquire, std::memory_order_relaxed))
+			{
+				//Moves the estimate towards the spins it took this time
+				spinEstimate.store(estimate + ((int32)spins - (int32)estimate) / 8, std::memory_order_relaxed);
+				return;
+			}
+
+			Internal::CpuRelax();
+		}
+
+		//The lock is held for long, spinning is wasted time so the next contended locks spin less
+		spinEstimate.store(estimate - (estimate + 7) / 8, std::memory_order_relaxed);
+
+		//Whoever gets the lock this way keeps the waiters state, so the unlock wakes the next parked thread
+		while (state.exchange(LockedWithWaiters, std::memory_order_acquire) != Unlocked)
+		{
+			counters.AddPark();
+			state.wait(LockedWithWaiters, std::memory_order_relaxed);
+		}
+	}
+
+	Event::Event(bool set)
+		: state(set ? 1 : 0), waiterCount(0)
+	{
+	}
+	void Event::Set()
+	{
+		state.store(1, std::memory_order_seq_cst);
+
+		//Pairs with the waiter count increment in Wait, either the waiter sees the state or this sees the waiter
+		if (waiterCount.load(std::memory_order_seq_cst) != 0)
+			state.notify_all();
+	}
+	void Event::Wait()
+	{
+		if (state.load(std::memory_order_acquire) != 0)
+			return;
+
+		counters.AddContended();
+
+		if (SpinUntil([&]() { return state.load(std::memory_order_acquire) != 0; }, DefaultSpinCount))
+			return;
+
+		waiterCount.fetch_add(1, std::memory_order_seq_cst);
+
+		while (state.load(std::memory_order_seq_cst) == 0)
+		{
+			counters.AddPark();
+			state.wait(0, std::memory_order_seq_cst);
+		}
+
+		waiterCount.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	Semaphore::Semaphore(uint32 initialCount)
+		: count(initialCount), waiterCount(0)
+	{
+	}
+	void Semaphore::Acquire()
+	{
+		if (TryAcquire())
+			return;
+
+		counters.AddContended();
+
+		if (SpinUntil([&]() { return TryAcquire(); }, DefaultSpinCount))
+			return;
+
+		waiterCount.fetch_add(1, std::memory_order_seq_cst);
+
+		while (true)
+		{
+			uint32 value = count.load(std::memory_order_seq_cst);
+
+			if (value != 0)
+			{
+				if (count.compare_exchange_weak(value, value - 1, std::memory_order_acquire, std::memory_order_relaxed))
+					break;
+
+				continue;
+			}
+
+			counters.AddPark();
+			count.wait(0, std::memory_order_seq_cst);
+		}
+
+		waiterCount.fetch_sub(1, std::memory_order_relaxed);
+	}
+	bool Semaphore::TryAcquire()
+	{
+		uint32 value = count.load(std::memory_order_relaxed);
+
+		while (value != 0)
+			if (count.compare_exchange_weak(value, value - 1, std::memory_order_acquire, std::memory_order_relaxed))
+				return true;
+
+		return false;
+	}
+	void Semaphore::Release(uint32 releaseCount)
+	{
+		count.fetch_add(releaseCount, std::memory_order_seq_cst);
+
+		if (waiterCount.load(std::memory_order_seq_cst) != 0)
+		{
+			if (releaseCount == 1)
+				count.notify_one();
+			else
+				count.notify_all();
+		}
+	}
+
+	FrameBarrier::FrameBarrier(uint32 threadCount)
+		: threadCount(threadCount), arrivedCount(0), phase(0)
+	{
+	}
+	bool FrameBarrier::ArriveAndWait()
+	{
+		//Can't change before this thread arrives, so this is the phase it is arriving in
+		uint32 currentPhase = phase.load(std::memory_order_relaxed);
+
+		if (arrivedCount.fetch_add(1, std::memory_order_acq_rel) + 1 == threadCount)
+		{
+			//Reset before the phase changes, threads only arrive again after seeing the new phase
+			arrivedCount.store(0, std::memory_order_relaxed);
+			phase.fetch_add(1, std::memory_order_release);
+			phase.notify_all();
+			return true;
+		}
+
+		counters.AddContended();
+
+		if (SpinUntil([&]() { return phase.load(std::memory_order_acquire) != currentPhase; }, DefaultSpinCount))
+			return false;
+
+		while (phase.load(std::memory_order_acquire) == currentPhase)
+		{
+			counters.AddPark();
+			phase.wait(currentPhase, std::memory_order_acquire);
+		}
+
+		return false;
+	}
+
+	ReadWriteLock::ReadWriteLock()
+		: state(0), waiterCount(0)
+	{
+	}
+	bool ReadWriteLock::try_lock_shared()
+	{
+		uint32 value = state.load(std::memory_order_relaxed);
+
+		while ((value & (WriterBit | WriterWaitingBit)) == 0)
+			if (state.compare_exchange_weak(value, value + 1, std::memory_order_acquire, std::memory_order_relaxed))
+				return true;
+
+		return false;
+	}
+	void ReadWriteLock::unlock_shared()
+	{
+		uint32 value = state.fetch_sub(1, std::memory_order_seq_cst) - 1;
+
+		//The last reader lets a waiting writer in
+		if ((value & ReaderCountMask) == 0 && (value & WriterWaitingBit) != 0)
+			WakeWaiters();
+	}
+	bool ReadWriteLock::try_lock()
+	{
+		uint32 value = state.load(std::memory_order_relaxed);
+
+		//A writer can enter when another writer is only waiting
+		while ((value & (WriterBit | ReaderCountMask)) == 0)
+			if (state.compare_exchange_weak(value, WriterBit, std::memory_order_acquire, std::memory_order_relaxed))
+				return true;
+
+		return false;
+	}
+	void ReadWriteLock::unlock()
+	{
+		//Clears the waiting flag too, woken writers set it again if they don't get the lock
+		state.store(0, std::memory_order_seq_cst);
+		WakeWaiters();
+	}
+	void ReadWriteLock::LockSharedSlow()
+	{
+		counters.AddContended();
+
+		if (SpinUntil([&]() { return try_lock_shared(); }, DefaultSpinCount))
+			return;
+
+		waiterCount.fetch_add(1, std::memory_order_seq_cst);
+
+		while (true)
+		{
+			uint32 value = state.load(std::memory_order_seq_cst);
+
+			if ((value & (WriterBit | WriterWaitingBit)) == 0)
+			{
+				if (state.compare_exchange_weak(value, value + 1, std::memory_order_acquire, std::memory_order_relaxed))
+					break;
+
+				continue;
+			}
+
+			counters.AddPark();
+			state.wait(value, std::memory_order_seq_cst);
+		}
+
+		waiterCount.fetch_sub(1, std::memory_order_relaxed);
+	}
+	void ReadWriteLock::LockSlow()
+	{
+		counters.AddContended();
+
+		if (SpinUntil([&]() { return try_lock(); }, DefaultSpinCount))
+			return;
+
+		waiterCount.fetch_add(1, std::memory_order_seq_cst);
+
+		while (true)
+		{
+			uint32 value = state.load(std::memory_order_seq_cst);
+
+			if ((value & (WriterBit | ReaderCountMask)) == 0)
+			{
+				if (state.compare_exchange_weak(value, WriterBit, std::memory_order_acquire, std::memory_order_relaxed))
+					break;
+
+				continue;
+			}
+
+			//Keeps new readers out until this writer got its turn
+			if ((value & WriterWaitingBit) == 0)
+			{
+				if (!state.compare_exchange_weak(value, value | WriterWaitingBit, std::memory_order_seq_cst, std::memory_order_relaxed))
+					continue;
+
+				value |= WriterWaitingBit;
+			}
+
+			counters.AddPark();
+			state.wait(value, std::memory_order_seq_cst);
+		}
+
+		waiterCount.fetch_sub(1, std::memory_order_relaxed);
+	}
+	void ReadWriteLock::WakeWaiters()
+	{
+		//Readers and writers wait on the same word, all of them are woken and the ones that can't enter park again
+		if (waiterCount.load(std::memory_order_seq_cst) != 0)
+			state.notify_all();
+	}
+}
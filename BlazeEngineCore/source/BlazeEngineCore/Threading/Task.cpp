@@ -0,0 +1,115 @@
+#include "pch.h"
+#include "BlazeEngineCore/Threading/Task.h"
+
+namespace Blaze
+{
+	static constexpr uintMem FrameSizeGranularity = 64;
+	static constexpr uintMem FrameSizeClassCount = 16;
+	//Frames of each size class kept per thread, the rest go back to the general allocator
+	static constexpr uintMem MaxCachedFrameCount = 64;
+
+	struct CachedFrame
+	{
+		CachedFrame* next;
+	};
+
+	struct CoroutineFrameCache
+	{
+		CachedFrame* freeLists[FrameSizeClassCount] = { };
+		uintMem freeCounts[FrameSizeClassCount] = { };
+
+		~CoroutineFrameCache()
+		{
+			for (auto frame : freeLists)
+				while (frame != nullptr)
+					Memory::Free(std::exchange(frame, frame->next));
+		}
+	};
+
+	static thread_local CoroutineFrameCache frameCache;
+
+	static uintMem GetFrameSizeClass(uintMem size)
+	{
+		return (size + FrameSizeGranularity - 1) / FrameSizeGranularity - 1;
+	}
+
+	void* CoroutineFrameAllocator::Allocate(uintMem size)
+	{
+		uintMem sizeClass = GetFrameSizeClass(size);
+
+		if (sizeClass >= FrameSizeClassCount)
+			return Memory::Allocate(size);
+
+		if (CachedFrame* frame = frameCache.freeLists[sizeClass])
+		{
+			frameCache.freeLists[sizeClass] = frame->next;
+			--frameCache.freeCounts[sizeClass];
+			return frame;
+		}
+
+		//Every frame of a size class gets the full class size, so it can be reused by any frame of that class
+		return Memory::Allocate((sizeClass + 1) * FrameSizeGranularity);
+	}
+	void CoroutineFrameAllocator::Free(void* ptr, uintMem size)
+	{
+		uintMem sizeClass = GetFrameSizeClass(size);
+
+		if (sizeClass >= FrameSizeClassCount || frameCache.freeCounts[sizeClass] == MaxCachedFrameCount)
+		{
+			Memory::Free(ptr);
+			return;
+		}
+
+		CachedFrame* frame = (CachedFrame*)ptr;
+		frame->next = frameCache.freeLists[sizeClass];
+		frameCache.freeLists[sizeClass] = frame;
+		++frameCache.freeCounts[sizeClass];
+	}
+
+	FrameScheduler::FrameScheduler()
+	{
+	}
+	FrameScheduler::~FrameScheduler()
+	{
+		//The frames belong to whoever started the coroutines, they are continued so they can finish. Coroutines
+		//that wait again while being cancelled are cancelled right away too
+		while (true)
+		{
+			Array<FrameAwaiter*> cancelling;
+
+			{
+				std::lock_guard<std::mutex> lk{ mutex };
+				cancelling = std::move(waiting);
+			}
+
+			if (cancelling.Empty())
+				break;
+
+			for (auto awaiter : cancelling)
+			{
+				awaiter->cancelled = true;
+				awaiter->handle.resume();
+			}
+		}
+	}
+	uintMem FrameScheduler::ResumeWaiting()
+	{
+		Array<FrameAwaiter*> resuming;
+
+		{
+			std::lock_guard<std::mutex> lk{ mutex };
+			resuming = std::move(waiting);
+		}
+
+		//The awaiter is gone once its coroutine continues
+		for (auto awaiter : resuming)
+			awaiter->handle.resume();
+
+		return resuming.Count();
+	}
+	void FrameScheduler::AddWaiting(FrameAwaiter* awaiter)
+	{
+		std::lock_guard<std::mutex> lk{ mutex };
+		waiting.AddBack(awaiter);
+	}
+}
@@ -1,38 +1,203 @@
 #include "pch.h"
 #include "BlazeEngineCore/Threading/Thread.h"
+#include <atomic>
 
 #ifdef BLAZE_PLATFORM_WINDOWS
 #include <Windows.h>
 #include "BlazeEngineCore/Internal/Windows/WindowsPlatform.h"
+#elif defined(BLAZE_PLATFORM_LINUX)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <climits>
+#include <cstring>
 #else
 #error Not supported
 #endif
 
-static DWORD WINAPI std_ThreadProc(
-	_In_ LPVOID lpParameter
-)
-{
-	std::function<int()>* func = (std::function<int()>*)lpParameter;
-	int ret = func->operator()();
-	delete func;
-	return ret;
-}
-static DWORD WINAPI static_ThreadProc(
-	_In_ LPVOID lpParameter
-)
-{
-	int(*func)() = (int(*)())lpParameter;
-	return func();
-}
-
 namespace Blaze
 {
+#ifdef BLAZE_PLATFORM_WINDOWS
+	static DWORD WINAPI ThreadProc(_In_ LPVOID lpParameter)
+	{
+		std::function<int()>* func = (std::function<int()>*)lpParameter;
+		int ret = func->operator()();
+		delete func;
+		return ret;
+	}
+
+	static int GetNativePriority(ThreadPriority priority)
+	{
+		switch (priority)
+		{
+		case ThreadPriority::Lowest: return THREAD_PRIORITY_LOWEST;
+		case ThreadPriority::Low: return THREAD_PRIORITY_BELOW_NORMAL;
+		case ThreadPriority::High: return THREAD_PRIORITY_ABOVE_NORMAL;
+		case ThreadPriority::Highest: return THREAD_PRIORITY_HIGHEST;
+		case ThreadPriority::TimeCritical: return THREAD_PRIORITY_TIME_CRITICAL;
+		default: return THREAD_PRIORITY_NORMAL;
+		}
+	}
+	static Result SetThreadAffinity(HANDLE handle, uint64 affinityMask)
+	{
+		if (SetThreadAffinityMask(handle, (DWORD_PTR)affinityMask) == 0)
+			return BLAZE_ERROR_RESULT("Windows API", "SetThreadAffinityMask failed with error \"" + Windows::GetErrorString(GetLastError()) + "\"");
+
+		return Result();
+	}
+	static Result SetThreadPriority(HANDLE handle, ThreadPriority priority)
+	{
+		if (::SetThreadPriority(handle, GetNativePriority(priority)) == 0)
+			return BLAZE_ERROR_RESULT("Windows API", "SetThreadPriority failed with error \"" + Windows::GetErrorString(GetLastError()) + "\"");
+
+		return Result();
+	}
+	static Result SetThreadName(HANDLE handle, StringView name)
+	{
+		int wideCount = MultiByteToWideChar(CP_UTF8, 0, name.Ptr(), (int)name.Count(), NULL, 0);
+		std::wstring wideName(wideCount, L'\0');
+		MultiByteToWideChar(CP_UTF8, 0, name.Ptr(), (int)name.Count(), wideName.data(), wideCount);
+
+		HRESULT result = SetThreadDescription(handle, wideName.c_str());
+
+		if (FAILED(result))
+			return BLAZE_ERROR_RESULT("Windows API", "SetThreadDescription failed with error \"" + Windows::GetErrorString((DWORD)result) + "\"");
+
+		return Result();
+	}
+#elif defined(BLAZE_PLATFORM_LINUX)
+	/*
+		Shared by the Thread object and the running thread, whichever finishes last frees it
+	*/
+	struct ThreadData
+	{
+		pthread_t thread;
+		std::function<int()> function;
+		ThreadCreateOptions options;
+		//Kept because the options only hold a view
+		String name;
+
+		//Set by the thread before it runs the function, needed to change the priority from other threads
+		std::atomic<pid_t> threadID;
+		std::atomic<bool> running;
+		std::atomic<uint> referenceCount;
+
+		std::mutex joinMutex;
+		bool joined;
+	};
+
+	static void ReleaseThreadData(ThreadData* data)
+	{
+		if (data->referenceCount.fetch_sub(1, std::memory_order_acq_rel) != 1)
+			return;
+
+		//The thread object was destroyed without waiting, so nobody joins the thread
+		if (!data->joined)
+			pthread_detach(data->thread);
+
+		delete data;
+	}
+
+	static Result SetThreadAffinity(pthread_t thread, uint64 affinityMask)
+	{
+		cpu_set_t set;
+		CPU_ZERO(&set);
+
+		for (uint i = 0; i < 64; ++i)
+			if (affinityMask & ((uint64)1 << i))
+				CPU_SET(i, &set);
+
+		int error = pthread_setaffinity_np(thread, sizeof(set), &set);
+
+		if (error != 0)
+			return BLAZE_ERROR_RESULT("Blaze Engine", "pthread_setaffinity_np failed with error \"" + String(strerror(error)) + "\"");
+
+		return Result();
+	}
+	static Result SetThreadPriority(pthread_t thread, pid_t threadID, ThreadPriority priority)
+	{
+		if (priority == ThreadPriority::TimeCritical)
+		{
+			sched_param parameters{ };
+			parameters.sched_priority = sched_get_priority_min(SCHED_FIFO);
+
+			int error = pthread_setschedparam(thread, SCHED_FIFO, &parameters);
+
+			if (error != 0)
+				return BLAZE_ERROR_RESULT("Blaze Engine", "pthread_setschedparam failed with error \"" + String(strerror(error)) + "\"");
+
+			return Result();
+		}
+
+		//Threads that were time critical go back to normal scheduling
+		sched_param parameters{ };
+		pthread_setschedparam(thread, SCHED_OTHER, &parameters);
+
+		//Under SCHED_OTHER only the nice value orders threads. On Linux it is per thread
+		int niceValue = 0;
+		switch (priority)
+		{
+		case ThreadPriority::Lowest: niceValue = 10; break;
+		case ThreadPriority::Low: niceValue = 5; break;
+		case ThreadPriority::High: niceValue = -5; break;
+		case ThreadPriority::Highest: niceValue = -10; break;
+		default: break;
+		}
+
+		if (setpriority(PRIO_PROCESS, (id_t)threadID, niceValue) == -1)
+			return BLAZE_ERROR_RESULT("Blaze Engine", "setpriority failed with error \"" + String(strerror(errno)) + "\"");
+
+		return Result();
+	}
+	static Result SetThreadName(pthread_t thread, StringView name)
+	{
+		//Names are limited to 16 bytes including the terminating zero
+		char buffer[16];
+		uintMem count = std::min<uintMem>(name.Count(), sizeof(buffer) - 1);
+		memcpy(buffer, name.Ptr(), count);
+		buffer[count] = '\0';
+
+		int error = pthread_setname_np(thread, buffer);
+
+		if (error != 0)
+			return BLAZE_ERROR_RESULT("Blaze Engine", "pthread_setname_np failed with error \"" + String(strerror(error)) + "\"");
+
+		return Result();
+	}
+
+	static void* ThreadProc(void* parameter)
+	{
+		ThreadData* data = (ThreadData*)parameter;
+
+		data->threadID.store((pid_t)syscall(SYS_gettid), std::memory_order_release);
+		data->threadID.notify_all();
+
+		//Failing to apply an option is reported but doesn't stop the thread
+		if (!data->options.name.Empty())
+			SetThreadName(pthread_self(), data->options.name);
+		if (data->options.priority != ThreadPriority::Normal)
+			SetThreadPriority(pthread_self(), data->threadID.load(std::memory_order_relaxed), data->options.priority);
+
+		data->function();
+		data->function = nullptr;
+
+		data->running.store(false, std::memory_order_release);
+		ReleaseThreadData(data);
+
+		return nullptr;
+	}
+#endif
+
 	Thread::Thread()
 		: handle(nullptr)
 	{
 	}
 	Thread::Thread(std::function<int()> func)
-	{		
+		: handle(nullptr)
+	{
 		Run(func);
 	}
 	Thread::Thread(Thread&& t) noexcept
@@ -42,67 +207,226 @@ namespace Blaze
 	}
 	Thread::~Thread()
 	{
+		if (handle == nullptr)
+			return;
+
 #ifdef BLAZE_PLATFORM_WINDOWS
-		if (handle != nullptr)
-			CloseHandle(handle);
+		CloseHandle(handle);
+#elif defined(BLAZE_PLATFORM_LINUX)
+		ReleaseThreadData((ThreadData*)handle);
 #endif
 	}
 
 	Result Thread::Run(std::function<int()> func)
 	{
-#ifdef BLAZE_PLATFORM_WINDOWS
-		if (IsRunning())		
+		return Run(std::move(func), ThreadCreateOptions());
+	}
+	Result Thread::Run(std::function<int()> func, const ThreadCreateOptions& options)
+	{
+		if (IsRunning())
 			return BLAZE_ERROR_RESULT("Blaze Engine", "Thread::Run called on a running thread");
 
+		//Releases the previous thread
+		*this = Thread();
+
+#ifdef BLAZE_PLATFORM_WINDOWS
 		std::function<int()>* ptr = new std::function<int()>(std::move(func));
 
-		handle = CreateThread(NULL, 0, std_ThreadProc, ptr, 0, NULL);
-#endif
+		//Started suspended so the options are applied before any of the function runs
+		handle = CreateThread(NULL, options.stackSize, ThreadProc, ptr, CREATE_SUSPENDED | (options.stackSize != 0 ? STACK_SIZE_PARAM_IS_A_RESERVATION : 0), NULL);
+
+		if (handle == NULL)
+		{
+			delete ptr;
+			return BLAZE_ERROR_RESULT("Windows API", "CreateThread failed with error \"" + Windows::GetErrorString(GetLastError()) + "\"");
+		}
+
+		Result result;
+
+		if (options.affinityMask != 0)
+			result += SetThreadAffinity(handle, options.affinityMask);
+		if (options.priority != ThreadPriority::Normal)
+			result += SetThreadPriority(handle, options.priority);
+		if (!options.name.Empty())
+			result += SetThreadName(handle, options.name);
+
+		ResumeThread(handle);
+
+		return result;
+#elif defined(BLAZE_PLATFORM_LINUX)
+		ThreadData* data = new ThreadData();
+		data->function = std::move(func);
+		data->name = String(options.name.Ptr(), options.name.Count());
+		data->options = options;
+		data->options.name = data->name;
+		data->threadID = 0;
+		data->running = true;
+		data->referenceCount = 2;
+		data->joined = false;
+
+		pthread_attr_t attributes;
+		pthread_attr_init(&attributes);
+
+		if (options.stackSize != 0)
+			pthread_attr_setstacksize(&attributes, std::max<uintMem>(options.stackSize, (uintMem)PTHREAD_STACK_MIN));
+
+		if (options.affinityMask != 0)
+		{
+			cpu_set_t set;
+			CPU_ZERO(&set);
+
+			for (uint i = 0; i < 64; ++i)
+				if (options.affinityMask & ((uint64)1 << i))
+					CPU_SET(i, &set);
+
+			pthread_attr_setaffinity_np(&attributes, sizeof(set), &set);
+		}
+
+		int error = pthread_create(&data->thread, &attributes, ThreadProc, data);
+		pthread_attr_destroy(&attributes);
+
+		if (error != 0)
+		{
+			delete data;
+			return BLAZE_ERROR_RESULT("Blaze Engine", "pthread_create failed with error \"" + String(strerror(error)) + "\"");
+		}
+
+		handle = data;
+
 		return Result();
+#endif
 	}
-
 	Result Thread::Run(int(*func)())
 	{
-#ifdef BLAZE_PLATFORM_WINDOWS
-		if (IsRunning())
-			return BLAZE_ERROR_RESULT("Blaze Engine", "Thread::Run called on a running thread");		
-
-		handle = CreateThread(NULL, 0, static_ThreadProc, func, 0, NULL);
-#endif
-		return Result();
+		return Run(std::function<int()>(func));
 	}
 
 	void Thread::WaitToFinish() const
 	{
-#ifdef BLAZE_PLATFORM_WINDOWS		
+		if (handle == nullptr)
+			return;
+
+#ifdef BLAZE_PLATFORM_WINDOWS
 		WaitForSingleObject(handle, INFINITE); // wait infinitely
+#elif defined(BLAZE_PLATFORM_LINUX)
+		ThreadData* data = (ThreadData*)handle;
+
+		std::lock_guard<std::mutex> lk{ data->joinMutex };
+
+		if (!data->joined)
+		{
+			pthread_join(data->thread, nullptr);
+			data->joined = true;
+		}
 #endif
 	}
 
 	bool Thread::IsRunning() const
 	{
-#ifdef BLAZE_PLATFORM_WINDOWS
-		if (handle == NULL)
+		if (handle == nullptr)
 			return false;
 
+#ifdef BLAZE_PLATFORM_WINDOWS
 		DWORD result = WaitForSingleObject(handle, 0);
 
 		if (result == WAIT_OBJECT_0)
-			return false;			
-		else if (result == WAIT_TIMEOUT) 		
-			return true;			
+			return false;
+		else if (result == WAIT_TIMEOUT)
+			return true;
 		else
 		{
 			Debug::Logger::LogError("WinAPI", "WaitForSingleObject failed with error \"" + Windows::GetErrorString(GetLastError()) + "\"");
 			return false;
 		}
+#elif defined(BLAZE_PLATFORM_LINUX)
+		return ((ThreadData*)handle)->running.load(std::memory_order_acquire);
 #endif
-	}	
+	}
+
+	Result Thread::SetAffinity(uint64 affinityMask)
+	{
+		if (!IsRunning())
+			return BLAZE_ERROR_RESULT("Blaze Engine", "Thread::SetAffinity called on a thread that isn't running");
+
+#ifdef BLAZE_PLATFORM_WINDOWS
+		return SetThreadAffinity(handle, affinityMask);
+#elif defined(BLAZE_PLATFORM_LINUX)
+		return SetThreadAffinity(((ThreadData*)handle)->thread, affinityMask);
+#endif
+	}
+	Result Thread::SetPriority(ThreadPriority priority)
+	{
+		if (!IsRunning())
+			return BLAZE_ERROR_RESULT("Blaze Engine", "Thread::SetPriority called on a thread that isn't running");
+
+#ifdef BLAZE_PLATFORM_WINDOWS
+		return SetThreadPriority(handle, priority);
+#elif defined(BLAZE_PLATFORM_LINUX)
+		ThreadData* data = (ThreadData*)handle;
+
+		//The thread might not have stored its ID yet
+		data->threadID.wait(0, std::memory_order_acquire);
+
+		return SetThreadPriority(data->thread, data->threadID.load(std::memory_order_acquire), priority);
+#endif
+	}
+	Result Thread::SetName(StringView name)
+	{
+		if (!IsRunning())
+			return BLAZE_ERROR_RESULT("Blaze Engine", "Thread::SetName called on a thread that isn't running");
+
+#ifdef BLAZE_PLATFORM_WINDOWS
+		return SetThreadName(handle, name);
+#elif defined(BLAZE_PLATFORM_LINUX)
+		return SetThreadName(((ThreadData*)handle)->thread, name);
+#endif
+	}
+
+	Result Thread::SetCurrentThreadAffinity(uint64 affinityMask)
+	{
+#ifdef BLAZE_PLATFORM_WINDOWS
+		return SetThreadAffinity(GetCurrentThread(), affinityMask);
+#elif defined(BLAZE_PLATFORM_LINUX)
+		return SetThreadAffinity(pthread_self(), affinityMask);
+#endif
+	}
+	Result Thread::SetCurrentThreadPriority(ThreadPriority priority)
+	{
+#ifdef BLAZE_PLATFORM_WINDOWS
+		return SetThreadPriority(GetCurrentThread(), priority);
+#elif defined(BLAZE_PLATFORM_LINUX)
+		return SetThreadPriority(pthread_self(), (pid_t)syscall(SYS_gettid), priority);
+#endif
+	}
+	Result Thread::SetCurrentThreadName(StringView name)
+	{
+#ifdef BLAZE_PLATFORM_WINDOWS
+		return SetThreadName(GetCurrentThread(), name);
+#elif defined(BLAZE_PLATFORM_LINUX)
+		return SetThreadName(pthread_self(), name);
+#endif
+	}
+	uint Thread::CurrentIndex()
+	{
+		static std::atomic<uint> threadCount = 0;
+		static thread_local uint index = threadCount.fetch_add(1, std::memory_order_relaxed);
+
+		return index;
+	}
 
 	Thread& Thread::operator=(Thread&& t) noexcept
-	{		
+	{
+		if (handle != nullptr)
+		{
+#ifdef BLAZE_PLATFORM_WINDOWS
+			CloseHandle(handle);
+#elif defined(BLAZE_PLATFORM_LINUX)
+			ReleaseThreadData((ThreadData*)handle);
+#endif
+		}
+
 		handle = t.handle;
 		t.handle = nullptr;
 		return *this;
 	}
-}
\ No newline at end of file
+}
@@ -32,15 +32,11 @@ namespace Blaze::Graphics::OpenGLWrapper
 
 	Result Shader::Load(const Path& path)
 	{
-		File file;
+		MappedFile file;
 
-		CHECK_RESULT(file.Open(path, FileAccessPermission::Read));
-		
-		String source;
-		source.Resize(file.GetSize());
-		size_t read = file.Read(source.Ptr(), source.Count());
+		CHECK_RESULT(file.Open(path, FileUsageHint::Sequential));
 
-		CHECK_RESULT(ShaderSource(source));
+		CHECK_RESULT(ShaderSource(StringView((const char*)file.GetData(), file.GetSize())));
 
 		CHECK_RESULT(CompileShader());
 
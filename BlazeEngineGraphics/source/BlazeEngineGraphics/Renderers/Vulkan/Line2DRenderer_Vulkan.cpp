@@ -7,18 +7,13 @@ namespace Blaze::Graphics::Vulkan
 	{
 		VkShaderModule shader;
 
-		File file{ path, FileAccessPermission::Read };
-
-		size_t fileSize = file.GetSize();
-		std::vector<char> buffer(fileSize);
-
-		file.Read(buffer.data(), fileSize);
-		file.Close();
+		//Mapped memory is page aligned so it satisfies the uint32 alignment of 'pCode'
+		MappedFile file{ path, FileUsageHint::Sequential };
 
 		VkShaderModuleCreateInfo createInfo{};
 		createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-		createInfo.codeSize = buffer.size();
-		createInfo.pCode = reinterpret_cast<const uint32_t*>(buffer.data());
+		createInfo.codeSize = file.GetSize();
+		createInfo.pCode = reinterpret_cast<const uint32_t*>(file.GetData());
 
 		if (vkCreateShaderModule(device, &createInfo, nullptr, (VkShaderModule*)&shader) != VK_SUCCESS)
 			Debug::Logger::LogError("BlazeEngine", "Failed to create shader module!");
@@ -0,0 +1,163 @@
+#include "pch.h"
+#include "BlazeEngine/Application/ECS/Scene.h"
+#include "BlazeEngine/Application/ECS/CommandBuffer.h"
+
+using namespace Blaze::ECS;
+
+namespace
+{
+	class Position : public Component
+	{
+	public:
+		float x = 0, y = 0;
+
+		COMPONENT(Position, ECS::System);
+	};
+	class Health : public Component
+	{
+	public:
+		uint32 value = 100;
+
+		COMPONENT(Health, ECS::System);
+	};
+}
+
+static uintMem CountEntitiesWith(Scene& scene, bool position, bool health)
+{
+	uintMem count = 0;
+
+	for (auto entity : scene.GetEntities())
+		if (entity->HasComponent<Position>() == position && entity->HasComponent<Health>() == health)
+			++count;
+
+	return count;
+}
+
+BLAZE_TEST(CommandBufferChangesNothingUntilApplied)
+{
+	Scene scene;
+	BLAZE_CHECK(!scene.SetRegistry(ComponentTypeRegistry::NewRegistry<Position, Health>()));
+
+	CommandBuffer& buffer = scene.GetCommandBuffer(0);
+	buffer.Create<Position>();
+	buffer.Create<Position, Health>();
+
+	BLAZE_CHECK(buffer.GetCommandCount() == 2 && buffer.GetCreateCount() == 2);
+	BLAZE_CHECK(scene.GetEntities().Count() == 0);
+
+	BLAZE_CHECK(!scene.ApplyCommandBuffers());
+	BLAZE_CHECK(buffer.Empty());
+	BLAZE_CHECK(CountEntitiesWith(scene, true, false) == 1);
+	BLAZE_CHECK(CountEntitiesWith(scene, true, true) == 1);
+}
+BLAZE_TEST(CommandBufferAppliesCommandsInRecordingOrder)
+{
+	Scene scene;
+	BLAZE_CHECK(!scene.SetRegistry(ComponentTypeRegistry::NewRegistry<Position, Health>()));
+
+	CommandBuffer& buffer = scene.GetCommandBuffer(0);
+
+	//Consecutive creations with the same types are applied as one batch, provisional handles still refer to each entity
+	EntityHandle a = buffer.Create<Position>();
+	EntityHandle b = buffer.Create<Position>();
+	EntityHandle c = buffer.Create<Position>();
+	BLAZE_CHECK(a.IsProvisional() && a != b && b != c);
+
+	buffer.AddComponent<Health>(a);
+	buffer.Destroy(b);
+	buffer.AddComponent<Health>(c);
+	buffer.RemoveComponent<Position>(c);
+
+	//A command after the destruction of its entity is skipped
+	buffer.AddComponent<Health>(b);
+
+	BLAZE_CHECK(!scene.ApplyCommandBuffers());
+	BLAZE_CHECK(scene.GetEntities().Count() == 2);
+	BLAZE_CHECK(CountEntitiesWith(scene, true, true) == 1);
+	BLAZE_CHECK(CountEntitiesWith(scene, false, true) == 1);
+}
+BLAZE_TEST(CommandBufferActsOnExistingEntities)
+{
+	Scene scene;
+	BLAZE_CHECK(!scene.SetRegistry(ComponentTypeRegistry::NewRegistry<Position, Health>()));
+
+	EntityHandle kept = scene.Create<Position>().GetEntity()->GetHandle();
+	EntityHandle destroyed = scene.Create<Position>().GetEntity()->GetHandle();
+
+	CommandBuffer& buffer = scene.GetCommandBuffer(0);
+	buffer.AddComponent<Health>(kept);
+	buffer.Destroy(destroyed);
+	buffer.Destroy(destroyed);
+
+	BLAZE_CHECK(!scene.ApplyCommandBuffers());
+	BLAZE_CHECK(!scene.IsValid(destroyed));
+	BLAZE_CHECK(scene.GetEntities().Count() == 1);
+	BLAZE_CHECK(scene.GetEntity(kept) != nullptr && scene.GetEntity(kept)->HasComponent<Health>());
+}
+BLAZE_TEST(CommandBufferAppliesBuffersInIndexOrder)
+{
+	Scene scene;
+	BLAZE_CHECK(!scene.SetRegistry(ComponentTypeRegistry::NewRegistry<Position, Health>()));
+	scene.SetCommandBufferCount(2);
+
+	EntityHandle entity = scene.Create<Position>().GetEntity()->GetHandle();
+
+	//Recorded first, but the buffer with the lower index is applied first and adds the component this one removes
+	scene.GetCommandBuffer(1).RemoveComponent<Health>(entity);
+	scene.GetCommandBuffer(0).AddComponent<Health>(entity);
+
+	BLAZE_CHECK(!scene.ApplyCommandBuffers());
+	BLAZE_CHECK(!scene.GetEntity(entity)->HasComponent<Health>());
+	BLAZE_CHECK(scene.GetCommandBuffer(0).Empty() && scene.GetCommandBuffer(1).Empty());
+}
+BLAZE_TEST(CommandBufferRejectsForeignProvisionalHandles)
+{
+	Scene scene;
+	BLAZE_CHECK(!scene.SetRegistry(ComponentTypeRegistry::NewRegistry<Position, Health>()));
+	scene.SetCommandBufferCount(2);
+
+	CommandBuffer& first = scene.GetCommandBuffer(0);
+	CommandBuffer& second = scene.GetCommandBuffer(1);
+
+	EntityHandle created = first.Create<Position>();
+	//Same index and a different stamp, it must not act on the entity the other buffer creates
+	second.Create<Position>();
+	second.AddComponent<Health>(created);
+
+	Result result = scene.ApplyCommandBuffers();
+	BLAZE_CHECK(result);
+	result.ClearSilent();
+
+	BLAZE_CHECK(CountEntitiesWith(scene, true, false) == 2);
+
+	//Handles of an earlier recording of the same buffer are rejected too
+	first.AddComponent<Health>(created);
+
+	result = scene.ApplyCommandBuffers();
+	BLAZE_CHECK(result);
+	result.ClearSilent();
+
+	BLAZE_CHECK(CountEntitiesWith(scene, true, true) == 0);
+}
+BLAZE_TEST(SceneRegistryCantChangeWithEntities)
+{
+	Scene scene;
+	BLAZE_CHECK(!scene.SetRegistry(ComponentTypeRegistry::NewRegistry<Position>()));
+
+	Entity* entity = scene.Create<Position>().GetEntity();
+
+	Result result = scene.SetRegistry(ComponentTypeRegistry::NewRegistry<Position, Health>());
+	BLAZE_CHECK(result);
+	result.ClearSilent();
+
+	//Once the scene is empty the slot metadata is laid out for the new type count
+	BLAZE_CHECK(!scene.Destroy(entity));
+	BLAZE_CHECK(!scene.SetRegistry(ComponentTypeRegistry::NewRegistry<Position, Health>()));
+
+	CommandBuffer& buffer = scene.GetCommandBuffer(0);
+	for (uint32 i = 0; i < 100; ++i)
+		buffer.Create<Position, Health>();
+
+	BLAZE_CHECK(!scene.ApplyCommandBuffers());
+	BLAZE_CHECK(CountEntitiesWith(scene, true, true) == 100);
+}
@@ -0,0 +1,177 @@
+#include "pch.h"
+#include "BlazeEngine/Event/EventDispatcher.h"
+#include "BlazeEngine/Event/LambdaEventHandler.h"
+#include "BlazeEngine/Internal/ThreadEventStack.h"
+#include <thread>
+
+namespace
+{
+	struct TestEvent
+	{
+		uint32 value;
+	};
+
+	//Counts live copies, so events destroyed without being dispatched can be checked
+	struct TrackedEvent
+	{
+		static inline std::atomic<int> liveCount = 0;
+
+		uint32 value;
+
+		TrackedEvent(uint32 value) : value(value) { ++liveCount; }
+		TrackedEvent(const TrackedEvent& other) : value(other.value) { ++liveCount; }
+		~TrackedEvent() { --liveCount; }
+		TrackedEvent& operator=(const TrackedEvent& other) { value = other.value; return *this; }
+	};
+
+	//Every record of a TestEvent with one dispatcher takes 32 bytes, so this ring holds 8 of them
+	using SmallEventStack = EventStack<256>;
+	constexpr uint32 SmallEventStackRecordCount = 8;
+}
+
+BLAZE_TEST(EventStackDispatchesInOrder)
+{
+	EventDispatcher<TestEvent> dispatcher;
+	Array<uint32> received;
+	LambdaEventHandler<TestEvent> handler{ [&](TestEvent event) { received.AddBack(event.value); } };
+	dispatcher.AddHandler(handler);
+
+	SmallEventStack stack;
+
+	//Goes around the ring many times, records that don't fit at its end are placed after padding
+	for (uint32 i = 0; i < 100; ++i)
+	{
+		BLAZE_CHECK(stack.Add(TestEvent{ i }, &dispatcher));
+
+		if (i % 3 == 2)
+			stack.ProcessAndClear();
+	}
+	stack.ProcessAndClear();
+
+	BLAZE_CHECK(received.Count() == 100);
+	for (uint32 i = 0; i < 100; ++i)
+		BLAZE_CHECK(received[i] == i);
+}
+BLAZE_TEST(EventStackTryAddDropsWhenFull)
+{
+	EventDispatcher<TestEvent> dispatcher;
+	Array<uint32> received;
+	LambdaEventHandler<TestEvent> handler{ [&](TestEvent event) { received.AddBack(event.value); } };
+	dispatcher.AddHandler(handler);
+
+	SmallEventStack stack;
+
+	for (uint32 i = 0; i < SmallEventStackRecordCount; ++i)
+		BLAZE_CHECK(stack.TryAdd(TestEvent{ i }, &dispatcher));
+
+	BLAZE_CHECK(!stack.TryAdd(TestEvent{ 100 }, &dispatcher));
+	BLAZE_CHECK(!stack.TryAdd(TestEvent{ 101 }, &dispatcher));
+	BLAZE_CHECK(stack.GetDroppedEventCount() == 2);
+
+	//The dropped events are gone, the ones before them are all delivered and the space can be used again
+	stack.ProcessAndClear();
+	BLAZE_CHECK(received.Count() == SmallEventStackRecordCount && received.Last() == SmallEventStackRecordCount - 1);
+
+	BLAZE_CHECK(stack.TryAdd(TestEvent{ 200 }, &dispatcher));
+	stack.ProcessAndClear();
+	BLAZE_CHECK(received.Count() == SmallEventStackRecordCount + 1 && received.Last() == 200);
+}
+BLAZE_TEST(EventStackAddWaitsForSpaceWhenFull)
+{
+	EventDispatcher<TestEvent> dispatcher;
+	Array<uint32> received;
+	LambdaEventHandler<TestEvent> handler{ [&](TestEvent event) { received.AddBack(event.value); } };
+	dispatcher.AddHandler(handler);
+
+	SmallEventStack stack;
+
+	for (uint32 i = 0; i < SmallEventStackRecordCount; ++i)
+		BLAZE_CHECK(stack.Add(TestEvent{ i }, &dispatcher));
+
+	//The processing thread frees space well within the wait limit, so the event isn't dropped
+	std::atomic<bool> processingStarted = false;
+	std::thread processingThread{ [&]() {
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+		processingStarted = true;
+		stack.ProcessAndClear();
+		} };
+
+	bool added = stack.Add(TestEvent{ 100 }, &dispatcher);
+	bool addedAfterProcessingStarted = processingStarted;
+	processingThread.join();
+
+	BLAZE_CHECK(added && addedAfterProcessingStarted);
+	BLAZE_CHECK(stack.GetDroppedEventCount() == 0);
+
+	stack.ProcessAndClear();
+	BLAZE_CHECK(received.Count() == SmallEventStackRecordCount + 1 && received.Last() == 100);
+}
+BLAZE_TEST(EventStackHandlerAddingToFullRingDoesntWait)
+{
+	EventDispatcher<TestEvent> dispatcher;
+	SmallEventStack stack;
+	uint32 handledCount = 0;
+	bool addedFromHandler = true;
+
+	//Space is only freed after a record is dispatched, so the first handler runs while the ring is still full
+	LambdaEventHandler<TestEvent> handler{ [&](TestEvent event) {
+		if (handledCount++ == 0)
+			addedFromHandler = stack.Add(TestEvent{ 100 }, &dispatcher);
+		} };
+	dispatcher.AddHandler(handler);
+
+	for (uint32 i = 0; i < SmallEventStackRecordCount; ++i)
+		BLAZE_CHECK(stack.Add(TestEvent{ i }, &dispatcher));
+
+	auto start = std::chrono::steady_clock::now();
+	stack.ProcessAndClear();
+
+	//Waiting would end only after the wait limit, since nothing else processes the ring
+	BLAZE_CHECK(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(500));
+	BLAZE_CHECK(!addedFromHandler);
+	BLAZE_CHECK(handledCount == SmallEventStackRecordCount);
+	BLAZE_CHECK(stack.GetDroppedEventCount() == 1);
+}
+BLAZE_TEST(EventStackAddOrReplaceKeepsOnlyTheLastEvent)
+{
+	EventDispatcher<TestEvent> dispatcher;
+	Array<uint32> received;
+	LambdaEventHandler<TestEvent> handler{ [&](TestEvent event) { received.AddBack(event.value); } };
+	dispatcher.AddHandler(handler);
+
+	SmallEventStack stack;
+	uint64 record = ~(uint64)0;
+
+	BLAZE_CHECK(stack.AddOrReplace(record, TestEvent{ 1 }, &dispatcher));
+	BLAZE_CHECK(stack.AddOrReplace(record, TestEvent{ 2 }, &dispatcher));
+	BLAZE_CHECK(stack.AddOrReplace(record, TestEvent{ 3 }, &dispatcher));
+	stack.ProcessAndClear();
+
+	//An event added after it stops it from being replaced, the order is kept
+	BLAZE_CHECK(stack.AddOrReplace(record, TestEvent{ 4 }, &dispatcher));
+	BLAZE_CHECK(stack.Add(TestEvent{ 5 }, &dispatcher));
+	BLAZE_CHECK(stack.AddOrReplace(record, TestEvent{ 6 }, &dispatcher));
+	stack.ProcessAndClear();
+
+	BLAZE_CHECK(received.Count() == 4);
+	BLAZE_CHECK(received[0] == 3 && received[1] == 4 && received[2] == 5 && received[3] == 6);
+}
+BLAZE_TEST(EventStackDestroysEventsLeftInTheRing)
+{
+	EventDispatcher<TrackedEvent> dispatcher;
+	uint32 handledCount = 0;
+	LambdaEventHandler<TrackedEvent> handler{ [&](TrackedEvent event) { ++handledCount; } };
+	dispatcher.AddHandler(handler);
+
+	{
+		SmallEventStack stack;
+
+		for (uint32 i = 0; i < 4; ++i)
+			BLAZE_CHECK(stack.Add(TrackedEvent{ i }, &dispatcher));
+
+		BLAZE_CHECK(TrackedEvent::liveCount == 4);
+	}
+
+	BLAZE_CHECK(TrackedEvent::liveCount == 0);
+	BLAZE_CHECK(handledCount == 0);
+}
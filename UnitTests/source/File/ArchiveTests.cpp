@@ -0,0 +1,269 @@
+#include "pch.h"
+#include "BlazeEngineCore/File/Archive.h"
+
+namespace
+{
+	struct Vertex
+	{
+		float x, y, z;
+		uint32 color;
+	};
+
+	struct Item
+	{
+		String name;
+		uint32 count = 0;
+
+		void Serialize(WriteArchive& archive) const
+		{
+			archive.BeginSection(1);
+			archive << name << count;
+			archive.EndSection();
+		}
+		void Deserialize(ReadArchive& archive)
+		{
+			archive.BeginSection();
+			archive >> name >> count;
+			archive.EndSection();
+		}
+	};
+
+	/*
+		Read stream without contiguous memory, makes the archive go through its buffered stream path
+	*/
+	class PlainReadStream : public ReadStream
+	{
+	public:
+		PlainReadStream(const void* data, uintMem size)
+			: data((const byte*)data), size(size), position(0)
+		{
+		}
+
+		bool MovePosition(intMem offset) override { return SetPosition(position + offset); }
+		bool SetPosition(uintMem offset) override
+		{
+			if (offset > size)
+				return false;
+
+			position = offset;
+			return true;
+		}
+		bool SetPositionFromEnd(intMem offset) override { return SetPosition(size + offset); }
+		uintMem GetPosition() const override { return position; }
+		uintMem GetSize() const override { return size; }
+
+		uintMem Read(void* ptr, uintMem byteCount) override
+		{
+			byteCount = std::min(byteCount, size - position);
+			memcpy(ptr, data + position, byteCount);
+			position += byteCount;
+			return byteCount;
+		}
+	private:
+		const byte* data;
+		uintMem size;
+		uintMem position;
+	};
+}
+
+//Copies the written archive into 16 byte aligned memory, 'offset' bytes after the aligned start
+static Array<uint64> CopyArchive(const BufferWriteStream& stream, uintMem offset)
+{
+	Array<uint64> memory;
+	memory.Resize((stream.GetPosition() + offset) / sizeof(uint64) + 2, 0);
+	memcpy((byte*)memory.Ptr() + offset, stream.GetBuffer(), stream.GetPosition());
+	return memory;
+}
+
+static void WriteTestArchive(BufferWriteStream& stream)
+{
+	WriteArchive archive{ stream };
+
+	Array<Vertex> vertices;
+	for (uint32 i = 0; i < 100; ++i)
+		vertices.AddBack(Vertex{ (float)i, (float)i * 2, (float)i * 3, i });
+
+	Array<Item> items;
+	items.AddBack(Item{ "sword", 1 });
+	items.AddBack(Item{ "arrow", 64 });
+
+	//The single byte leaves the arrays after it misaligned unless they are padded
+	archive << (uint8)7 << String("archive") << vertices << (uint8)9 << Array<uint64>({ 1, 2, 3 }) << items << StringUTF8("utf8");
+
+	archive.Flush();
+	BLAZE_CHECK(!archive.Failed());
+}
+static bool ReadTestArchive(ReadArchive& archive)
+{
+	uint8 first = 0;
+	String name;
+	Array<Vertex> vertices;
+	uint8 second = 0;
+	Array<uint64> values;
+	Array<Item> items;
+	StringUTF8 text;
+
+	archive >> first >> name >> vertices >> second >> values >> items >> text;
+
+	if (archive.Failed() || first != 7 || second != 9 || name != "archive" || text != "utf8")
+		return false;
+
+	if (vertices.Count() != 100 || vertices[99].z != 297.0f || vertices[99].color != 99)
+		return false;
+
+	if (values.Count() != 3 || values[0] != 1 || values[2] != 3)
+		return false;
+
+	return items.Count() == 2 && items[1].name == "arrow" && items[1].count == 64;
+}
+
+BLAZE_TEST(ArchiveRoundTripsFromMemoryAndStream)
+{
+	BufferWriteStream stream;
+	WriteTestArchive(stream);
+
+	Array<uint64> memory = CopyArchive(stream, 0);
+
+	ReadArchive memoryArchive{ memory.Ptr(), stream.GetPosition() };
+	BLAZE_CHECK(memoryArchive.IsReadingFromMemory());
+	BLAZE_CHECK(ReadTestArchive(memoryArchive));
+
+	PlainReadStream plainStream{ memory.Ptr(), stream.GetPosition() };
+	ReadArchive streamArchive{ plainStream };
+	BLAZE_CHECK(!streamArchive.IsReadingFromMemory());
+	BLAZE_CHECK(ReadTestArchive(streamArchive));
+}
+BLAZE_TEST(ArchiveViewsPaddedArraysInPlace)
+{
+	BufferWriteStream stream;
+	{
+		WriteArchive archive{ stream };
+		archive << (uint8)1 << Array<uint64>({ 10, 20, 30 }) << (uint16)2 << Array<Vertex>({ Vertex{ 1, 2, 3, 4 } });
+		archive.Flush();
+	}
+
+	Array<uint64> memory = CopyArchive(stream, 0);
+	ReadArchive archive{ memory.Ptr(), stream.GetPosition() };
+
+	uint8 first = 0;
+	ArrayView<uint64> values;
+	uint16 second = 0;
+	ArrayView<Vertex> vertices;
+	archive >> first >> values >> second >> vertices;
+
+	BLAZE_CHECK(!archive.Failed());
+	BLAZE_CHECK(first == 1 && second == 2);
+	BLAZE_CHECK(values.Count() == 3 && values[2] == 30);
+	BLAZE_CHECK((uintMem)values.Ptr() % alignof(uint64) == 0);
+	//The view points into the archive memory
+	BLAZE_CHECK((const byte*)values.Ptr() > (const byte*)memory.Ptr() && (const byte*)values.Ptr() < (const byte*)memory.Ptr() + stream.GetPosition());
+	BLAZE_CHECK(vertices.Count() == 1 && vertices[0].color == 4);
+}
+BLAZE_TEST(ArchiveCopiesWhenMemoryIsMisaligned)
+{
+	BufferWriteStream stream;
+	{
+		WriteArchive archive{ stream };
+		archive << Array<uint64>({ 5, 6 });
+		archive.Flush();
+	}
+
+	Array<uint64> memory = CopyArchive(stream, 1);
+
+	//Arrays are aligned relative to the archive start, copying reads don't depend on where the archive is
+	{
+		ReadArchive archive{ (const byte*)memory.Ptr() + 1, stream.GetPosition() };
+		Array<uint64> values;
+		archive >> values;
+		BLAZE_CHECK(!archive.Failed() && values.Count() == 2 && values[1] == 6);
+	}
+	//Views can't point to misaligned elements
+	{
+		ReadArchive archive{ (const byte*)memory.Ptr() + 1, stream.GetPosition() };
+		ArrayView<uint64> values;
+		archive >> values;
+		BLAZE_CHECK(archive.Failed() && values.Count() == 0);
+	}
+}
+BLAZE_TEST(ArchiveSectionsSkipUnknownFields)
+{
+	BufferWriteStream stream;
+	{
+		WriteArchive archive{ stream };
+		//A newer writer added a field and a nested section at the end of its section
+		archive.BeginSection(2);
+		archive << (uint32)1 << String("old field");
+		archive << Array<uint32>({ 1, 2, 3 });
+		archive.BeginSection(1);
+		archive << (uint64)5;
+		archive.EndSection();
+		archive.EndSection();
+		archive << (uint32)0xABCD;
+		archive.Flush();
+		BLAZE_CHECK(!archive.Failed());
+	}
+
+	Array<uint64> memory = CopyArchive(stream, 0);
+	ReadArchive archive{ memory.Ptr(), stream.GetPosition() };
+
+	uint32 version = archive.BeginSection();
+	uint32 value = 0;
+	String field;
+	archive >> value >> field;
+	archive.EndSection();
+
+	uint32 after = 0;
+	archive >> after;
+
+	BLAZE_CHECK(version == 2);
+	BLAZE_CHECK(!archive.Failed());
+	BLAZE_CHECK(value == 1 && field == "old field" && after == 0xABCD);
+}
+BLAZE_TEST(ArchiveFailsOnCorruptedData)
+{
+	//A count far larger than the data fails before anything is allocated
+	{
+		BufferWriteStream stream;
+		{
+			WriteArchive archive{ stream };
+			archive << (uint64)1 << (uint64)0x0FFFFFFFFFFFFFFF;
+			archive.Flush();
+		}
+
+		ReadArchive archive{ stream.GetBuffer(), stream.GetPosition() };
+		uint64 first = 0;
+		Array<uint32> values;
+		archive >> first >> values;
+
+		BLAZE_CHECK(archive.Failed() && first == 1 && values.Empty());
+	}
+	//Truncated data fails and later reads leave values unchanged
+	{
+		BufferWriteStream stream;
+		{
+			WriteArchive archive{ stream };
+			archive << String("truncated string") << (uint32)1;
+			archive.Flush();
+		}
+
+		ReadArchive archive{ stream.GetBuffer(), stream.GetPosition() - 8 };
+		String text;
+		uint32 value = 77;
+		archive >> text >> value;
+
+		BLAZE_CHECK(archive.Failed() && value == 77);
+	}
+	//A section size past the end of the data
+	{
+		BufferWriteStream stream;
+		{
+			WriteArchive archive{ stream };
+			archive << (uint32)1 << (uint64)1000;
+			archive.Flush();
+		}
+
+		ReadArchive archive{ stream.GetBuffer(), stream.GetPosition() };
+		archive.BeginSection();
+		BLAZE_CHECK(archive.Failed());
+	}
+}
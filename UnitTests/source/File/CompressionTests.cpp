@@ -0,0 +1,190 @@
+#include "pch.h"
+#include "BlazeEngineCore/File/Compression.h"
+
+//Deterministic so failures can be reproduced
+static Array<byte> MakeRandomData(uintMem size, uint32 seed)
+{
+	Array<byte> data;
+	data.Resize(size);
+
+	uint32 state = seed;
+	for (uintMem i = 0; i < size; ++i)
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		data[i] = (byte)state;
+	}
+
+	return data;
+}
+//Words from a small vocabulary, compresses well but not trivially
+static Array<byte> MakeTextData(uintMem size)
+{
+	static const char* words[] = { "entity ", "component ", "system ", "scene ", "transform ", "render ", "window ", "event " };
+
+	Array<byte> data;
+	data.Resize(size);
+
+	uint32 state = 12345;
+	uintMem i = 0;
+	while (i < size)
+	{
+		state = state * 1664525 + 1013904223;
+		const char* word = words[(state >> 16) % std::size(words)];
+
+		for (uintMem j = 0; word[j] != '\0' && i < size; ++j, ++i)
+			data[i] = (byte)word[j];
+	}
+
+	return data;
+}
+static bool RoundTrip(const Array<byte>& data, CompressionLevel level, uintMem* compressedSize = nullptr)
+{
+	Array<byte> compressed;
+	compressed.Resize(BlazeLZ::CompressBound(data.Count()));
+
+	uintMem size = BlazeLZ::Compress(data.Ptr(), data.Count(), compressed.Ptr(), compressed.Count(), level);
+
+	if (size == 0 && data.Count() != 0)
+		return false;
+
+	if (compressedSize != nullptr)
+		*compressedSize = size;
+
+	Array<byte> decompressed;
+	decompressed.Resize(data.Count());
+
+	if (!BlazeLZ::Decompress(compressed.Ptr(), size, decompressed.Ptr(), decompressed.Count()))
+		return false;
+
+	return data.Count() == 0 || memcmp(data.Ptr(), decompressed.Ptr(), data.Count()) == 0;
+}
+static bool Decompresses(std::initializer_list<byte> block, uintMem dstSize)
+{
+	Array<byte> src{ block };
+	Array<byte> dst;
+	dst.Resize(dstSize);
+
+	return BlazeLZ::Decompress(src.Ptr(), src.Count(), dst.Ptr(), dst.Count());
+}
+
+BLAZE_TEST(BlazeLZRoundTripsSmallInputs)
+{
+	//Sizes around the minimum match and the literal tail limits
+	for (uintMem size = 0; size < 40; ++size)
+	{
+		BLAZE_CHECK(RoundTrip(MakeRandomData(size, 1 + (uint32)size), CompressionLevel::Fast));
+		BLAZE_CHECK(RoundTrip(MakeRandomData(size, 1 + (uint32)size), CompressionLevel::High));
+
+		Array<byte> zeros;
+		zeros.Resize(size, 0);
+		BLAZE_CHECK(RoundTrip(zeros, CompressionLevel::Fast));
+		BLAZE_CHECK(RoundTrip(zeros, CompressionLevel::High));
+	}
+}
+BLAZE_TEST(BlazeLZRoundTripsLargeInputs)
+{
+	for (CompressionLevel level : { CompressionLevel::Fast, CompressionLevel::High })
+	{
+		uintMem compressedSize;
+
+		//Longer than the largest match offset, so matches have to be found within the window
+		BLAZE_CHECK(RoundTrip(MakeTextData(300000), level, &compressedSize));
+		BLAZE_CHECK(compressedSize < 300000 / 2);
+
+		Array<byte> zeros;
+		zeros.Resize(1 << 20, 0);
+		BLAZE_CHECK(RoundTrip(zeros, level, &compressedSize));
+		BLAZE_CHECK(compressedSize < 8192);
+
+		//Incompressible data has to fit into the bound
+		BLAZE_CHECK(RoundTrip(MakeRandomData(100000, 7), level, &compressedSize));
+		BLAZE_CHECK(compressedSize <= BlazeLZ::CompressBound(100000));
+	}
+}
+BLAZE_TEST(BlazeLZHighIsNotLargerThanFast)
+{
+	Array<byte> data = MakeTextData(200000);
+	uintMem fastSize;
+	uintMem highSize;
+
+	BLAZE_CHECK(RoundTrip(data, CompressionLevel::Fast, &fastSize));
+	BLAZE_CHECK(RoundTrip(data, CompressionLevel::High, &highSize));
+	BLAZE_CHECK(highSize <= fastSize);
+}
+BLAZE_TEST(BlazeLZCompressFailsWhenOutputDoesNotFit)
+{
+	Array<byte> data = MakeRandomData(4096, 3);
+	Array<byte> compressed;
+	compressed.Resize(data.Count() / 2);
+
+	BLAZE_CHECK(BlazeLZ::Compress(data.Ptr(), data.Count(), compressed.Ptr(), compressed.Count(), CompressionLevel::Fast) == 0);
+	BLAZE_CHECK(BlazeLZ::Compress(data.Ptr(), data.Count(), compressed.Ptr(), compressed.Count(), CompressionLevel::High) == 0);
+}
+BLAZE_TEST(BlazeLZDecompressRejectsWrongSize)
+{
+	Array<byte> data = MakeTextData(10000);
+	Array<byte> compressed;
+	compressed.Resize(BlazeLZ::CompressBound(data.Count()));
+	uintMem size = BlazeLZ::Compress(data.Ptr(), data.Count(), compressed.Ptr(), compressed.Count());
+	BLAZE_CHECK(size != 0);
+
+	Array<byte> decompressed;
+	decompressed.Resize(data.Count() + 1);
+
+	BLAZE_CHECK(!BlazeLZ::Decompress(compressed.Ptr(), size, decompressed.Ptr(), data.Count() - 1));
+	BLAZE_CHECK(!BlazeLZ::Decompress(compressed.Ptr(), size, decompressed.Ptr(), data.Count() + 1));
+	BLAZE_CHECK(BlazeLZ::Decompress(compressed.Ptr(), size, decompressed.Ptr(), data.Count()));
+}
+BLAZE_TEST(BlazeLZDecompressRejectsMalformedBlocks)
+{
+	//One literal followed by a match of 4 bytes at offset 1
+	BLAZE_CHECK(Decompresses({ 0x10, 'a', 1, 0 }, 5));
+	//Offset 0
+	BLAZE_CHECK(!Decompresses({ 0x10, 'a', 0, 0 }, 5));
+	//Offset before the start of the output
+	BLAZE_CHECK(!Decompresses({ 0x10, 'a', 2, 0 }, 5));
+	//Match longer than the output
+	BLAZE_CHECK(!Decompresses({ 0x10, 'a', 1, 0 }, 4));
+	//More literals than there are bytes in the block
+	BLAZE_CHECK(!Decompresses({ 0x30, 'a', 'b' }, 3));
+	//Literal length extension cut off
+	BLAZE_CHECK(!Decompresses({ 0xF0 }, 15));
+	BLAZE_CHECK(!Decompresses({ 0xF0, 255 }, 300));
+	//Offset cut off
+	BLAZE_CHECK(!Decompresses({ 0x10, 'a', 1 }, 5));
+	//Match length extension cut off
+	BLAZE_CHECK(!Decompresses({ 0x1F, 'a', 1, 0 }, 100));
+}
+BLAZE_TEST(BlazeLZDecompressSurvivesCorruptedData)
+{
+	Array<byte> data = MakeTextData(20000);
+	Array<byte> compressed;
+	compressed.Resize(BlazeLZ::CompressBound(data.Count()));
+	uintMem size = BlazeLZ::Compress(data.Ptr(), data.Count(), compressed.Ptr(), compressed.Count());
+	BLAZE_CHECK(size != 0);
+
+	Array<byte> decompressed;
+	decompressed.Resize(data.Count());
+
+	//Any result is fine as long as nothing outside of the buffers is touched, which the debug heap and sanitizers catch
+	Array<byte> corrupted;
+	for (uint32 i = 0; i < 200; ++i)
+	{
+		corrupted = compressed;
+		Array<byte> noise = MakeRandomData(8, i + 100);
+		uintMem position = (noise[0] | ((uintMem)noise[1] << 8) | ((uintMem)noise[2] << 16)) % size;
+		corrupted[position] ^= noise[3] | 1;
+
+		BlazeLZ::Decompress(corrupted.Ptr(), size, decompressed.Ptr(), decompressed.Count());
+		//Truncated blocks too
+		BlazeLZ::Decompress(compressed.Ptr(), position, decompressed.Ptr(), decompressed.Count());
+	}
+
+	for (uint32 i = 0; i < 200; ++i)
+	{
+		Array<byte> garbage = MakeRandomData(64 + i, i + 1000);
+		BlazeLZ::Decompress(garbage.Ptr(), garbage.Count(), decompressed.Ptr(), decompressed.Count());
+	}
+}
@@ -0,0 +1,52 @@
+#include "pch.h"
+#include "UnitTest.h"
+
+namespace Blaze::UnitTests
+{
+	//Constant initialized, so they are set before any registration runs
+	static TestRegistration* firstTest = nullptr;
+	static TestRegistration** lastTestNext = &firstTest;
+	static bool currentTestFailed = false;
+
+	TestRegistration::TestRegistration(const char* name, const char* file, TestFunction function)
+		: name(name), file(file), function(function), next(nullptr)
+	{
+		//Appended so tests of a file run in the order they are written
+		*lastTestNext = this;
+		lastTestNext = &next;
+	}
+	void ReportFailure(const char* file, int line, const char* expression)
+	{
+		std::printf("    %s(%d): check failed: %s\n", file, line, expression);
+		currentTestFailed = true;
+	}
+	uintMem RunTests(StringView filter)
+	{
+		uintMem runCount = 0;
+		uintMem failedCount = 0;
+
+		for (TestRegistration* test = firstTest; test != nullptr; test = test->next)
+		{
+			if (!filter.Empty() && std::string_view(test->name).find(std::string_view(filter.Ptr(), filter.Count())) == std::string_view::npos)
+				continue;
+
+			std::printf("[ RUN  ] %s\n", test->name);
+
+			currentTestFailed = false;
+			test->function();
+			++runCount;
+
+			if (currentTestFailed)
+			{
+				std::printf("[ FAIL ] %s\n", test->name);
+				++failedCount;
+			}
+			else
+				std::printf("[  OK  ] %s\n", test->name);
+		}
+
+		std::printf("%zu tests run, %zu failed\n", (size_t)runCount, (size_t)failedCount);
+
+		return failedCount;
+	}
+}
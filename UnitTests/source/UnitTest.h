@@ -0,0 +1,39 @@
+#pragma once
+
+namespace Blaze::UnitTests
+{
+	using TestFunction = void(*)();
+
+	/*
+		Adds a test to the ones RunTests calls. Created by BLAZE_TEST as a static object, so the list doesn't allocate
+		and doesn't depend on the initialization order of the test files
+	*/
+	struct TestRegistration
+	{
+		const char* name;
+		const char* file;
+		TestFunction function;
+		TestRegistration* next;
+
+		TestRegistration(const char* name, const char* file, TestFunction function);
+	};
+
+	/*
+		Marks the running test as failed, called by BLAZE_CHECK
+	*/
+	void ReportFailure(const char* file, int line, const char* expression);
+	/*
+		Runs every registered test whose name contains 'filter', or all of them if 'filter' is empty. Returns the
+		number of tests that failed
+	*/
+	uintMem RunTests(StringView filter);
+}
+
+#define BLAZE_TEST(name) \
+	static void name(); \
+	static ::Blaze::UnitTests::TestRegistration name##Registration{ #name, __FILE__, name }; \
+	static void name()
+
+//Ends the running test on the first failed check, later checks would usually only report the same problem again
+#define BLAZE_CHECK(expression) \
+	do { if (!(expression)) { ::Blaze::UnitTests::ReportFailure(__FILE__, __LINE__, #expression); return; } } while (false)
@@ -0,0 +1,16 @@
+#include "pch.h"
+#include "UnitTest.h"
+
+/*
+	Runs the unit tests and returns 1 if any of them failed. The first argument, if given, only runs the tests whose
+	name contains it
+*/
+int main(int argc, char* argv[])
+{
+	StringView filter;
+
+	if (argc > 1)
+		filter = StringView(argv[1], strlen(argv[1]));
+
+	return UnitTests::RunTests(filter) == 0 ? 0 : 1;
+}
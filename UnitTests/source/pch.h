@@ -0,0 +1,11 @@
+#pragma once
+#include <cstdio>
+#include <mutex>
+#include <cstring>
+#include <string_view>
+
+#include "BlazeEngineCore/BlazeEngineCore.h"
+#include "BlazeEngine/BlazeEngineDefines.h"
+using namespace Blaze;
+
+#include "UnitTest.h"